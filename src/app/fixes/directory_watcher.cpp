@@ -0,0 +1,76 @@
+#include "directory_watcher.h"
+#include "core/log/logger.h"
+#include <format>
+
+namespace hdrfixer::fixes {
+
+DirectoryWatcher::DirectoryWatcher(Reactor& reactor, std::filesystem::path directory, Callback on_change)
+    : reactor_(reactor)
+    , directory_(std::move(directory))
+    , on_change_(std::move(on_change))
+{
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+    stop();
+}
+
+bool DirectoryWatcher::start()
+{
+    if (handle_ != INVALID_HANDLE_VALUE) {
+        return true;
+    }
+
+    std::string name = ObservedResource::file(directory_.wstring()).key;
+    handle_ = ::FindFirstChangeNotificationW(
+        directory_.wstring().c_str(),
+        FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (handle_ == INVALID_HANDLE_VALUE) {
+        LOG_WARN(std::format("DirectoryWatcher: not watching {} (FindFirstChangeNotificationW failed: {})",
+            name, ::GetLastError()));
+        return false;
+    }
+
+    auto id = reactor_.add_handle(handle_, [this] { on_signaled(); });
+    if (!id) {
+        LOG_ERROR(std::format("DirectoryWatcher: not watching {} ({})", name, id.error()));
+        ::FindCloseChangeNotification(handle_);
+        handle_ = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    id_ = *id;
+    LOG_INFO(std::format("DirectoryWatcher: watching {}", name));
+    return true;
+}
+
+void DirectoryWatcher::stop()
+{
+    if (handle_ == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    // On the reactor thread, so the handler never sees a closed handle
+    reactor_.call([this] {
+        reactor_.remove(id_);
+        ::FindCloseChangeNotification(handle_);
+    });
+    id_ = 0;
+    handle_ = INVALID_HANDLE_VALUE;
+}
+
+void DirectoryWatcher::on_signaled()
+{
+    // Re-arm before reporting, so a change made while the callback runs
+    // signals again
+    if (!::FindNextChangeNotification(handle_)) {
+        LOG_ERROR(std::format("DirectoryWatcher: no longer watching {}",
+            ObservedResource::file(directory_.wstring()).key));
+        reactor_.remove(id_);
+    }
+    if (on_change_) {
+        on_change_(ObservedResource::file(directory_.wstring()));
+    }
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,44 @@
+#pragma once
+#include <windows.h>
+#include <filesystem>
+#include <functional>
+#include "core/fixes/observed_resource.h"
+#include "core/fixes/reactor.h"
+
+namespace hdrfixer::fixes {
+
+/// Watches one directory for files being created, deleted, renamed or
+/// rewritten, as a handle on a shared Reactor.  Change notifications do not
+/// say which file changed, so the callback gets the directory itself as a
+/// change event, which FixEngine::notify_changed() matches against every
+/// file below it.
+class DirectoryWatcher {
+public:
+    /// Runs on the reactor thread after each change notification.
+    using Callback = std::function<void(const ObservedResource& changed)>;
+
+    /// `reactor` must outlive the watcher.
+    DirectoryWatcher(Reactor& reactor, std::filesystem::path directory, Callback on_change);
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    /// Start watching.  False if the directory cannot be watched; no-op if
+    /// already running.
+    bool start();
+
+    /// Stop watching.  No-op if not running.
+    void stop();
+
+private:
+    void on_signaled();   // reactor thread
+
+    Reactor&              reactor_;
+    std::filesystem::path directory_;
+    Callback              on_change_;
+    HANDLE                handle_ = INVALID_HANDLE_VALUE;
+    ReactorId             id_ = 0;
+};
+
+} // namespace hdrfixer::fixes
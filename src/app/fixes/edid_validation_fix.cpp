@@ -0,0 +1,87 @@
+#include "edid_validation_fix.h"
+#include <format>
+
+namespace hdrfixer::fixes {
+
+EdidValidationFix::EdidValidationFix(const display::DisplayInfo& display,
+                                     display::EdidValidationCache& cache)
+    : display_(display)
+    , cache_(cache)
+{
+    reported_.max_luminance = display_.max_luminance;
+    reported_.min_luminance = display_.min_luminance;
+    reported_.max_full_frame_luminance = display_.max_full_frame_luminance;
+    reported_.red = {display_.red_primary[0], display_.red_primary[1]};
+    reported_.green = {display_.green_primary[0], display_.green_primary[1]};
+    reported_.blue = {display_.blue_primary[0], display_.blue_primary[1]};
+    reported_.white = {display_.white_point[0], display_.white_point[1]};
+}
+
+std::string EdidValidationFix::name() const {
+    return std::string(kName);
+}
+
+std::string EdidValidationFix::description() const {
+    return "Validates the display EDID and cross-checks it against DXGI-reported capabilities";
+}
+
+FixCategory EdidValidationFix::category() const {
+    return FixCategory::EdidValidation;
+}
+
+// The EDID and DXGI capabilities are captured at construction; only a
+// change to the display itself can alter the verdict.
+std::vector<ObservedResource> EdidValidationFix::observed_resources() const {
+    return {ObservedResource::display_target(display::luid_key(display_.adapter_luid), display_.target_id)};
+}
+
+FixStatus EdidValidationFix::diagnose() {
+    if (display_.edid_data.empty()) {
+        return FixStatus{
+            FixState::NotNeeded,
+            "No EDID available for this display; validation skipped."
+        };
+    }
+
+    auto report = cache_.validate(display_.edid_data, reported_);
+
+    if (report.has_errors()) {
+        return FixStatus{
+            FixState::Warning,
+            std::format("EDID is invalid ({}).  Consider adding a panel quirk entry.",
+                        report.summary())
+        };
+    }
+
+    if (!report.issues.empty()) {
+        return FixStatus{
+            FixState::NotNeeded,
+            std::format("EDID is usable with warnings ({}).", report.summary())
+        };
+    }
+
+    return FixStatus{
+        FixState::NotNeeded,
+        "EDID is valid and consistent with DXGI-reported capabilities."
+    };
+}
+
+FixResult EdidValidationFix::apply() {
+    // An EDID cannot be rewritten from user mode; overrides belong in the
+    // panel quirks database.
+    return FixResult{
+        false,
+        "EDID problems cannot be fixed in software.  Add a panel quirk entry "
+        "to override the reported capabilities."
+    };
+}
+
+FixResult EdidValidationFix::revert() {
+    // Nothing to revert since apply() never changes the system.
+    return FixResult{
+        false,
+        "EDID validation does not modify the system; nothing to revert."
+    };
+}
+
+} // namespace hdrfixer::fixes
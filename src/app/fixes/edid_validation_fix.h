@@ -0,0 +1,38 @@
+#pragma once
+#include "core/fixes/fix_engine.h"
+#include "core/display/display_info.h"
+#include "core/display/edid_validator.h"
+
+namespace hdrfixer::fixes {
+
+// Detect-and-warn fix: validates the display's EDID (checksums, reserved
+// bits, luminance/chromaticity plausibility) and cross-checks it against
+// what DXGI reports.  Reports are cached by EDID hash in a cache shared
+// across engine rebuilds, so watchdog re-diagnoses are a hash and a lookup.
+// A broken EDID is reported as FixState::Warning, which the engine never
+// applies: it can only be worked around with a panel quirk entry, so
+// apply()/revert() are no-ops.
+class EdidValidationFix : public IFix {
+public:
+    static constexpr std::string_view kName = "EDID Validation";
+    static constexpr FixId kId = fix_id(kName);
+
+    EdidValidationFix(const display::DisplayInfo& display,
+                      display::EdidValidationCache& cache);
+
+    std::string name() const override;
+    std::string description() const override;
+    FixCategory category() const override;
+
+    FixStatus diagnose() override;
+    FixResult apply() override;
+    FixResult revert() override;
+    std::vector<ObservedResource> observed_resources() const override;
+
+private:
+    display::DisplayInfo display_;
+    display::ReportedCapabilities reported_;
+    display::EdidValidationCache& cache_;
+};
+
+} // namespace hdrfixer::fixes
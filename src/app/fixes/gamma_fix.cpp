@@ -1,8 +1,11 @@
 #include "gamma_fix.h"
+#include "sdr_brightness_fix.h"
 #include "core/color/gamma_lut.h"
 #include "core/profile/mhc2_writer.h"
 #include "core/profile/wcs_installer.h"
 #include "core/display/display_info.h"
+#include "core/display/display_identity.h"
+#include "core/display/display_config.h"
 #include <format>
 
 namespace hdrfixer::fixes {
@@ -11,7 +14,7 @@ GammaFix::GammaFix(const hdrfixer::display::DisplayInfo& display)
     : display_(display) {}
 
 std::string GammaFix::name() const {
-    return "GammaCorrection";
+    return std::string(kName);
 }
 
 std::string GammaFix::description() const {
@@ -22,22 +25,102 @@ FixCategory GammaFix::category() const {
     return FixCategory::ToneCurve;
 }
 
+// The LUT is built for the live SDR white level, so it is generated
+// after SDR brightness has been corrected.  SdrBrightnessFix only
+// recommends a level for now; until it writes one, the edge just fixes
+// the order.
+std::vector<FixId> GammaFix::dependencies() const {
+    return {SdrBrightnessFix::kId};
+}
+
+// Queried at apply time, not taken from the DisplayInfo this fix was made
+// with, so the LUT follows whatever an earlier fix or the user set
+double GammaFix::sdr_white_nits() const {
+    float nits = display::get_sdr_white_level(display_.adapter_luid, display_.target_id)
+        .value_or(display_.sdr_white_level_nits);
+    return nits > 0.0f ? static_cast<double>(nits) : kDefaultSdrWhiteNits;
+}
+
 std::filesystem::path GammaFix::profile_path() const {
     wchar_t temp_dir[MAX_PATH] = {};
     GetTempPathW(MAX_PATH, temp_dir);
     return std::filesystem::path(temp_dir) / profile_filename();
 }
 
+// The WCS API installs profiles to the system color directory
+std::filesystem::path GammaFix::color_directory() {
+    wchar_t system_dir[MAX_PATH] = {};
+    GetSystemDirectoryW(system_dir, MAX_PATH);
+    return std::filesystem::path(system_dir) / L"spool" / L"drivers" / L"color";
+}
+
+std::filesystem::path GammaFix::system_profile_path() const {
+    return color_directory() / profile_filename();
+}
+
+std::vector<ObservedResource> GammaFix::observed_resources() const {
+    return {
+        ObservedResource::display_target(display::luid_key(display_.adapter_luid), display_.target_id),
+        ObservedResource::file(system_profile_path().wstring()),
+    };
+}
+
+std::vector<PlannedEffect> GammaFix::planned_effects(PlanOp op) const {
+    auto system_profile = ObservedResource::file(system_profile_path().wstring());
+    auto temp_profile = ObservedResource::file(profile_path().wstring());
+    auto target = ObservedResource::display_target(display::luid_key(display_.adapter_luid), display_.target_id);
+    auto effects = legacy_profile_effects();
+    if (op == PlanOp::Revert) {
+        effects.insert(effects.end(), {
+            {target, "remove default color profile association"},
+            {system_profile, "uninstall"},
+            {temp_profile, "delete"},
+        });
+        return effects;
+    }
+    double white_nits = sdr_white_nits();
+    effects.insert(effects.end(), {
+        {temp_profile, std::format("write MHC2 profile, gamma 2.2 LUT for {:.0f} nits SDR white, "
+                                   "{:.0f} nits peak", white_nits, display_.max_luminance)},
+        {system_profile, "install"},
+        {target, "set as default color profile"},
+    });
+    return effects;
+}
+
+std::vector<PlannedEffect> GammaFix::legacy_profile_effects() const {
+    auto legacy = color_directory() / kLegacyProfileName;
+    if (!std::filesystem::exists(legacy)) return {};
+    return {{ObservedResource::file(legacy.wstring()), "uninstall legacy shared profile"}};
+}
+
+void GammaFix::remove_legacy_profile() const {
+    if (!std::filesystem::exists(color_directory() / kLegacyProfileName)) return;
+    // Uninstalling may fail while the profile is still associated with
+    // another display; that display's fix removes it, and later applies
+    // retry until the file is gone
+    (void)hdrfixer::profile::uninstall_profile(kLegacyProfileName, display_.source_adapter_luid,
+                                               display_.source_id);
+    wchar_t temp_dir[MAX_PATH] = {};
+    GetTempPathW(MAX_PATH, temp_dir);
+    std::error_code ec;
+    std::filesystem::remove(std::filesystem::path(temp_dir) / kLegacyProfileName, ec);
+}
+
+// One profile per display: each LUT is built from that display's SDR white
+// level and peak luminance, and displays are fixed concurrently.  Named by
+// connector rather than fingerprint, so a failed EDID read does not orphan
+// the installed profile.
 std::wstring GammaFix::profile_filename() const {
-    return L"HDRFixer_Gamma22.icm";
+    return std::format(L"{}_{:016x}.icm", kProfileBaseName,
+                       display::display_path_key(display_));
 }
 
 FixResult GammaFix::apply() {
+    remove_legacy_profile();
+
     // Step 1: Determine SDR white level for this display
-    double white_nits = static_cast<double>(display_.sdr_white_level_nits);
-    if (white_nits <= 0.0) {
-        white_nits = kDefaultSdrWhiteNits;
-    }
+    double white_nits = sdr_white_nits();
 
     // Step 2: Generate HDR gamma correction LUT
     auto lut = hdrfixer::color::generate_hdr_lut(kLutSize, white_nits, 0.0);
@@ -61,7 +144,7 @@ FixResult GammaFix::apply() {
     // Step 5: Install profile via WCS and associate with this display
     hdrfixer::profile::InstallParams install{};
     install.profile_path = path;
-    install.adapter_luid = display_.adapter_luid;
+    install.adapter_luid = display_.source_adapter_luid;
     install.source_id = display_.source_id;
     install.set_as_default = true;
 
@@ -74,9 +157,11 @@ FixResult GammaFix::apply() {
 }
 
 FixResult GammaFix::revert() {
+    remove_legacy_profile();
+
     auto result = hdrfixer::profile::uninstall_profile(
         profile_filename(),
-        display_.adapter_luid,
+        display_.source_adapter_luid,
         display_.source_id
     );
 
@@ -93,12 +178,8 @@ FixResult GammaFix::revert() {
 }
 
 FixStatus GammaFix::diagnose() {
-    // Check if the profile file exists in the system color directory
-    // The WCS API installs profiles to the system color directory,
-    // so we check if our profile filename is installed
-    wchar_t color_dir[MAX_PATH] = {};
-    GetSystemDirectoryW(color_dir, MAX_PATH);
-    auto system_profile = std::filesystem::path(color_dir) / L"spool" / L"drivers" / L"color" / profile_filename();
+    // Check if our profile is installed in the system color directory
+    auto system_profile = system_profile_path();
 
     if (std::filesystem::exists(system_profile)) {
         return {FixState::Applied, "Gamma 2.2 correction profile is installed"};
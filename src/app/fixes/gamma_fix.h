@@ -7,6 +7,9 @@ namespace hdrfixer::fixes {
 
 class GammaFix : public IFix {
 public:
+    static constexpr std::string_view kName = "GammaCorrection";
+    static constexpr FixId kId = fix_id(kName);
+
     explicit GammaFix(const hdrfixer::display::DisplayInfo& display);
 
     std::string name() const override;
@@ -15,15 +18,28 @@ public:
     FixResult apply() override;
     FixResult revert() override;
     FixStatus diagnose() override;
+    std::vector<FixId> dependencies() const override;
+    std::vector<ObservedResource> observed_resources() const override;
+    std::vector<PlannedEffect> planned_effects(PlanOp op) const override;
+
+    /// Where the WCS API installs profiles (spool\drivers\color)
+    static std::filesystem::path color_directory();
 
 private:
     std::filesystem::path profile_path() const;
+    std::filesystem::path system_profile_path() const;
     std::wstring profile_filename() const;
+    double sdr_white_nits() const;
+    /// Uninstall the single profile earlier versions shared across all
+    /// displays, with its association to this one; no-op once it is gone
+    void remove_legacy_profile() const;
+    std::vector<PlannedEffect> legacy_profile_effects() const;
 
     hdrfixer::display::DisplayInfo display_;
     static constexpr double kDefaultSdrWhiteNits = 200.0;
     static constexpr int kLutSize = 4096;
-    static constexpr const char* kProfileBaseName = "HDRFixer_Gamma22";
+    static constexpr const wchar_t* kProfileBaseName = L"HDRFixer_Gamma22";
+    static constexpr const wchar_t* kLegacyProfileName = L"HDRFixer_Gamma22.icm";
 };
 
 } // namespace hdrfixer::fixes
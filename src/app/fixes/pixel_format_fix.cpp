@@ -9,7 +9,7 @@ PixelFormatFix::PixelFormatFix(const display::DisplayInfo& display)
 }
 
 std::string PixelFormatFix::name() const {
-    return "Pixel Format";
+    return std::string(kName);
 }
 
 std::string PixelFormatFix::description() const {
@@ -20,6 +20,10 @@ FixCategory PixelFormatFix::category() const {
     return FixCategory::PixelFormat;
 }
 
+std::vector<ObservedResource> PixelFormatFix::observed_resources() const {
+    return {ObservedResource::display_target(display::luid_key(display_.adapter_luid), display_.target_id)};
+}
+
 FixStatus PixelFormatFix::diagnose() {
     uint32_t bpc = display_.bits_per_color;
 
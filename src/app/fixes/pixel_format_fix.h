@@ -10,6 +10,9 @@ namespace hdrfixer::fixes {
 // because the pixel format can only be changed through the GPU driver UI.
 class PixelFormatFix : public IFix {
 public:
+    static constexpr std::string_view kName = "Pixel Format";
+    static constexpr FixId kId = fix_id(kName);
+
     explicit PixelFormatFix(const display::DisplayInfo& display);
 
     std::string name() const override;
@@ -19,6 +22,7 @@ public:
     FixStatus diagnose() override;
     FixResult apply() override;
     FixResult revert() override;
+    std::vector<ObservedResource> observed_resources() const override;
 
 private:
     display::DisplayInfo display_;
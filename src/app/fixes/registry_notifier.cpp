@@ -0,0 +1,72 @@
+#include "registry_notifier.h"
+#include "watchdog.h"
+#include "core/log/logger.h"
+#include <format>
+
+namespace hdrfixer::fixes {
+
+RegistryNotifier::RegistryNotifier(const std::vector<WatchedKey>& keys, size_t max_slots)
+    : keys_(keys)
+    , slot_of_(keys.size(), static_cast<size_t>(-1))
+{
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        const auto& key = keys_[i];
+        std::string name = key.resource().key;
+        if (slots_.size() == max_slots) {
+            LOG_ERROR(std::format("Watchdog: too many keys, not watching {}", name));
+            continue;
+        }
+        HKEY hkey = nullptr;
+        LONG rc = ::RegOpenKeyExW(key.root, key.path.c_str(), 0, KEY_NOTIFY, &hkey);
+        if (rc != ERROR_SUCCESS) {
+            LOG_WARN(std::format("Watchdog: not watching {} (RegOpenKeyExW failed: {})",
+                name, rc));
+            continue;
+        }
+        HANDLE event = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!event) {
+            LOG_ERROR("Watchdog: failed to create registry event");
+            ::RegCloseKey(hkey);
+            continue;
+        }
+        slot_of_[i] = slots_.size();
+        slots_.push_back({i, hkey, event});
+    }
+}
+
+RegistryNotifier::~RegistryNotifier()
+{
+    for (auto& slot : slots_) {
+        ::CloseHandle(slot.event);
+        ::RegCloseKey(slot.hkey);
+    }
+}
+
+bool RegistryNotifier::watched(size_t key) const
+{
+    return key < slot_of_.size() && slot_of_[key] != static_cast<size_t>(-1);
+}
+
+HANDLE RegistryNotifier::event(size_t key) const
+{
+    return slots_[slot_of_[key]].event;
+}
+
+bool RegistryNotifier::arm(size_t key)
+{
+    const Slot& slot = slots_[slot_of_[key]];
+    LONG rc = ::RegNotifyChangeKeyValue(
+        slot.hkey,
+        keys_[key].subtree ? TRUE : FALSE,
+        REG_NOTIFY_CHANGE_LAST_SET |          // value changes
+            REG_NOTIFY_CHANGE_NAME,           // subkey add/delete
+        slot.event,
+        TRUE);                                // async
+    if (rc != ERROR_SUCCESS) {
+        LOG_ERROR(std::format("Watchdog: RegNotifyChangeKeyValue failed ({})", rc));
+        return false;
+    }
+    return true;
+}
+
+} // namespace hdrfixer::fixes
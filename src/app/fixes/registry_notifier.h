@@ -0,0 +1,44 @@
+#pragma once
+#include <windows.h>
+#include <winreg.h>
+#include <vector>
+
+namespace hdrfixer::fixes {
+
+struct WatchedKey;
+
+/// One RegNotifyChangeKeyValue slot per watched key: the open key and the
+/// auto-reset event the notification signals.  The events are meant to be
+/// multiplexed by a Reactor.  Keys that cannot be opened (e.g. no per-app
+/// GPU preferences yet) are skipped and reported unwatched.
+class RegistryNotifier {
+public:
+    /// `keys` stays owned by the caller.  At most `max_slots` keys are opened.
+    RegistryNotifier(const std::vector<WatchedKey>& keys, size_t max_slots);
+    ~RegistryNotifier();
+
+    RegistryNotifier(const RegistryNotifier&) = delete;
+    RegistryNotifier& operator=(const RegistryNotifier&) = delete;
+
+    /// True if no key could be opened.
+    bool empty() const noexcept { return slots_.empty(); }
+
+    bool watched(size_t key) const;
+    /// Event signaled when `key` changes; only for watched keys.
+    HANDLE event(size_t key) const;
+    /// (Re-)arm `key`'s one-shot notification.  False on failure.
+    bool arm(size_t key);
+
+private:
+    struct Slot {
+        size_t key;
+        HKEY   hkey;
+        HANDLE event;     ///< auto-reset, signaled by RegNotifyChangeKeyValue
+    };
+
+    const std::vector<WatchedKey>& keys_;
+    std::vector<Slot>   slots_;
+    std::vector<size_t> slot_of_;        ///< key index -> slot, or npos
+};
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,112 @@
+#include "registry_tree.h"
+#include <algorithm>
+
+namespace hdrfixer::fixes {
+
+Win32RegistryTree::Win32RegistryTree(HKEY root, std::wstring path)
+    : root_(root)
+    , path_(std::move(path))
+{
+}
+
+HKEY Win32RegistryTree::open(const std::wstring& path) const
+{
+    std::wstring full = path.empty() ? path_ : path_ + L"\\" + path;
+    HKEY hkey = nullptr;
+    if (::RegOpenKeyExW(root_, full.c_str(), 0, KEY_READ, &hkey) != ERROR_SUCCESS) {
+        return nullptr;
+    }
+    return hkey;
+}
+
+std::optional<IRegistryTree::KeyInfo> Win32RegistryTree::query(const std::wstring& path)
+{
+    HKEY hkey = open(path);
+    if (!hkey) {
+        return std::nullopt;
+    }
+
+    DWORD subkey_count = 0;
+    DWORD max_name = 0;
+    FILETIME written{};
+    LSTATUS rc = ::RegQueryInfoKeyW(hkey, nullptr, nullptr, nullptr, &subkey_count, &max_name,
+                                    nullptr, nullptr, nullptr, nullptr, nullptr, &written);
+    if (rc != ERROR_SUCCESS) {
+        ::RegCloseKey(hkey);
+        return std::nullopt;
+    }
+
+    KeyInfo info;
+    info.last_write = (static_cast<uint64_t>(written.dwHighDateTime) << 32) | written.dwLowDateTime;
+    std::wstring name(max_name + 1, L'\0');
+    for (DWORD i = 0;;) {
+        DWORD len = static_cast<DWORD>(name.size());
+        rc = ::RegEnumKeyExW(hkey, i, name.data(), &len, nullptr, nullptr, nullptr, nullptr);
+        if (rc == ERROR_MORE_DATA && name.size() < 256) {
+            // A longer subkey appeared since RegQueryInfoKeyW; 255 is the limit
+            name.resize(256);
+            continue;
+        }
+        if (rc != ERROR_SUCCESS) {
+            break;  // ERROR_NO_MORE_ITEMS, or the key went away mid-walk
+        }
+        info.subkeys.emplace_back(name.data(), len);
+        ++i;
+    }
+
+    ::RegCloseKey(hkey);
+    return info;
+}
+
+std::vector<RegistryValue> Win32RegistryTree::values(const std::wstring& path)
+{
+    std::vector<RegistryValue> out;
+    HKEY hkey = open(path);
+    if (!hkey) {
+        return out;
+    }
+
+    DWORD max_name = 0;
+    DWORD max_data = 0;
+    if (::RegQueryInfoKeyW(hkey, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                           &max_name, &max_data, nullptr, nullptr) != ERROR_SUCCESS) {
+        ::RegCloseKey(hkey);
+        return out;
+    }
+
+    std::wstring name(max_name + 1, L'\0');
+    // Never pass a null data buffer: RegEnumValueW then succeeds and only
+    // reports the size, which must not be read back as the value.
+    std::vector<uint8_t> data(std::max<DWORD>(max_data, 1));
+    for (DWORD i = 0;;) {
+        DWORD name_len = static_cast<DWORD>(name.size());
+        DWORD data_len = static_cast<DWORD>(data.size());
+        DWORD type = 0;
+        LSTATUS rc = ::RegEnumValueW(hkey, i, name.data(), &name_len, nullptr, &type,
+                                     data.data(), &data_len);
+        if (rc == ERROR_SUCCESS && data_len > data.size()) {
+            rc = ERROR_MORE_DATA;
+        }
+        if (rc == ERROR_MORE_DATA) {
+            // The value grew since RegQueryInfoKeyW: re-read the sizes and retry
+            if (::RegQueryInfoKeyW(hkey, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                   &max_name, &max_data, nullptr, nullptr) != ERROR_SUCCESS) {
+                break;
+            }
+            name.resize(max_name + 1);
+            data.resize(std::max<size_t>({max_data, data_len, data.size() + 1}));
+            continue;
+        }
+        if (rc != ERROR_SUCCESS) {
+            break;
+        }
+        out.push_back({std::wstring(name.data(), name_len), type,
+                       std::vector<uint8_t>(data.begin(), data.begin() + data_len)});
+        ++i;
+    }
+
+    ::RegCloseKey(hkey);
+    return out;
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,26 @@
+#pragma once
+#include <windows.h>
+#include <winreg.h>
+#include <string>
+#include "core/fixes/registry_snapshot.h"
+
+namespace hdrfixer::fixes {
+
+/// IRegistryTree over a live registry subtree.  Every call opens its key
+/// afresh, so keys created or deleted between calls are seen as such.
+class Win32RegistryTree : public IRegistryTree {
+public:
+    Win32RegistryTree(HKEY root, std::wstring path);
+
+    std::optional<KeyInfo> query(const std::wstring& path) override;
+    std::vector<RegistryValue> values(const std::wstring& path) override;
+
+private:
+    /// Open `path` below the subtree root for reading; nullptr if missing.
+    HKEY open(const std::wstring& path) const;
+
+    HKEY         root_;
+    std::wstring path_;
+};
+
+} // namespace hdrfixer::fixes
@@ -1,5 +1,6 @@
 #include "sdr_brightness_fix.h"
 #include "core/display/display_config.h"
+#include "core/registry/hdr_registry.h"
 #include <cmath>
 #include <format>
 
@@ -11,7 +12,7 @@ SdrBrightnessFix::SdrBrightnessFix(const display::DisplayInfo& display)
 }
 
 std::string SdrBrightnessFix::name() const {
-    return "SDR Brightness";
+    return std::string(kName);
 }
 
 std::string SdrBrightnessFix::description() const {
@@ -22,6 +23,15 @@ FixCategory SdrBrightnessFix::category() const {
     return FixCategory::SdrBrightness;
 }
 
+// The live white level comes from DisplayConfig for this target and is
+// persisted by the OS under MonitorDataStore.
+std::vector<ObservedResource> SdrBrightnessFix::observed_resources() const {
+    return {
+        ObservedResource::display_target(display::luid_key(display_.adapter_luid), display_.target_id),
+        ObservedResource::registry_key(L"HKLM", registry::kMonitorDataStore),
+    };
+}
+
 float SdrBrightnessFix::optimal_white_level() const {
     float max_lum = display_.max_luminance;
     if (max_lum >= 800.0f) return 200.0f;
@@ -74,6 +84,18 @@ FixResult SdrBrightnessFix::apply() {
     };
 }
 
+std::vector<PlannedEffect> SdrBrightnessFix::planned_effects(PlanOp op) const {
+    // apply() only recommends a level for now, so nothing is written yet
+    if (op == PlanOp::Revert) return {};
+    auto current_nits = display::get_sdr_white_level(display_.adapter_luid, display_.target_id)
+        .value_or(display_.sdr_white_level_nits);
+    return {{
+        ObservedResource::display_target(display::luid_key(display_.adapter_luid), display_.target_id),
+        std::format("recommend SDR white level {:.0f} -> {:.0f} nits (not written)",
+                    current_nits, optimal_white_level())
+    }};
+}
+
 FixResult SdrBrightnessFix::revert() {
     // Nothing to revert since apply() does not modify the system yet.
     return FixResult{
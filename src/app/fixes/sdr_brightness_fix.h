@@ -8,6 +8,9 @@ namespace hdrfixer::fixes {
 // the correct value based on the display's peak luminance capability.
 class SdrBrightnessFix : public IFix {
 public:
+    static constexpr std::string_view kName = "SDR Brightness";
+    static constexpr FixId kId = fix_id(kName);
+
     explicit SdrBrightnessFix(const display::DisplayInfo& display);
 
     std::string name() const override;
@@ -17,6 +20,8 @@ public:
     FixStatus diagnose() override;
     FixResult apply() override;
     FixResult revert() override;
+    std::vector<ObservedResource> observed_resources() const override;
+    std::vector<PlannedEffect> planned_effects(PlanOp op) const override;
 
 private:
     // Calculate the optimal SDR white level based on panel max luminance.
@@ -0,0 +1,76 @@
+#include "session_monitor.h"
+#include "core/log/logger.h"
+
+#include <wtsapi32.h>
+
+namespace hdrfixer::fixes {
+
+// GUID_CONSOLE_DISPLAY_STATE {6FE69556-704A-47A0-8F24-C28D936FDA47}
+static const GUID GUID_CONSOLE_DISPLAY_STATE_LOCAL =
+    {0x6fe69556, 0x704a, 0x47a0, {0x8f, 0x24, 0xc2, 0x8d, 0x93, 0x6f, 0xda, 0x47}};
+
+SessionMonitor::~SessionMonitor()
+{
+    unregister_session();
+}
+
+bool SessionMonitor::register_session(HWND hwnd)
+{
+    unregister_session();
+
+    if (::WTSRegisterSessionNotification(hwnd, NOTIFY_FOR_THIS_SESSION)) {
+        hwnd_ = hwnd;
+    } else {
+        LOG_ERROR("SessionMonitor: WTSRegisterSessionNotification failed");
+    }
+
+    // Sends the current display state right away, then every change.
+    power_notify_ = ::RegisterPowerSettingNotification(
+        hwnd, &GUID_CONSOLE_DISPLAY_STATE_LOCAL, DEVICE_NOTIFY_WINDOW_HANDLE);
+    if (!power_notify_) {
+        LOG_ERROR("SessionMonitor: RegisterPowerSettingNotification failed");
+    }
+
+    if (!hwnd_ && !power_notify_) {
+        return false;
+    }
+    LOG_INFO("SessionMonitor: registered for session and display-state notifications");
+    return true;
+}
+
+void SessionMonitor::unregister_session()
+{
+    if (hwnd_) {
+        ::WTSUnRegisterSessionNotification(hwnd_);
+        hwnd_ = nullptr;
+    }
+    if (power_notify_) {
+        ::UnregisterPowerSettingNotification(power_notify_);
+        power_notify_ = nullptr;
+    }
+}
+
+bool SessionMonitor::handle_message(UINT msg, WPARAM wParam, LPARAM lParam)
+{
+    bool was_active = active();
+
+    if (msg == WM_WTSSESSION_CHANGE) {
+        if (wParam == WTS_SESSION_LOCK) {
+            locked_ = true;
+        } else if (wParam == WTS_SESSION_UNLOCK) {
+            locked_ = false;
+        }
+    } else if (msg == WM_POWERBROADCAST && wParam == PBT_POWERSETTINGCHANGE && lParam) {
+        auto* setting = reinterpret_cast<const POWERBROADCAST_SETTING*>(lParam);
+        if (::IsEqualGUID(setting->PowerSetting, GUID_CONSOLE_DISPLAY_STATE_LOCAL) &&
+            setting->DataLength >= sizeof(DWORD)) {
+            // 0 = off, 1 = on, 2 = dimmed (still visible)
+            DWORD state = *reinterpret_cast<const DWORD*>(setting->Data);
+            display_on_ = state != 0;
+        }
+    }
+
+    return active() != was_active;
+}
+
+} // namespace hdrfixer::fixes
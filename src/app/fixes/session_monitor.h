@@ -0,0 +1,38 @@
+#pragma once
+#include <windows.h>
+
+namespace hdrfixer::fixes {
+
+/// Tracks whether anyone can see the displays: the session is unlocked and
+/// the console display is on.  Registers for WM_WTSSESSION_CHANGE and the
+/// console display-state power setting (WM_POWERBROADCAST).
+class SessionMonitor {
+public:
+    SessionMonitor() = default;
+    ~SessionMonitor();
+
+    SessionMonitor(const SessionMonitor&) = delete;
+    SessionMonitor& operator=(const SessionMonitor&) = delete;
+
+    /// Register the given window for session and display-state
+    /// notifications.  Returns true if at least one registration succeeded.
+    bool register_session(HWND hwnd);
+
+    /// Unregister both notifications.
+    void unregister_session();
+
+    /// Feed WM_WTSSESSION_CHANGE and WM_POWERBROADCAST from your window
+    /// procedure.  Returns true when active() changed.
+    bool handle_message(UINT msg, WPARAM wParam, LPARAM lParam);
+
+    /// Unlocked with the display on.
+    bool active() const { return !locked_ && display_on_; }
+
+private:
+    HWND         hwnd_{nullptr};
+    HPOWERNOTIFY power_notify_{nullptr};
+    bool         locked_{false};
+    bool         display_on_{true};
+};
+
+} // namespace hdrfixer::fixes
@@ -6,7 +6,7 @@ namespace hdrfixer::fixes {
 ShareHelper::ShareHelper() = default;
 
 std::string ShareHelper::name() const {
-    return "Screen Share Helper";
+    return std::string(kName);
 }
 
 std::string ShareHelper::description() const {
@@ -99,4 +99,28 @@ FixResult ShareHelper::revert() {
     };
 }
 
+std::vector<PlannedEffect> ShareHelper::planned_effects(PlanOp op) const {
+    // Like apply()/revert(), these are the intended writes; none happen yet
+    std::vector<PlannedEffect> effects;
+    if (op == PlanOp::Revert) {
+        for (const auto& saved : saved_levels_) {
+            effects.push_back({
+                ObservedResource::display_target(display::luid_key(saved.adapter_id), saved.target_id),
+                std::format("SDR white level {:.0f} -> {:.0f} nits (pending)", kShareModeNits, saved.original_nits)
+            });
+        }
+        return effects;
+    }
+
+    auto paths = display::query_display_paths();
+    if (!paths) return effects;
+    for (const auto& path : *paths) {
+        effects.push_back({
+            ObservedResource::display_target(display::luid_key(path.adapter_id), path.target_id),
+            std::format("SDR white level {:.0f} -> {:.0f} nits (pending)", path.sdr_white_level_nits, kShareModeNits)
+        });
+    }
+    return effects;
+}
+
 } // namespace hdrfixer::fixes
@@ -13,6 +13,9 @@ namespace hdrfixer::fixes {
 // are restored.
 class ShareHelper : public IFix {
 public:
+    static constexpr std::string_view kName = "Screen Share Helper";
+    static constexpr FixId kId = fix_id(kName);
+
     ShareHelper();
 
     std::string name() const override;
@@ -22,6 +25,7 @@ public:
     FixStatus diagnose() override;
     FixResult apply() override;
     FixResult revert() override;
+    std::vector<PlannedEffect> planned_effects(PlanOp op) const override;
 
     bool is_share_mode_active() const { return share_mode_active_; }
 
@@ -1,151 +1,180 @@
 #include "watchdog.h"
 #include "core/log/logger.h"
 #include "core/registry/hdr_registry.h"
+#include <chrono>
 #include <format>
 
 namespace hdrfixer::fixes {
 
-// Timeout between forced re-checks even when no notification fires (ms).
-static constexpr DWORD kFallbackTimeoutMs = 60'000;
+std::vector<WatchedKey> default_watched_keys()
+{
+    return {
+        {HKEY_LOCAL_MACHINE, L"HKLM", registry::kGraphicsDrivers},
+        {HKEY_CURRENT_USER,  L"HKCU", registry::kDirectXUserPrefs},
+        {HKEY_CURRENT_USER,  L"HKCU", registry::kDirect3D},
+        {HKEY_LOCAL_MACHINE, L"HKLM", registry::kDirect3D},
+        {HKEY_CURRENT_USER,  L"HKCU", registry::kVideoSettings},
+    };
+}
 
-Watchdog::Watchdog(std::function<void()> on_change)
-    : on_change_(std::move(on_change))
+Watchdog::Watchdog(Reactor& reactor, Callback on_change, std::vector<WatchedKey> keys,
+                   DebounceConfig debounce, AdaptivePollConfig poll)
+    : reactor_(reactor)
+    , on_change_(std::move(on_change))
+    , keys_(std::move(keys))
+    , loop_(keys_.size(), debounce, poll)
+    , changes_(keys_.size(), std::vector<ObservedResource>{})
 {
-    // Manual-reset event used to signal the thread to stop.
-    stop_event_ = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
-    if (!stop_event_) {
-        LOG_ERROR("Watchdog: failed to create stop event");
-    }
 }
 
 Watchdog::~Watchdog()
 {
     stop();
-    if (stop_event_) {
-        ::CloseHandle(stop_event_);
-    }
 }
 
 void Watchdog::start()
 {
-    if (running_.load(std::memory_order_acquire)) {
+    if (running_.exchange(true, std::memory_order_acq_rel)) {
         return; // already running
     }
-
-    if (!stop_event_) {
-        LOG_ERROR("Watchdog: cannot start -- stop event is invalid");
-        return;
+    // Snapshots and handle registration happen where the handlers will run.
+    reactor_.call([this] { setup(); });
+    if (running()) {
+        LOG_INFO("Watchdog: started");
     }
-
-    // Ensure the stop event is non-signaled before launching the thread.
-    ::ResetEvent(stop_event_);
-    running_.store(true, std::memory_order_release);
-    thread_ = std::thread(&Watchdog::thread_func, this);
-    LOG_INFO("Watchdog: started");
 }
 
 void Watchdog::stop()
 {
-    bool was_running = running_.exchange(false, std::memory_order_acq_rel);
-
-    // Wake the thread out of WaitForMultipleObjects.
-    if (stop_event_) {
-        ::SetEvent(stop_event_);
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
     }
+    // Handles must leave the reactor's wait before their events are closed.
+    reactor_.call([this] { teardown(); });
+    LOG_INFO("Watchdog: stopped");
+}
 
-    // Always join if joinable — thread_func may have set running_ to false
-    // before we got here, but the thread still needs to be joined.
-    if (thread_.joinable()) {
-        thread_.join();
-    }
+void Watchdog::report_check(bool drift)
+{
+    loop_.report_check(drift);
+}
 
-    if (was_running) {
-        LOG_INFO("Watchdog: stopped");
+void Watchdog::set_paused(bool paused)
+{
+    loop_.set_paused(paused);
+}
+
+std::optional<std::vector<ObservedResource>> Watchdog::take_changes(size_t key)
+{
+    std::lock_guard lock(changes_mutex_);
+    if (key >= changes_.size()) {
+        return std::nullopt;
     }
+    auto taken = std::move(changes_[key]);
+    changes_[key].emplace();
+    return taken;
 }
 
-void Watchdog::thread_func()
+void Watchdog::setup()
 {
-    // Open the registry key for notifications.
-    HKEY hkey = nullptr;
-    LONG rc = ::RegOpenKeyExW(
-        HKEY_LOCAL_MACHINE,
-        registry::kGraphicsDrivers,
-        0,
-        KEY_NOTIFY,
-        &hkey);
-
-    if (rc != ERROR_SUCCESS) {
-        LOG_ERROR(std::format("Watchdog: RegOpenKeyExW failed ({})", rc));
+    // One reactor slot stays free for other background features.
+    notifier_ = std::make_unique<RegistryNotifier>(keys_, MAXIMUM_WAIT_OBJECTS - 2);
+    if (notifier_->empty()) {
+        LOG_ERROR("Watchdog: no registry keys could be watched");
+        notifier_.reset();
         running_.store(false, std::memory_order_release);
         return;
     }
 
-    // Auto-reset event that RegNotifyChangeKeyValue will signal.
-    HANDLE reg_event = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
-    if (!reg_event) {
-        LOG_ERROR("Watchdog: failed to create registry event");
-        ::RegCloseKey(hkey);
-        running_.store(false, std::memory_order_release);
-        return;
+    // Baseline snapshots, taken before any notification is armed.
+    trees_.clear();
+    snapshots_.assign(keys_.size(), RegistrySnapshot{});
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        trees_.emplace_back(keys_[i].root, keys_[i].path);
+        if (notifier_->watched(i) && snapshots_[i].capture(trees_[i])) {
+            LOG_DEBUG(std::format("Watchdog: snapshot of {} holds {} key(s)",
+                keys_[i].resource().key, snapshots_[i].key_count()));
+        }
     }
 
-    HANDLE wait_handles[2] = { stop_event_, reg_event };
-
-    while (running_.load(std::memory_order_acquire)) {
-        // Register for asynchronous notification of any change under the key.
-        rc = ::RegNotifyChangeKeyValue(
-            hkey,
-            TRUE,                                 // watch subtree
-            REG_NOTIFY_CHANGE_LAST_SET |          // value changes
-                REG_NOTIFY_CHANGE_NAME,           // subkey add/delete
-            reg_event,
-            TRUE);                                // async
-
-        if (rc != ERROR_SUCCESS) {
-            LOG_ERROR(std::format("Watchdog: RegNotifyChangeKeyValue failed ({})", rc));
-            break;
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        if (!notifier_->watched(i) || !notifier_->arm(i)) {
+            continue;
+        }
+        auto id = reactor_.add_handle(notifier_->event(i), [this, i] { on_notification(i); });
+        if (!id) {
+            LOG_ERROR(std::format("Watchdog: not watching {} ({})", keys_[i].resource().key, id.error()));
+            continue;
         }
+        handle_ids_.push_back(*id);
+    }
+    loop_.attach(reactor_, [this](WatchdogTrigger t, size_t k) { fire(t, k); });
+}
 
-        DWORD result = ::WaitForMultipleObjects(
-            2, wait_handles,
-            FALSE,                    // wait for ANY handle
-            kFallbackTimeoutMs);      // 60-second fallback
+void Watchdog::teardown()
+{
+    for (ReactorId id : handle_ids_) {
+        reactor_.remove(id);
+    }
+    handle_ids_.clear();
+    loop_.detach();
+    notifier_.reset();
+    snapshots_.clear();
+    trees_.clear();
+}
 
-        if (!running_.load(std::memory_order_acquire)) {
-            break; // stop() was called
-        }
+void Watchdog::on_notification(size_t key)
+{
+    // Notifications are one-shot: re-arm before anything else can change.
+    if (!notifier_->arm(key)) {
+        LOG_ERROR(std::format("Watchdog: no longer watching {}", keys_[key].resource().key));
+    }
+    loop_.notify(key);
+}
 
-        switch (result) {
-        case WAIT_OBJECT_0:
-            // stop_event_ signaled -- exit loop.
-            break;
-
-        case WAIT_OBJECT_0 + 1:
-            // Registry change detected.
-            LOG_INFO("Watchdog: registry change detected");
-            if (on_change_) {
-                on_change_();
-            }
-            break;
-
-        case WAIT_TIMEOUT:
-            // Periodic fallback fire.
-            LOG_DEBUG("Watchdog: fallback timeout -- re-checking");
-            if (on_change_) {
-                on_change_();
-            }
-            break;
-
-        default:
-            LOG_ERROR(std::format("Watchdog: WaitForMultipleObjects unexpected result ({})", result));
-            break;
+bool Watchdog::diff_change(size_t key)
+{
+    // Subtree notifications do not say what changed, so the diff is what
+    // narrows them down.
+    const auto& watched = keys_[key];
+    if (!snapshots_[key].captured()) {
+        snapshots_[key].capture(trees_[key]);
+        std::lock_guard lock(changes_mutex_);
+        changes_[key].reset();
+        return true;
+    }
+    auto diff = snapshots_[key].refresh(trees_[key]);
+    if (diff.empty()) {
+        noop_changes_.fetch_add(1, std::memory_order_relaxed);
+        LOG_DEBUG(std::format("Watchdog: change under {} rewrote identical data, ignoring",
+            watched.resource().key));
+        return false;
+    }
+    LOG_INFO(std::format("Watchdog: registry change under {}: {} value(s) changed, {} key(s) added, {} removed",
+        watched.resource().key, diff.values.size(), diff.added_keys.size(), diff.removed_keys.size()));
+    std::lock_guard lock(changes_mutex_);
+    if (changes_[key]) {
+        for (const auto& sub : diff.changed_keys()) {
+            std::wstring path = sub.empty() ? watched.path : watched.path + L"\\" + sub;
+            changes_[key]->push_back(ObservedResource::registry_key(watched.hive, path));
         }
     }
+    return true;
+}
 
-    ::CloseHandle(reg_event);
-    ::RegCloseKey(hkey);
-    running_.store(false, std::memory_order_release);
+void Watchdog::fire(WatchdogTrigger trigger, size_t key)
+{
+    if (trigger == WatchdogTrigger::RegistryChange) {
+        if (!diff_change(key)) {
+            return;
+        }
+    } else {
+        LOG_DEBUG(std::format("Watchdog: fallback poll (interval {}s) -- re-checking",
+            std::chrono::duration_cast<std::chrono::seconds>(loop_.poll().interval()).count()));
+    }
+    if (on_change_) {
+        on_change_(trigger, key);
+    }
 }
 
 } // namespace hdrfixer::fixes
@@ -1,40 +1,133 @@
 #pragma once
 #include <windows.h>
 #include <winreg.h>
-#include <thread>
 #include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "core/fixes/observed_resource.h"
+#include "core/fixes/reactor.h"
+#include "core/fixes/registry_snapshot.h"
+#include "core/fixes/watch_loop.h"
+#include "registry_notifier.h"
+#include "registry_tree.h"
 
 namespace hdrfixer::fixes {
 
-/// Background thread that monitors the GraphicsDrivers registry key for changes.
-/// When a change is detected (or a 60-second timeout elapses), calls the
-/// user-supplied callback.  Thread-safe start/stop via atomic flag.
+/// One registry key the watchdog observes.
+struct WatchedKey {
+    HKEY         root;            ///< HKEY_LOCAL_MACHINE or HKEY_CURRENT_USER
+    const wchar_t* hive;          ///< L"HKLM"/L"HKCU", as in ObservedResource keys
+    std::wstring path;
+    bool         subtree = true;  ///< also report changes to subkeys
+
+    /// The key as a change event for FixEngine::notify_changed()
+    ObservedResource resource() const { return ObservedResource::registry_key(hive, path); }
+};
+
+/// GraphicsDrivers (which covers MonitorDataStore), the HKCU DirectX GPU
+/// preferences and VideoSettings keys, and Direct3D under both hives.
+std::vector<WatchedKey> default_watched_keys();
+
+/// Monitors a set of registry keys for changes on a shared Reactor: every
+/// key's notification event is one reactor handle, and the scheduling
+/// lives in the portable WatchLoop, attached to the same reactor.  When a
+/// change is detected (or the fallback poll comes due), calls the
+/// user-supplied callback on the reactor thread.
+///
+/// The fallback poll is adaptive: the owner reports each check's outcome
+/// through report_check(), and polling stops entirely while paused.
+///
+/// Driver installs and mode switches change dozens of values in a burst;
+/// each key's raw notifications go through its own Debouncer, so a burst
+/// produces at most a leading and a trailing RegistryChange for that key
+/// and cannot mask changes to the others.
+///
+/// Each key's subtree is also kept as a RegistrySnapshot.  A coalesced
+/// change is diffed against it before the callback runs: rewrites of
+/// identical data never reach the callback, and real changes are queued
+/// as the precise subkeys for take_changes().
 class Watchdog {
 public:
-    /// Construct with a callback that will be invoked on every detected change.
-    explicit Watchdog(std::function<void()> on_change);
+    /// Callback arguments: the trigger and, for RegistryChange, the index
+    /// into keys() that fired (0 for Timeout).
+    using Callback = std::function<void(WatchdogTrigger, size_t key)>;
+
+    /// Construct with a callback that will be invoked on every (coalesced) change.
+    /// Keys that cannot be opened are skipped when the watchdog starts.
+    /// `reactor` must outlive the watchdog.
+    explicit Watchdog(Reactor& reactor,
+                      Callback on_change,
+                      std::vector<WatchedKey> keys = default_watched_keys(),
+                      DebounceConfig debounce = {},
+                      AdaptivePollConfig poll = {});
     ~Watchdog();
 
     Watchdog(const Watchdog&) = delete;
     Watchdog& operator=(const Watchdog&) = delete;
 
-    /// Start the background monitoring thread.  No-op if already running.
+    /// Open the keys and register them with the reactor.  No-op if already running.
     void start();
 
-    /// Signal the background thread to stop and join it.  No-op if not running.
+    /// Unregister from the reactor and close the keys.  No-op if not running.
     void stop();
 
-    /// Returns true if the watchdog thread is currently active.
+    /// Returns true while registered with the reactor.
     bool running() const noexcept { return running_.load(std::memory_order_relaxed); }
 
+    /// Outcome of the check a trigger caused: drift snaps the fallback poll
+    /// back to its minimum interval, a clean check backs it off.
+    void report_check(bool drift);
+
+    /// Stop fallback polling (session locked, display off).  Registry
+    /// notifications are still delivered.  Resuming polls right away,
+    /// since anything may have changed in the meantime.
+    void set_paused(bool paused);
+
+    std::chrono::milliseconds poll_interval() const { return loop_.poll().interval(); }
+
+    /// Immutable after construction, so safe to read from any thread.
+    const std::vector<WatchedKey>& keys() const noexcept { return keys_; }
+
+    /// Raw registry notifications vs. RegistryChange callbacks, summed over
+    /// all keys.  Safe from any thread.
+    DebounceStats debounce_stats() const { return loop_.debounce_stats(); }
+
+    /// Changed subkeys queued for `key` since the last call, as change
+    /// events for FixEngine::notify_changed().  nullopt if the change could
+    /// not be diffed (no snapshot), so the whole key must count as changed;
+    /// empty if an earlier call already took them.  Safe from any thread.
+    std::optional<std::vector<ObservedResource>> take_changes(size_t key);
+
+    /// Coalesced registry changes dropped because nothing actually changed.
+    uint64_t noop_changes() const noexcept { return noop_changes_.load(std::memory_order_relaxed); }
+
 private:
-    void thread_func();
+    // All on the reactor thread
+    void setup();
+    void teardown();
+    void on_notification(size_t key);
+    bool diff_change(size_t key);
+    void fire(WatchdogTrigger trigger, size_t key);
 
-    std::function<void()> on_change_;
+    Reactor&              reactor_;
+    Callback              on_change_;
+    std::vector<WatchedKey> keys_;
+    WatchLoop             loop_;
+    std::mutex            changes_mutex_;
+    /// Per key; nullopt once an undiffable change is pending
+    std::vector<std::optional<std::vector<ObservedResource>>> changes_;
+    std::atomic<uint64_t> noop_changes_{0};
     std::atomic<bool>     running_{false};
-    HANDLE                stop_event_{nullptr};
-    std::thread           thread_;
+
+    // Reactor thread only, between setup() and teardown()
+    std::unique_ptr<RegistryNotifier>   notifier_;
+    std::vector<Win32RegistryTree>      trees_;
+    std::vector<RegistrySnapshot>       snapshots_;
+    std::vector<ReactorId>              handle_ids_;
 };
 
 } // namespace hdrfixer::fixes
@@ -0,0 +1,66 @@
+#include "win32_reactor_backend.h"
+#include "core/log/logger.h"
+#include <algorithm>
+#include <format>
+#include <thread>
+
+namespace hdrfixer::fixes {
+
+Win32ReactorBackend::Win32ReactorBackend()
+{
+    wake_event_ = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!wake_event_) {
+        LOG_ERROR("Reactor: failed to create wake event");
+    }
+}
+
+Win32ReactorBackend::~Win32ReactorBackend()
+{
+    if (wake_event_) {
+        ::CloseHandle(wake_event_);
+    }
+}
+
+void Win32ReactorBackend::wait(const std::vector<ReactorHandle>& handles,
+                               std::optional<Clock::time_point> deadline,
+                               std::vector<size_t>& signaled)
+{
+    DWORD wait_ms = INFINITE;
+    if (deadline) {
+        auto ms = std::chrono::ceil<std::chrono::milliseconds>(*deadline - Clock::now()).count();
+        wait_ms = static_cast<DWORD>(std::clamp<long long>(ms, 0, INFINITE - 1));
+    }
+
+    wait_handles_.assign(1, wake_event_);
+    wait_handles_.insert(wait_handles_.end(), handles.begin(), handles.end());
+    DWORD result = ::WaitForMultipleObjects(
+        static_cast<DWORD>(wait_handles_.size()), wait_handles_.data(),
+        FALSE,                                            // wait for ANY handle
+        wait_ms);
+
+    if (result == WAIT_TIMEOUT || result == WAIT_OBJECT_0) {
+        return;   // deadline, or wake()
+    }
+    if (result > WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + wait_handles_.size()) {
+        // The wait reports only the lowest signaled handle.  Sweep the
+        // others too so a storm on one handle cannot starve the rest.
+        size_t first = result - WAIT_OBJECT_0 - 1;
+        for (size_t i = 0; i < handles.size(); ++i) {
+            if (i == first || ::WaitForSingleObject(handles[i], 0) == WAIT_OBJECT_0) {
+                signaled.push_back(i);
+            }
+        }
+        return;
+    }
+    // WAIT_FAILED (e.g. a handle closed before it was removed).  Back off
+    // instead of spinning on the same failure.
+    LOG_ERROR(std::format("Reactor: WaitForMultipleObjects unexpected result ({})", result));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+void Win32ReactorBackend::wake()
+{
+    ::SetEvent(wake_event_);
+}
+
+} // namespace hdrfixer::fixes
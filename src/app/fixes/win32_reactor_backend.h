@@ -0,0 +1,30 @@
+#pragma once
+#include <windows.h>
+#include "core/fixes/reactor.h"
+
+namespace hdrfixer::fixes {
+
+/// IReactorBackend over WaitForMultipleObjects.  One handle slot goes to
+/// the internal wake event, so a Reactor can multiplex up to
+/// MAXIMUM_WAIT_OBJECTS - 1 handles.
+class Win32ReactorBackend : public IReactorBackend {
+public:
+    Win32ReactorBackend();
+    ~Win32ReactorBackend() override;
+
+    Win32ReactorBackend(const Win32ReactorBackend&) = delete;
+    Win32ReactorBackend& operator=(const Win32ReactorBackend&) = delete;
+
+    Clock::time_point now() const override { return Clock::now(); }
+    size_t max_handles() const override { return MAXIMUM_WAIT_OBJECTS - 1; }
+    void wait(const std::vector<ReactorHandle>& handles,
+              std::optional<Clock::time_point> deadline,
+              std::vector<size_t>& signaled) override;
+    void wake() override;
+
+private:
+    HANDLE wake_event_{nullptr};   ///< auto-reset
+    std::vector<HANDLE> wait_handles_;
+};
+
+} // namespace hdrfixer::fixes
@@ -1,31 +1,70 @@
 #include "core/core.h"
 #include "core/display/dxgi_detector.h"
 #include "core/display/display_info.h"
+#include "core/display/display_identity.h"
+#include "core/display/display_topology.h"
 #include "core/config/settings.h"
 #include "core/log/logger.h"
+#include "core/registry/hdr_registry.h"
 
 #include "core/fixes/fix_engine.h"
+#include "core/fixes/worker_pool.h"
+#include "core/fixes/apply_journal.h"
+#include "core/fixes/fix_executor.h"
+#include "core/fixes/fix_plan.h"
+#include "core/fixes/reactor.h"
 #include "fixes/gamma_fix.h"
 #include "fixes/sdr_brightness_fix.h"
 #include "fixes/pixel_format_fix.h"
+#include "fixes/edid_validation_fix.h"
 #include "fixes/share_helper.h"
 #include "fixes/watchdog.h"
+#include "fixes/directory_watcher.h"
+#include "fixes/win32_reactor_backend.h"
 #include "fixes/hotplug.h"
+#include "fixes/session_monitor.h"
 
 #include "ui/tray.h"
 #include "ui/settings_wnd.h"
 
+#include <algorithm>
+#include <fstream>
 #include <memory>
+#include <optional>
+#include <thread>
 
 using namespace hdrfixer;
 
 // Global state
 static std::unique_ptr<fixes::FixEngine> g_engine;
+static std::unique_ptr<fixes::WorkerPool> g_fix_pool;
+static std::unique_ptr<fixes::ApplyJournal> g_journal;
+static std::unique_ptr<fixes::FixExecutor> g_executor;   // runs fixes off the UI thread
+static std::unique_ptr<fixes::Reactor> g_reactor;        // shared background event thread
 static std::unique_ptr<fixes::Watchdog> g_watchdog;
+static std::unique_ptr<fixes::DirectoryWatcher> g_profile_watcher;   // installed color profiles
 static std::unique_ptr<fixes::Hotplug> g_hotplug;
+static std::unique_ptr<fixes::SessionMonitor> g_session;
 static std::unique_ptr<ui::TrayIcon> g_tray;
 static config::SettingsManager g_settings;
-static std::vector<display::DisplayInfo> g_displays;
+static display::DisplayIdentityCache g_displays;
+static display::TopologySnapshot g_topology;    // display paths as of the last hotplug pass
+static display::QuirksDatabase g_quirks;
+static display::EdidValidationCache g_edid_cache;
+static bool g_exiting = false;   // set by Exit; messages still queued start no fix work
+
+// Upper bound on how long a watchdog-triggered diagnosis blocks the UI thread
+static constexpr auto kDiagnoseTimeout = std::chrono::milliseconds(2000);
+
+// Worker threads for fix work.  Fixed, so the thread count does not grow
+// with displays x fixes; a fix that gets no worker before a diagnosis
+// deadline is reported as such and retried on the next pass.
+static size_t fix_pool_threads() {
+    return std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 8);
+}
+
+// How often per-fix latency statistics are written to the log
+static constexpr auto kStatsDumpInterval = std::chrono::minutes(15);
 
 static std::string wide_to_utf8(const std::wstring& wide) {
     if (wide.empty()) return {};
@@ -36,72 +75,386 @@ static std::string wide_to_utf8(const std::wstring& wide) {
     return result;
 }
 
-static void refresh_displays() {
-    auto result = display::detect_displays();
+static void load_panel_quirks() {
+    wchar_t exe_path[MAX_PATH] = {};
+    GetModuleFileNameW(nullptr, exe_path, MAX_PATH);
+    auto path = std::filesystem::path(exe_path).parent_path() / L"panel_quirks.bin";
+
+    auto result = display::QuirksDatabase::open(path);
     if (result.has_value()) {
-        g_displays = std::move(result.value());
-        LOG_INFO(std::format("Detected {} display(s)", g_displays.size()));
-        for (const auto& d : g_displays) {
-            LOG_INFO(std::format("  {} - HDR:{} {}bpc MaxLum:{:.0f}nits SDRWhite:{:.0f}nits",
-                wide_to_utf8(d.device_name),
-                d.is_hdr_enabled ? "ON" : "OFF",
-                d.bits_per_color,
-                d.max_luminance,
-                d.sdr_white_level_nits));
-        }
+        g_quirks = std::move(result.value());
+        LOG_INFO(std::format("Loaded {} panel quirk(s)", g_quirks.size()));
     } else {
+        LOG_WARN(std::format("Panel quirks unavailable: {}", result.error()));
+    }
+}
+
+static display::DisplayChanges refresh_displays() {
+    auto result = display::detect_displays();
+    if (!result.has_value()) {
         LOG_ERROR(std::format("Display detection failed: {}", result.error()));
+        return {};
+    }
+
+    auto& detected = result.value();
+    LOG_INFO(std::format("Detected {} display(s)", detected.size()));
+    size_t quirked = display::apply_panel_quirks(detected, g_quirks);
+    if (quirked > 0) {
+        LOG_INFO(std::format("Applied panel quirks to {} display(s)", quirked));
+    }
+    for (const auto& d : detected) {
+        LOG_INFO(std::format("  {} - HDR:{} {}bpc MaxLum:{:.0f}nits SDRWhite:{:.0f}nits",
+            wide_to_utf8(d.device_name),
+            d.is_hdr_enabled ? "ON" : "OFF",
+            d.bits_per_color,
+            d.max_luminance,
+            d.sdr_white_level_nits));
     }
+    return g_displays.update(std::move(detected));
+}
+
+static void register_fix(std::unique_ptr<fixes::IFix> fix, uint64_t owner = 0) {
+    auto result = g_engine->register_fix(std::move(fix), owner);
+    if (!result.has_value()) {
+        LOG_ERROR(std::format("Fix registration failed: {}", result.error()));
+    }
+}
+
+// Fix-set changes made by sync_display_fixes()
+struct FixSetChanges {
+    std::vector<uint64_t> registered;   // owners whose fix set was (re)created
+    size_t removed = 0;                 // owners whose fix set was dropped
+
+    bool empty() const { return registered.empty() && removed == 0; }
+};
+
+// Each HDR-capable display gets its own fix set, owned by its fingerprint.
+// Sets are created lazily, the first time a display is seen HDR-capable,
+// and dropped when it disconnects; displays without HDR get none.  Sets of
+// `rebuild` displays are recreated, since fixes keep a copy of the
+// DisplayInfo they were made for.  Independent owners share no dependency
+// edges, so the engine's parallel and async applies fix all displays
+// concurrently.
+static FixSetChanges sync_display_fixes(const std::vector<uint64_t>& rebuild = {}) {
+    auto fingerprints = g_displays.fingerprints();
+    FixSetChanges changes;
+
+    for (uint64_t owner : g_engine->owners()) {
+        if (owner == 0) continue;
+        const auto* display = g_displays.find(owner);
+        bool keep = display && display->is_hdr_capable();
+        if (keep && std::ranges::find(rebuild, owner) != rebuild.end()) {
+            g_engine->remove_fixes(owner);   // re-registered below
+            continue;
+        }
+        if (keep) continue;
+        g_engine->remove_fixes(owner);
+        ++changes.removed;
+    }
+
+    for (uint64_t fp : fingerprints) {
+        if (g_engine->has_fixes(fp)) continue;
+        const auto& display = *g_displays.find(fp);
+        if (!display.is_hdr_capable()) continue;
+
+        register_fix(std::make_unique<fixes::GammaFix>(display), fp);
+        register_fix(std::make_unique<fixes::SdrBrightnessFix>(display), fp);
+        register_fix(std::make_unique<fixes::PixelFormatFix>(display), fp);
+        register_fix(std::make_unique<fixes::EdidValidationFix>(display, g_edid_cache), fp);
+        LOG_INFO(std::format("Registered display fixes for {}", wide_to_utf8(display.device_name)));
+        changes.registered.push_back(fp);
+    }
+
+    if (!changes.empty() && !std::ranges::any_of(g_engine->owners(), [](uint64_t o) { return o != 0; })) {
+        LOG_WARN("No HDR-capable displays detected, no display fixes registered");
+    }
+    return changes;
 }
 
 static void build_fix_engine() {
     g_engine = std::make_unique<fixes::FixEngine>();
 
-    if (g_displays.empty()) {
-        LOG_WARN("No displays detected, fix engine will be empty");
-        return;
+    sync_display_fixes();
+    register_fix(std::make_unique<fixes::ShareHelper>());
+
+    LOG_INFO(std::format("Fix engine initialized with {} fixes", g_engine->fix_count()));
+}
+
+// Log each display's fix statuses and summarize them in the tray tooltip.
+// Only stale fixes are re-diagnosed, so this is cheap right after a
+// watchdog pass.
+static void report_display_status() {
+    if (g_exiting) return;
+    g_engine->diagnose_dirty(*g_fix_pool, kDiagnoseTimeout);
+
+    size_t displays = 0;
+    size_t healthy = 0;
+    for (uint64_t owner : g_engine->owners()) {
+        if (owner == 0) continue;
+        const auto* display = g_displays.find(owner);
+        std::string name = display ? wide_to_utf8(display->device_name) : std::format("{:016x}", owner);
+
+        size_t ok = 0, failed = 0;
+        for (const auto& fix : g_engine->report(owner)) {
+            bool fixed = fix.status && (fix.status->state == fixes::FixState::Applied ||
+                                        fix.status->state == fixes::FixState::NotNeeded);
+            if (fixed) {
+                ++ok;
+            } else {
+                ++failed;
+                bool warning = fix.status && fix.status->state == fixes::FixState::Warning;
+                LOG_WARN(std::format("  {}: {} {}{}", name, fix.name, warning ? "reports a problem" : "not applied",
+                    fix.status && !fix.status->message.empty() ? " - " + fix.status->message : ""));
+            }
+        }
+        LOG_INFO(std::format("Display {}: {} of {} fixes OK", name, ok, ok + failed));
+        ++displays;
+        if (failed == 0) ++healthy;
     }
 
-    // Register fixes for the primary display
-    auto& primary = g_displays[0];
-    g_engine->register_fix(std::make_unique<fixes::GammaFix>(primary));
-    g_engine->register_fix(std::make_unique<fixes::SdrBrightnessFix>(primary));
-    g_engine->register_fix(std::make_unique<fixes::PixelFormatFix>(primary));
-    g_engine->register_fix(std::make_unique<fixes::ShareHelper>());
+    if (g_tray) {
+        auto tooltip = std::format(L"HDRFixer v2.0 - {} of {} HDR display(s) fixed", healthy, displays);
+        g_tray->set_tooltip(tooltip.c_str());
+    }
+}
 
-    LOG_INFO(std::format("Fix engine initialized with {} fixes", g_engine->fix_count()));
+// Transactional apply for user-visible entry points; returns false (after
+// rolling back) if any fix failed
+static bool apply_all_journaled() {
+    auto result = g_engine->apply_all(*g_journal);
+    if (!result.has_value()) {
+        LOG_ERROR(std::format("Apply failed: {}", result.error()));
+        return false;
+    }
+    return true;
+}
+
+static void dump_fix_stats() {
+    if (g_watchdog) {
+        auto d = g_watchdog->debounce_stats();
+        LOG_INFO(std::format("Watchdog: {} registry notification(s) coalesced into {} trigger(s), {} suppressed, "
+            "{} no-op rewrite(s) dropped", d.events, d.fired, d.suppressed, g_watchdog->noop_changes()));
+    }
+    if (g_reactor) {
+        auto r = g_reactor->stats();
+        static constexpr const char* kNames[] = {"high", "normal", "low"};
+        for (size_t p = 0; p < fixes::kReactorPriorities; ++p) {
+            const auto& s = r.priorities[p];
+            if (s.dispatched == 0) continue;
+            LOG_INFO(std::format("Reactor: {} {} handler(s), mean latency {}us, max {}us, {} promoted",
+                s.dispatched, kNames[p], s.total_latency.count() / static_cast<int64_t>(s.dispatched),
+                s.max_latency.count(), s.promoted));
+        }
+    }
+    auto lines = fixes::format_stats(g_engine->stats());
+    if (lines.empty()) return;
+    LOG_INFO("Fix latency statistics:");
+    for (const auto& line : lines) {
+        LOG_INFO("  " + line);
+    }
 }
 
-// Called on the MAIN THREAD via WM_WATCHDOG_TRIGGER posted from the watchdog bg thread.
-static void on_watchdog_trigger_main_thread() {
-    if (!g_engine) return;
-    LOG_INFO("Watchdog triggered, diagnosing fixes...");
-    auto statuses = g_engine->diagnose_all();
+// Re-diagnose the stale fixes and re-apply if any drifted
+static void recheck_fixes(const char* cause) {
+    LOG_INFO(std::format("{}, diagnosing {} of {} fixes...",
+        cause, g_engine->dirty_count(), g_engine->fix_count()));
+    auto statuses = g_engine->diagnose_dirty(*g_fix_pool, kDiagnoseTimeout);
     for (const auto& s : statuses) {
-        if (s.state == fixes::FixState::NotApplied) {
-            LOG_INFO("Re-applying fixes due to detected changes");
-            g_engine->apply_all();
+        if (s.state == fixes::FixState::Error || s.state == fixes::FixState::Warning) {
+            LOG_WARN(s.message);
+        }
+    }
+
+    // Quiet checks stretch the fallback poll; drift snaps it back.  Fixes
+    // that stay NotApplied after a successful apply are not drift, or every
+    // check would re-apply them.
+    size_t drifted = g_engine->drift_count();
+    if (g_watchdog) {
+        g_watchdog->report_check(drifted > 0);
+        LOG_DEBUG(std::format("Watchdog: next fallback poll in {}s",
+            std::chrono::duration_cast<std::chrono::seconds>(g_watchdog->poll_interval()).count()));
+    }
+
+    if (drifted > 0) {
+        LOG_INFO(std::format("Re-applying fixes, {} drifted after a system change", drifted));
+        g_engine->apply_all_async(*g_executor, [] {
+            report_display_status();
             if (g_tray) {
                 g_tray->show_balloon(L"HDRFixer", L"Fixes re-applied after system change");
             }
-            break;
+        });
+        return;
+    }
+    report_display_status();
+}
+
+// Called on the MAIN THREAD via WM_WATCHDOG_TRIGGER posted from the reactor thread;
+// wParam carries the fixes::WatchdogTrigger, lParam the index of the watched key.
+static void on_watchdog_trigger_main_thread(WPARAM wParam, LPARAM lParam) {
+    if (!g_engine || g_exiting) return;
+
+    // A registry change only dirties the fixes observing the subkeys the
+    // watchdog's snapshot diff found changed (or, without a diff, the whole
+    // subtree that fired); the periodic fallback re-checks everything.
+    auto key = static_cast<size_t>(lParam);
+    if (static_cast<fixes::WatchdogTrigger>(wParam) == fixes::WatchdogTrigger::RegistryChange &&
+        g_watchdog && key < g_watchdog->keys().size()) {
+        auto changes = g_watchdog->take_changes(key);
+        if (!changes) {
+            changes.emplace(1, g_watchdog->keys()[key].resource());
         }
+        for (const auto& changed : *changes) {
+            LOG_INFO("Registry change under " + changed.key);
+            g_engine->notify_changed(changed);
+        }
+    } else {
+        g_engine->mark_all_dirty();
     }
+    recheck_fixes("Watchdog triggered");
+}
+
+// Called on the MAIN THREAD via WM_RUN_TASK when a watched directory
+// changed; only fixes observing files in it are re-diagnosed.
+static void on_file_change(const fixes::ObservedResource& changed) {
+    if (!g_engine || g_exiting) return;
+    g_engine->notify_changed(changed);
+    if (g_engine->dirty_count() == 0) return;   // nothing observes it
+    LOG_INFO("File change under " + changed.key);
+    recheck_fixes("File change");
+}
+
+// Nobody sees the displays while the session is locked or the screen is
+// off, so the watchdog stops its fallback polling until they come back.
+static void on_session_change(UINT msg, WPARAM wParam, LPARAM lParam) {
+    if (!g_session || !g_session->handle_message(msg, wParam, lParam)) return;
+    bool active = g_session->active();
+    LOG_INFO(active ? "Session active, resuming watchdog polling"
+                    : "Session locked or display off, pausing watchdog polling");
+    if (g_watchdog) g_watchdog->set_paused(!active);
 }
 
 static void on_display_change() {
-    LOG_INFO("Display change detected, refreshing...");
+    if (g_exiting) return;
+    // KVM switches and docks deliver bursts of arrival/removal events.  A
+    // cheap topology probe is diffed against the last one, so nothing is
+    // touched unless a display was added, removed or reconfigured, DXGI is
+    // only re-enumerated for new displays, and only the affected displays'
+    // fixes are rebuilt and applied.
+    auto probe = display::probe_topology();
+    std::vector<uint64_t> reconfigured;
+    if (!probe.has_value()) {
+        LOG_WARN(std::format("Display change: topology probe failed ({}), re-detecting", probe.error()));
+        refresh_displays();
+        reconfigured = g_displays.fingerprints();
+        g_topology = {};
+    } else {
+        auto diff = g_topology.diff(probe.value());
+        if (diff.empty()) {
+            LOG_INFO("Display change: topology unchanged, skipping refresh");
+            return;
+        }
+        LOG_INFO(std::format("Display change: {} added, {} removed, {} reconfigured",
+            diff.added.size(), diff.removed.size(), diff.changed.size()));
+
+        if (diff.added.empty()) {
+            // The remaining displays' detected info is still valid
+            g_displays.retain(probe->fingerprints());
+        } else {
+            refresh_displays();
+            // Known after all if the previous probe failed
+            reconfigured = diff.added;
+        }
+        for (const auto& changed : diff.changed) {
+            // Fixes observing the target, at its old and its new address
+            for (const auto* target : {g_topology.find(changed.fingerprint), probe->find(changed.fingerprint)}) {
+                if (target && g_engine) {
+                    g_engine->notify_changed(fixes::ObservedResource::display_target(
+                        display::luid_key(target->adapter_id), target->target_id));
+                }
+            }
+            if (g_displays.update_state(*probe->find(changed.fingerprint))) {
+                reconfigured.push_back(changed.fingerprint);
+            }
+        }
+        g_topology = std::move(probe.value());
+    }
+
+    if (!g_engine) build_fix_engine();
+    auto changes = sync_display_fixes(reconfigured);
+    if (changes.empty()) {
+        // Fixes that stayed registered may still observe a changed target
+        if (g_engine->dirty_count() > 0) report_display_status();
+        return;
+    }
+
+    auto notify = [] {
+        report_display_status();
+        if (g_tray) {
+            g_tray->show_balloon(L"HDRFixer", L"Display configuration changed, fixes updated");
+        }
+    };
+    if (g_settings.get().enable_fix_watchdog && !changes.registered.empty()) {
+        g_engine->apply_async(*g_executor, changes.registered, notify);
+    } else {
+        notify();
+    }
+}
+
+// `--plan [file]` selects audit mode; the plan goes next to the settings
+// unless a file is given
+static std::optional<std::filesystem::path> plan_output_path(std::wstring_view cmd) {
+    auto pos = cmd.find(L"--plan");
+    if (pos == std::wstring_view::npos) return std::nullopt;
+    auto rest = cmd.substr(pos + 6);
+    while (!rest.empty() && (rest.front() == L' ' || rest.front() == L'"')) rest.remove_prefix(1);
+    while (!rest.empty() && (rest.back() == L' ' || rest.back() == L'"')) rest.remove_suffix(1);
+    if (rest.empty()) return config::SettingsManager::settings_path().parent_path() / L"plan.txt";
+    return std::filesystem::path(rest);
+}
+
+// Audit mode: diagnose every fix and write the actions a startup apply
+// would take, with their predicted effects, without changing anything
+static int run_plan_audit(const std::filesystem::path& out) {
+    load_panel_quirks();
     refresh_displays();
     build_fix_engine();
-    if (g_settings.get().enable_fix_watchdog) {
-        g_engine->apply_all();
+
+    fixes::WorkerPool pool(std::max<size_t>(1, g_engine->fix_count()));
+    auto plan = g_engine->plan(pool, kDiagnoseTimeout);
+    for (const auto& action : plan.actions) {
+        LOG_INFO(std::format("Plan: apply {} [{:016x}] ({})", action.name, action.owner, action.status.message));
+        for (const auto& effect : action.effects) {
+            LOG_INFO(std::format("  {}: {}", effect.target.key, effect.change));
+        }
     }
-    if (g_tray) {
-        g_tray->show_balloon(L"HDRFixer", L"Display configuration changed, fixes updated");
+    for (const auto& fix : plan.undiagnosed) {
+        LOG_WARN(std::format("Plan: {} [{:016x}] could not be diagnosed", fix.name, fix.owner));
     }
+
+    std::error_code ec;
+    std::filesystem::create_directories(out.parent_path(), ec);
+    std::ofstream file(out, std::ios::binary | std::ios::trunc);
+    file << fixes::serialize_plan(plan);
+    file.close();
+    g_engine.reset();
+    if (file.fail()) {
+        LOG_ERROR("Failed to write plan to " + out.string());
+        return 1;
+    }
+    LOG_INFO(std::format("Plan with {} action(s) written to {}", plan.actions.size(), out.string()));
+    return 0;
 }
 
-int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
+int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR lpCmdLine, int) {
+    // Audit mode is read-only, so it may run next to a live instance
+    if (auto plan_path = plan_output_path(lpCmdLine ? lpCmdLine : L"")) {
+        CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+        (void)g_settings.load();
+        int result = run_plan_audit(*plan_path);
+        CoUninitialize();
+        return result;
+    }
+
     // Prevent multiple instances
     HANDLE hMutex = CreateMutexW(nullptr, TRUE, L"HDRFixerSingletonV2");
     if (GetLastError() == ERROR_ALREADY_EXISTS) {
@@ -118,55 +471,97 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
     // Initialize logger
     LOG_INFO("HDRFixer v2.0.0 starting");
 
-    // Detect displays
+    // Detect displays; the topology is the baseline for hotplug diffs
+    load_panel_quirks();
+    g_topology = display::probe_topology().value_or(display::TopologySnapshot{});
     refresh_displays();
 
-    // Build fix engine
     build_fix_engine();
+    g_fix_pool = std::make_unique<fixes::WorkerPool>(fix_pool_threads());
+
+    // A journal left behind means the last apply was interrupted mid-way;
+    // undo its partial changes before applying anything new
+    g_journal = std::make_unique<fixes::ApplyJournal>(
+        config::SettingsManager::settings_path().parent_path() / L"apply.journal");
+    auto recovered = g_engine->recover(*g_journal);
+    if (!recovered.has_value()) {
+        LOG_ERROR(std::format("Apply journal recovery failed: {}", recovered.error()));
+    } else if (recovered.value() > 0) {
+        LOG_WARN(std::format("Rolled back {} fix(es) from an interrupted apply", recovered.value()));
+    }
 
     // Create tray icon
     ui::TrayCallbacks callbacks{};
     callbacks.on_apply_all = [] {
         if (g_engine) {
-            g_engine->apply_all();
-            if (g_tray) g_tray->show_balloon(L"HDRFixer", L"All fixes applied");
+            // User-initiated: don't trust statuses cached before the click
+            g_engine->mark_all_dirty();
+            g_engine->apply_all_async(*g_executor, *g_journal, [](const std::expected<void, std::string>& result) {
+                if (!result.has_value()) {
+                    LOG_ERROR(std::format("Apply failed: {}", result.error()));
+                }
+                report_display_status();
+                if (g_tray) {
+                    g_tray->show_balloon(L"HDRFixer",
+                        result.has_value() ? L"All fixes applied" : L"A fix failed, changes rolled back");
+                }
+            });
         }
     };
     callbacks.on_revert_all = [] {
         if (g_engine) {
-            g_engine->revert_all();
-            if (g_tray) g_tray->show_balloon(L"HDRFixer", L"All fixes reverted");
+            g_engine->mark_all_dirty();
+            g_engine->revert_all_async(*g_executor, [] {
+                if (g_tray) g_tray->show_balloon(L"HDRFixer", L"All fixes reverted");
+            });
         }
     };
     callbacks.on_share_mode = [] {
         if (!g_engine) return;
-        auto* share = dynamic_cast<fixes::ShareHelper*>(g_engine->get_fix("Screen Share Helper"));
-        if (share) {
-            auto status = share->diagnose();
-            if (status.state == fixes::FixState::Applied) {
-                share->revert();
-                if (g_tray) {
-                    g_tray->set_share_mode(false);
-                    g_tray->show_balloon(L"HDRFixer", L"Share mode OFF - SDR brightness restored");
+        g_engine->toggle_async(*g_executor, fixes::ShareHelper::kId, 0,
+            [](const std::optional<fixes::FixEngine::ToggleResult>& toggled) {
+                if (!toggled) {
+                    LOG_WARN("Share mode is busy, toggle ignored");
+                    return;
                 }
-            } else {
-                share->apply();
+                if (!toggled->result.success) {
+                    LOG_ERROR("Share mode toggle failed: " + toggled->result.message);
+                    if (g_tray) g_tray->show_balloon(L"HDRFixer", L"Share mode could not be changed");
+                    return;
+                }
+                bool on = toggled->op == fixes::PlanOp::Apply;
                 if (g_tray) {
-                    g_tray->set_share_mode(true);
-                    g_tray->show_balloon(L"HDRFixer", L"Share mode ON - SDR brightness set to 80 nits");
+                    g_tray->set_share_mode(on);
+                    g_tray->show_balloon(L"HDRFixer", on ? L"Share mode ON - SDR brightness set to 80 nits"
+                                                         : L"Share mode OFF - SDR brightness restored");
                 }
-            }
-        }
+            });
     };
     callbacks.on_settings = [&hInstance] {
         ui::show_settings_window(nullptr);
     };
     callbacks.on_exit = [] {
-        if (g_engine) g_engine->revert_all();
+        // Queued fix work (an async apply, say) must not run after the final
+        // revert: drop it and let what is already running finish first
+        g_exiting = true;
+        if (g_fix_pool) {
+            size_t dropped = g_fix_pool->cancel();
+            if (dropped > 0) LOG_INFO(std::format("Exit: dropped {} queued fix tasks", dropped));
+            if (g_fix_pool->wait_idle(kDiagnoseTimeout)) {
+                if (g_engine) g_engine->abandon_async();
+            } else {
+                LOG_WARN("Exit: fix work still running, not reverting the fixes it holds");
+            }
+        }
+        if (g_engine) {
+            g_engine->mark_all_dirty();
+            g_engine->revert_all();
+        }
         PostQuitMessage(0);
     };
     callbacks.on_watchdog_trigger = on_watchdog_trigger_main_thread;
     callbacks.on_display_change = on_display_change;
+    callbacks.on_session_change = on_session_change;
 
     g_tray = std::make_unique<ui::TrayIcon>(hInstance, callbacks);
     if (!g_tray->create()) {
@@ -177,27 +572,58 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
         return 1;
     }
 
+    // Worker completions come back to the UI thread as WM_RUN_TASK.  Capture
+    // the HWND, not g_tray: workers may still post during shutdown.
+    HWND ui_hwnd = g_tray->hwnd();
+    g_executor = std::make_unique<fixes::FixExecutor>(*g_fix_pool, [ui_hwnd](std::function<void()> task) {
+        ui::TrayIcon::post_task(ui_hwnd, std::move(task));
+    });
+
     // Register for display hotplug
     g_hotplug = std::make_unique<fixes::Hotplug>();
     g_hotplug->register_hotplug(g_tray->hwnd());
 
+    // The shared background event thread; the watchdog and other change
+    // sources register with it
+    g_reactor = std::make_unique<fixes::Reactor>(std::make_unique<fixes::Win32ReactorBackend>());
+    g_reactor->start();
+    // Engine state belongs to the UI thread, so the timer only posts there
+    g_reactor->add_timer(kStatsDumpInterval, [ui_hwnd] {
+        ui::TrayIcon::post_task(ui_hwnd, [] {
+            if (g_engine) dump_fix_stats();
+        });
+    }, fixes::ReactorPriority::Low, kStatsDumpInterval);
+
     // Start watchdog — callback posts to main thread to avoid data races
     if (g_settings.get().enable_fix_watchdog) {
         HWND tray_hwnd = g_tray->hwnd();
-        g_watchdog = std::make_unique<fixes::Watchdog>([tray_hwnd] {
-            PostMessage(tray_hwnd, ui::WM_WATCHDOG_TRIGGER, 0, 0);
-        });
+        fixes::DebounceConfig debounce;
+        debounce.window = std::chrono::milliseconds(g_settings.get().watchdog_coalesce_ms);
+        debounce.max_latency = std::chrono::milliseconds(g_settings.get().watchdog_max_latency_ms);
+        g_watchdog = std::make_unique<fixes::Watchdog>(*g_reactor, [tray_hwnd](fixes::WatchdogTrigger trigger, size_t key) {
+            PostMessage(tray_hwnd, ui::WM_WATCHDOG_TRIGGER, static_cast<WPARAM>(trigger), static_cast<LPARAM>(key));
+        }, fixes::default_watched_keys(), debounce);
         g_watchdog->start();
         LOG_INFO("Registry watchdog started");
+
+        // Gamma profiles are files, which no registry key reports on
+        g_profile_watcher = std::make_unique<fixes::DirectoryWatcher>(*g_reactor,
+            fixes::GammaFix::color_directory(), [ui_hwnd](const fixes::ObservedResource& changed) {
+                ui::TrayIcon::post_task(ui_hwnd, [changed] { on_file_change(changed); });
+            });
+        g_profile_watcher->start();
     }
 
+    // Register for session lock and display on/off; pauses watchdog polling
+    g_session = std::make_unique<fixes::SessionMonitor>();
+    g_session->register_session(g_tray->hwnd());
+
     // Auto-apply fixes on startup
-    if (g_engine && !g_displays.empty()) {
-        g_engine->apply_all();
+    if (g_engine && !g_displays.empty() && apply_all_journaled()) {
         LOG_INFO("Startup fixes applied");
     }
 
-    g_tray->set_tooltip(L"HDRFixer v2.0 - Active");
+    report_display_status();
     LOG_INFO("HDRFixer ready, entering message loop");
 
     // Message loop
@@ -209,10 +635,22 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
 
     // Cleanup
     LOG_INFO("HDRFixer shutting down");
+    g_exiting = true;
+    if (g_fix_pool) g_fix_pool->cancel();   // whatever Exit did not already drop
     if (g_watchdog) g_watchdog->stop();
+    if (g_profile_watcher) g_profile_watcher->stop();
+    if (g_reactor) g_reactor->stop();
     g_hotplug.reset();
+    g_session.reset();
     g_tray.reset();
+    if (g_engine) dump_fix_stats();
+    g_watchdog.reset();
+    g_profile_watcher.reset();
+    g_reactor.reset();
     g_engine.reset();
+    g_executor.reset();
+    g_fix_pool.reset();
+    g_journal.reset();
 
     (void)g_settings.save();
     CoUninitialize();
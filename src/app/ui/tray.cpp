@@ -1,6 +1,7 @@
 #include "app/ui/tray.h"
 #include <shellapi.h>
 #include <dbt.h>
+#include <memory>
 
 namespace hdrfixer::ui {
 
@@ -35,14 +36,15 @@ bool TrayIcon::create() {
     wc.lpszClassName = WNDCLASS_NAME;
     RegisterClassExW(&wc);
 
-    // Create an invisible message-only window
+    // Create a hidden top-level window.  Not message-only: those never
+    // receive broadcasts such as WM_DISPLAYCHANGE and TaskbarCreated.
     hwnd_ = CreateWindowExW(
-        0,
+        WS_EX_TOOLWINDOW,   // no taskbar button
         WNDCLASS_NAME,
         L"HDRFixer",
-        WS_POPUP,          // invisible popup
+        WS_POPUP,           // never shown
         0, 0, 0, 0,
-        HWND_MESSAGE,       // message-only window
+        nullptr,
         nullptr,
         hinstance_,
         nullptr
@@ -221,10 +223,17 @@ LRESULT CALLBACK TrayIcon::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lP
     // C2 fix: watchdog posts to main thread instead of calling directly
     case WM_WATCHDOG_TRIGGER:
         if (self && self->callbacks_.on_watchdog_trigger) {
-            self->callbacks_.on_watchdog_trigger();
+            self->callbacks_.on_watchdog_trigger(wParam, lParam);
         }
         return 0;
 
+    // Completions posted from worker threads via post_task()
+    case WM_RUN_TASK: {
+        std::unique_ptr<std::function<void()>> task(reinterpret_cast<std::function<void()>*>(lParam));
+        if (task && *task) (*task)();
+        return 0;
+    }
+
     // C3 fix: handle display hotplug notifications
     case WM_DEVICECHANGE:
         if (self && self->callbacks_.on_display_change) {
@@ -234,6 +243,22 @@ LRESULT CALLBACK TrayIcon::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lP
         }
         return 0;
 
+    // Desktop resolution, refresh rate or monitor layout changed; sent to
+    // top-level windows only.  The topology diff finds out what changed.
+    case WM_DISPLAYCHANGE:
+        if (self && self->callbacks_.on_display_change) {
+            self->callbacks_.on_display_change();
+        }
+        return 0;
+
+    // Session lock/unlock and display on/off pause the watchdog's polling
+    case WM_WTSSESSION_CHANGE:
+    case WM_POWERBROADCAST:
+        if (self && self->callbacks_.on_session_change) {
+            self->callbacks_.on_session_change(msg, wParam, lParam);
+        }
+        return msg == WM_POWERBROADCAST ? TRUE : 0;
+
     case WM_DESTROY:
         // Do NOT PostQuitMessage here — on_exit callback handles it
         return 0;
@@ -245,6 +270,15 @@ LRESULT CALLBACK TrayIcon::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lP
     return DefWindowProcW(hwnd, msg, wParam, lParam);
 }
 
+bool TrayIcon::post_task(HWND hwnd, std::function<void()> task) {
+    auto heap = std::make_unique<std::function<void()>>(std::move(task));
+    if (!PostMessage(hwnd, WM_RUN_TASK, 0, reinterpret_cast<LPARAM>(heap.get()))) {
+        return false;
+    }
+    heap.release();   // owned by the message now
+    return true;
+}
+
 // ---------------------------------------------------------------------------
 // show_context_menu()
 // ---------------------------------------------------------------------------
@@ -18,6 +18,7 @@ constexpr int HOTKEY_SHARE = 2;    // Ctrl+Shift+S
 // Custom window messages
 constexpr UINT WM_WATCHDOG_TRIGGER = WM_APP + 2;
 constexpr UINT WM_DISPLAY_CHANGE = WM_APP + 3;
+constexpr UINT WM_RUN_TASK = WM_APP + 4;   // lParam: heap std::function<void()>*
 
 struct TrayCallbacks {
     std::function<void()> on_apply_all;
@@ -25,8 +26,9 @@ struct TrayCallbacks {
     std::function<void()> on_share_mode;
     std::function<void()> on_settings;
     std::function<void()> on_exit;
-    std::function<void()> on_watchdog_trigger;
+    std::function<void(WPARAM, LPARAM)> on_watchdog_trigger;   // WM_WATCHDOG_TRIGGER wParam/lParam
     std::function<void()> on_display_change;
+    std::function<void(UINT, WPARAM, LPARAM)> on_session_change;   // WM_WTSSESSION_CHANGE / WM_POWERBROADCAST
 };
 
 class TrayIcon {
@@ -42,6 +44,10 @@ public:
 
     HWND hwnd() const { return hwnd_; }
 
+    // Queue `task` to run on the thread that owns `hwnd`.  Safe to call from
+    // any thread; returns false (dropping the task) if the window is gone.
+    static bool post_task(HWND hwnd, std::function<void()> task);
+
 private:
     static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
     void show_context_menu();
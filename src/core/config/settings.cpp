@@ -1,6 +1,7 @@
 #include "core/config/settings.h"
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 #include <filesystem>
 #include <windows.h>
 #include <shlobj.h>
@@ -81,6 +82,8 @@ std::string SettingsManager::serialize() const {
     ss << "run_at_startup=" << (settings_.run_at_startup ? "true" : "false") << "\n";
     ss << "minimize_to_tray=" << (settings_.minimize_to_tray ? "true" : "false") << "\n";
     ss << "enable_fix_watchdog=" << (settings_.enable_fix_watchdog ? "true" : "false") << "\n";
+    ss << "watchdog_coalesce_ms=" << settings_.watchdog_coalesce_ms << "\n";
+    ss << "watchdog_max_latency_ms=" << settings_.watchdog_max_latency_ms << "\n";
     ss << "preferred_sdr_brightness_nits=" << settings_.preferred_sdr_brightness_nits << "\n";
     ss << "oled_pixel_shift_enabled=" << (settings_.oled_pixel_shift_enabled ? "true" : "false") << "\n";
     ss << "oled_static_content_timeout_minutes=" << settings_.oled_static_content_timeout_minutes << "\n";
@@ -141,6 +144,18 @@ void SettingsManager::deserialize(const std::string& data) {
             settings_.minimize_to_tray = parse_bool(value);
         } else if (key == "enable_fix_watchdog") {
             settings_.enable_fix_watchdog = parse_bool(value);
+        } else if (key == "watchdog_coalesce_ms") {
+            try {
+                settings_.watchdog_coalesce_ms = std::stoi(value);
+            } catch (...) {
+                // Keep default on parse failure
+            }
+        } else if (key == "watchdog_max_latency_ms") {
+            try {
+                settings_.watchdog_max_latency_ms = std::stoi(value);
+            } catch (...) {
+                // Keep default on parse failure
+            }
         } else if (key == "preferred_sdr_brightness_nits") {
             try {
                 settings_.preferred_sdr_brightness_nits = std::stof(value);
@@ -162,6 +177,13 @@ void SettingsManager::deserialize(const std::string& data) {
             }
         }
     }
+
+    // A zero or negative window would spin the watchdog, and a latency
+    // bound below the window would end every burst before it coalesced
+    settings_.watchdog_coalesce_ms = std::clamp(settings_.watchdog_coalesce_ms,
+                                                kMinWatchdogCoalesceMs, kMaxWatchdogCoalesceMs);
+    settings_.watchdog_max_latency_ms = std::clamp(settings_.watchdog_max_latency_ms,
+                                                   settings_.watchdog_coalesce_ms, kMaxWatchdogLatencyMs);
 }
 
 } // namespace hdrfixer::config
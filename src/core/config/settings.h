@@ -6,10 +6,18 @@
 
 namespace hdrfixer::config {
 
+// Bounds deserialize() clamps the watchdog timings to; the max latency is
+// also raised to at least the coalesce window.
+inline constexpr int kMinWatchdogCoalesceMs = 10;
+inline constexpr int kMaxWatchdogCoalesceMs = 60'000;
+inline constexpr int kMaxWatchdogLatencyMs = 600'000;
+
 struct AppSettings {
     bool run_at_startup = false;
     bool minimize_to_tray = true;
     bool enable_fix_watchdog = true;
+    int watchdog_coalesce_ms = 250;       // quiet period that ends a registry change burst
+    int watchdog_max_latency_ms = 2000;   // longest a change waits while a burst goes on
     float preferred_sdr_brightness_nits = 200.0f;
     bool oled_pixel_shift_enabled = false;
     int oled_static_content_timeout_minutes = 5;
@@ -1,6 +1,8 @@
 #include "display_config.h"
+#include "core/registry/hdr_registry.h"
 #include <format>
 #include <vector>
+#include <algorithm>
 
 namespace hdrfixer::display {
 
@@ -27,11 +29,113 @@ std::expected<std::vector<DisplayPath>, std::string> query_display_paths() {
         auto nits = get_sdr_white_level(dp.adapter_id, dp.target_id);
         dp.sdr_white_level_nits = nits.value_or(80.0f);
 
+        UINT32 mode = paths[i].sourceInfo.modeInfoIdx;
+        if (mode < mode_count && modes[mode].infoType == DISPLAYCONFIG_MODE_INFO_TYPE_SOURCE) {
+            dp.width = modes[mode].sourceMode.width;
+            dp.height = modes[mode].sourceMode.height;
+        }
+        const auto& refresh = paths[i].targetInfo.refreshRate;
+        if (refresh.Denominator != 0)
+            dp.refresh_mhz = static_cast<uint32_t>(uint64_t(refresh.Numerator) * 1000 / refresh.Denominator);
+
+        auto color = get_advanced_color(dp.adapter_id, dp.target_id);
+        if (color.has_value()) {
+            dp.hdr_enabled = color->enabled;
+            dp.bits_per_color = color->bits_per_color;
+        }
+
+        auto device_path = get_monitor_device_path(dp.adapter_id, dp.target_id);
+        if (device_path.has_value())
+            dp.monitor_device_path = std::move(device_path.value());
+
+        dp.source_adapter_id = paths[i].sourceInfo.adapterId;
+        auto gdi_name = get_source_gdi_name(dp.source_adapter_id, dp.source_id);
+        if (gdi_name.has_value())
+            dp.gdi_device_name = std::move(gdi_name.value());
+
         display_paths.push_back(dp);
     }
     return display_paths;
 }
 
+DisplayPathIndex::DisplayPathIndex(const std::vector<DisplayPath>& paths) : paths_(paths) {
+    for (size_t i = 0; i < paths_.size(); ++i) {
+        const auto& path = paths_[i];
+        uint64_t source_adapter = luid_key(path.source_adapter_id);
+        // First path wins, so a cloned source maps to its first target
+        if (!path.gdi_device_name.empty())
+            by_source_.try_emplace(SourceKey{source_adapter, path.gdi_device_name}, i);
+        auto [it, first] = sole_path_.try_emplace(source_adapter, i);
+        if (!first)
+            it->second = static_cast<size_t>(-1);
+    }
+}
+
+const DisplayPath* DisplayPathIndex::find(LUID adapter_id, const std::wstring& gdi_device_name) const {
+    uint64_t adapter = luid_key(adapter_id);
+    auto it = by_source_.find(SourceKey{adapter, gdi_device_name});
+    if (it != by_source_.end())
+        return &paths_[it->second];
+
+    // No GDI name to go by: only unambiguous if the adapter drives one path
+    auto sole = sole_path_.find(adapter);
+    if (sole == sole_path_.end() || sole->second == static_cast<size_t>(-1))
+        return nullptr;
+    const auto& path = paths_[sole->second];
+    return path.gdi_device_name.empty() ? &path : nullptr;
+}
+
+std::expected<std::wstring, std::string> get_source_gdi_name(LUID adapter_id, uint32_t source_id) {
+    DISPLAYCONFIG_SOURCE_DEVICE_NAME source_name = {};
+    source_name.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME;
+    source_name.header.size = sizeof(source_name);
+    source_name.header.adapterId = adapter_id;
+    source_name.header.id = source_id;
+
+    LONG result = DisplayConfigGetDeviceInfo(&source_name.header);
+    if (result != ERROR_SUCCESS)
+        return std::unexpected(std::format("DisplayConfigGetDeviceInfo(source name) failed: {}", result));
+
+    return std::wstring(source_name.viewGdiDeviceName);
+}
+
+std::expected<std::wstring, std::string> get_monitor_device_path(LUID adapter_id, uint32_t target_id) {
+    DISPLAYCONFIG_TARGET_DEVICE_NAME target_name = {};
+    target_name.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_TARGET_NAME;
+    target_name.header.size = sizeof(target_name);
+    target_name.header.adapterId = adapter_id;
+    target_name.header.id = target_id;
+
+    LONG result = DisplayConfigGetDeviceInfo(&target_name.header);
+    if (result != ERROR_SUCCESS)
+        return std::unexpected(std::format("DisplayConfigGetDeviceInfo(target name) failed: {}", result));
+
+    return std::wstring(target_name.monitorDevicePath);
+}
+
+std::wstring monitor_edid_registry_path(const std::wstring& monitor_device_path) {
+    std::wstring path = monitor_device_path;
+
+    // Strip the "\\?\" prefix and the trailing "#{interface guid}"
+    if (path.starts_with(L"\\\\?\\"))
+        path.erase(0, 4);
+    auto guid = path.rfind(L"#{");
+    if (guid != std::wstring::npos)
+        path.erase(guid);
+    if (path.empty())
+        return {};
+
+    std::replace(path.begin(), path.end(), L'#', L'\\');
+    return L"SYSTEM\\CurrentControlSet\\Enum\\" + path + L"\\Device Parameters";
+}
+
+std::expected<std::vector<uint8_t>, std::string> read_edid(const std::wstring& monitor_device_path) {
+    auto key = monitor_edid_registry_path(monitor_device_path);
+    if (key.empty())
+        return std::unexpected("Invalid monitor device path");
+    return registry::read_binary(HKEY_LOCAL_MACHINE, key.c_str(), L"EDID");
+}
+
 std::expected<float, std::string> get_sdr_white_level(LUID adapter_id, uint32_t target_id) {
     DISPLAYCONFIG_SDR_WHITE_LEVEL white_level = {};
     white_level.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_SDR_WHITE_LEVEL;
@@ -46,4 +150,22 @@ std::expected<float, std::string> get_sdr_white_level(LUID adapter_id, uint32_t
     return raw_to_nits(white_level.SDRWhiteLevel);
 }
 
+std::expected<AdvancedColorState, std::string> get_advanced_color(LUID adapter_id, uint32_t target_id) {
+    DISPLAYCONFIG_GET_ADVANCED_COLOR_INFO color_info = {};
+    color_info.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_ADVANCED_COLOR_INFO;
+    color_info.header.size = sizeof(color_info);
+    color_info.header.adapterId = adapter_id;
+    color_info.header.id = target_id;
+
+    LONG result = DisplayConfigGetDeviceInfo(&color_info.header);
+    if (result != ERROR_SUCCESS)
+        return std::unexpected(std::format("DisplayConfigGetDeviceInfo(advanced color) failed: {}", result));
+
+    AdvancedColorState state;
+    state.supported = color_info.advancedColorSupported != 0;
+    state.enabled = color_info.advancedColorEnabled != 0;
+    state.bits_per_color = color_info.bitsPerColorChannel;
+    return state;
+}
+
 } // namespace hdrfixer::display
@@ -2,6 +2,8 @@
 #include "display_info.h"
 #include <vector>
 #include <expected>
+#include <string>
+#include <unordered_map>
 
 namespace hdrfixer::display {
 
@@ -18,12 +20,81 @@ struct DisplayPath {
     uint32_t source_id;
     uint32_t target_id;
     float sdr_white_level_nits;
+    std::wstring monitor_device_path;
+    // GDI name of the source (\\.\DISPLAY1), as in DXGI_OUTPUT_DESC::DeviceName,
+    // and the adapter DXGI enumerates that output on (differs from
+    // adapter_id on hybrid-GPU systems)
+    std::wstring gdi_device_name;
+    LUID source_adapter_id = {};
+    // Source mode and target refresh rate; 0 when the path carries no mode
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t refresh_mhz = 0;
+    bool hdr_enabled = false;
+    uint32_t bits_per_color = 0;      // 0 when the advanced color state is unknown
+};
+
+struct AdvancedColorState {
+    bool supported = false;
+    bool enabled = false;             // HDR on
+    uint32_t bits_per_color = 0;
 };
 
 // Query active display paths and their SDR white levels
 std::expected<std::vector<DisplayPath>, std::string> query_display_paths();
 
+// Hashed index over one query_display_paths() result, built once per
+// enumeration, for matching DXGI outputs to their paths in O(1) each.
+// An output is matched through its adapter LUID and GDI device name, so
+// several outputs on one adapter each find their own path.  The paths
+// must outlive the index.
+class DisplayPathIndex {
+public:
+    explicit DisplayPathIndex(const std::vector<DisplayPath>& paths);
+
+    // The path whose source is `gdi_device_name` on source adapter
+    // `adapter_id` (the output's DXGI adapter); in clone mode, the first
+    // of its targets.  Paths whose GDI name could not be queried only
+    // match if they are the sole path on their adapter.  nullptr if no
+    // path matches.
+    const DisplayPath* find(LUID adapter_id, const std::wstring& gdi_device_name) const;
+
+private:
+    struct SourceKey {
+        uint64_t adapter;
+        std::wstring gdi_device_name;
+        bool operator==(const SourceKey&) const = default;
+    };
+    struct SourceKeyHash {
+        size_t operator()(const SourceKey& k) const {
+            return std::hash<std::wstring>{}(k.gdi_device_name) ^ (k.adapter * 0x9e3779b97f4a7c15ULL);
+        }
+    };
+
+    const std::vector<DisplayPath>& paths_;
+    std::unordered_map<SourceKey, size_t, SourceKeyHash> by_source_;
+    // adapter -> its only path, or npos if it has several
+    std::unordered_map<uint64_t, size_t> sole_path_;
+};
+
+// Get the GDI device name (\\.\DISPLAY1) of a source
+std::expected<std::wstring, std::string> get_source_gdi_name(LUID adapter_id, uint32_t source_id);
+
+// Get the monitor device interface path (\\?\DISPLAY#...) for a target
+std::expected<std::wstring, std::string> get_monitor_device_path(LUID adapter_id, uint32_t target_id);
+
+// Map a monitor device interface path to the registry key holding its EDID:
+// \\?\DISPLAY#DEL40F5#5&1a2b&0&UID1#{guid} ->
+// SYSTEM\CurrentControlSet\Enum\DISPLAY\DEL40F5\5&1a2b&0&UID1\Device Parameters
+std::wstring monitor_edid_registry_path(const std::wstring& monitor_device_path);
+
+// Read the raw EDID the OS cached for a monitor
+std::expected<std::vector<uint8_t>, std::string> read_edid(const std::wstring& monitor_device_path);
+
 // Get SDR white level for a specific target
 std::expected<float, std::string> get_sdr_white_level(LUID adapter_id, uint32_t target_id);
 
+// Get the HDR (advanced color) state of a specific target
+std::expected<AdvancedColorState, std::string> get_advanced_color(LUID adapter_id, uint32_t target_id);
+
 } // namespace hdrfixer::display
@@ -0,0 +1,124 @@
+#include "display_identity.h"
+#include "display_config.h"
+#include "display_topology.h"
+#include "edid_blocks.h"
+#include <algorithm>
+#include <iterator>
+
+namespace hdrfixer::display {
+
+uint64_t display_fingerprint(const std::wstring& monitor_device_path,
+                             std::span<const uint8_t> edid) {
+    auto path_bytes = std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(monitor_device_path.data()),
+        monitor_device_path.size() * sizeof(wchar_t));
+    return edid_hash(edid, edid_hash(path_bytes));
+}
+
+uint64_t display_fingerprint(const DisplayInfo& info) {
+    return display_fingerprint(info.monitor_device_path, info.edid_data);
+}
+
+uint64_t display_path_key(const DisplayInfo& info) {
+    const auto& path = info.monitor_device_path.empty() ? info.device_name : info.monitor_device_path;
+    return edid_hash(std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(path.data()), path.size() * sizeof(wchar_t)));
+}
+
+std::expected<std::vector<uint64_t>, std::string> probe_display_fingerprints() {
+    auto topology = probe_topology();
+    if (!topology.has_value())
+        return std::unexpected(topology.error());
+    return topology->fingerprints();
+}
+
+DisplayChanges DisplayIdentityCache::update(std::vector<DisplayInfo> detected) {
+    DisplayChanges changes;
+    std::vector<Entry> next;
+    next.reserve(detected.size());
+
+    for (auto& info : detected) {
+        uint64_t fp = display_fingerprint(info);
+        auto it = std::find_if(entries_.begin(), entries_.end(), [fp](const Entry& e) {
+            return e.info && e.fingerprint == fp;
+        });
+        if (it != entries_.end()) {
+            *it->info = std::move(info);
+            next.push_back(std::move(*it));
+        } else {
+            next.push_back({fp, std::make_unique<DisplayInfo>(std::move(info))});
+            changes.added.push_back(fp);
+        }
+    }
+
+    for (const auto& e : entries_) {
+        if (e.info) changes.removed.push_back(e.fingerprint);
+    }
+    entries_ = std::move(next);
+    return changes;
+}
+
+std::vector<uint64_t> DisplayIdentityCache::retain(const std::vector<uint64_t>& fingerprints) {
+    auto removed = diff(fingerprints).removed;
+    for (uint64_t fp : removed) {
+        auto it = std::find_if(entries_.begin(), entries_.end(), [fp](const Entry& e) {
+            return e.fingerprint == fp;
+        });
+        if (it != entries_.end()) entries_.erase(it);
+    }
+    return removed;
+}
+
+DisplayChanges DisplayIdentityCache::diff(const std::vector<uint64_t>& fingerprints) const {
+    auto current = this->fingerprints();
+    auto probed = fingerprints;
+    std::sort(current.begin(), current.end());
+    std::sort(probed.begin(), probed.end());
+
+    DisplayChanges changes;
+    std::set_difference(probed.begin(), probed.end(), current.begin(), current.end(),
+                        std::back_inserter(changes.added));
+    std::set_difference(current.begin(), current.end(), probed.begin(), probed.end(),
+                        std::back_inserter(changes.removed));
+    return changes;
+}
+
+bool DisplayIdentityCache::update_state(const TopologyTarget& target) {
+    auto it = std::find_if(entries_.begin(), entries_.end(), [&](const Entry& e) {
+        return e.fingerprint == target.fingerprint;
+    });
+    if (it == entries_.end()) return false;
+
+    auto& info = *it->info;
+    info.adapter_luid = target.adapter_id;
+    info.source_adapter_luid = target.source_adapter_id;
+    info.source_id = target.source_id;
+    info.target_id = target.target_id;
+    info.is_hdr_enabled = target.hdr_enabled;
+    if (target.bits_per_color != 0) info.bits_per_color = target.bits_per_color;
+    info.sdr_white_level_nits = target.sdr_white_level_nits;
+    return true;
+}
+
+const DisplayInfo* DisplayIdentityCache::find(uint64_t fingerprint) const {
+    for (const auto& e : entries_) {
+        if (e.fingerprint == fingerprint) return e.info.get();
+    }
+    return nullptr;
+}
+
+std::vector<uint64_t> DisplayIdentityCache::fingerprints() const {
+    std::vector<uint64_t> out;
+    out.reserve(entries_.size());
+    for (const auto& e : entries_) out.push_back(e.fingerprint);
+    return out;
+}
+
+std::vector<const DisplayInfo*> DisplayIdentityCache::displays() const {
+    std::vector<const DisplayInfo*> out;
+    out.reserve(entries_.size());
+    for (const auto& e : entries_) out.push_back(e.info.get());
+    return out;
+}
+
+} // namespace hdrfixer::display
@@ -0,0 +1,74 @@
+#pragma once
+#include "display_info.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <expected>
+#include <span>
+
+namespace hdrfixer::display {
+
+struct TopologyTarget;
+
+// Stable identity of a connected output: the EDID content combined with
+// the monitor device interface path (which carries the connector UID, so
+// two identical panels on different ports stay distinct).  Survives
+// re-enumeration, unlike DXGI output indices.
+uint64_t display_fingerprint(const std::wstring& monitor_device_path,
+                             std::span<const uint8_t> edid);
+uint64_t display_fingerprint(const DisplayInfo& info);
+
+// Key for per-display state kept across runs, such as file names: the
+// monitor device path alone (the GDI name if it is unknown), so it does
+// not change when the EDID cannot be read.  A different panel on the same
+// connector gets the same key.
+uint64_t display_path_key(const DisplayInfo& info);
+
+// Fingerprints of the currently active outputs, from one QueryDisplayConfig
+// plus one registry read per path -- much cheaper than a DXGI enumeration.
+std::expected<std::vector<uint64_t>, std::string> probe_display_fingerprints();
+
+struct DisplayChanges {
+    std::vector<uint64_t> added;
+    std::vector<uint64_t> removed;
+
+    bool empty() const { return added.empty() && removed.empty(); }
+};
+
+// Last known DisplayInfo per fingerprint, in detection order.  Entries are
+// heap-allocated so pointers returned by find() stay valid across updates
+// until that display is removed.
+class DisplayIdentityCache {
+public:
+    // Replace the cached set with a fresh detection.  Retained displays are
+    // updated in place.
+    DisplayChanges update(std::vector<DisplayInfo> detected);
+
+    // Drop displays whose fingerprint is absent from `fingerprints` without
+    // re-detecting the rest.  Returns the removed fingerprints.
+    std::vector<uint64_t> retain(const std::vector<uint64_t>& fingerprints);
+
+    // Compare a probe against the cache (as multisets).
+    DisplayChanges diff(const std::vector<uint64_t>& fingerprints) const;
+
+    // Refresh a cached display's live state (path, HDR, bit depth, white
+    // level) from a topology probe, without re-detecting it.  False if the
+    // display is not cached.
+    bool update_state(const TopologyTarget& target);
+
+    const DisplayInfo* find(uint64_t fingerprint) const;
+    std::vector<uint64_t> fingerprints() const;
+    std::vector<const DisplayInfo*> displays() const;
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+private:
+    struct Entry {
+        uint64_t fingerprint;
+        std::unique_ptr<DisplayInfo> info;
+    };
+    std::vector<Entry> entries_;
+};
+
+} // namespace hdrfixer::display
@@ -1,7 +1,10 @@
 #pragma once
 #include <string>
 #include <cstdint>
+#include <vector>
+#include <optional>
 #include <windows.h>
+#include "edid_reader.h"
 
 namespace hdrfixer::display {
 
@@ -36,11 +39,20 @@ struct DisplayInfo {
     float green_primary[2] = {};
     float blue_primary[2] = {};
     float white_point[2] = {};
-    LUID adapter_luid = {};
+    LUID adapter_luid = {};            // adapter driving target_id
+    LUID source_adapter_luid = {};     // adapter owning source_id, for WCS associations
     uint32_t source_id = 0;
     uint32_t target_id = 0;
+    std::wstring monitor_device_path;
+    std::vector<uint8_t> edid_data;
+    std::optional<EdidInfo> edid;
 
     bool is_hdr_capable() const { return max_luminance > 250.0f; }
 };
 
+// Adapter LUID packed into one integer, for use as a map/resource key.
+inline uint64_t luid_key(const LUID& luid) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(luid.HighPart)) << 32) | luid.LowPart;
+}
+
 } // namespace hdrfixer::display
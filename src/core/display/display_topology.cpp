@@ -0,0 +1,120 @@
+#include "display_topology.h"
+#include "display_config.h"
+#include "display_identity.h"
+
+namespace hdrfixer::display {
+
+namespace {
+
+constexpr size_t kNone = static_cast<size_t>(-1);
+
+uint32_t compare_targets(const TopologyTarget& a, const TopologyTarget& b) {
+    uint32_t changes = 0;
+    if (luid_key(a.adapter_id) != luid_key(b.adapter_id) ||
+        luid_key(a.source_adapter_id) != luid_key(b.source_adapter_id) ||
+        a.source_id != b.source_id || a.target_id != b.target_id)
+        changes |= kTargetPathChanged;
+    if (a.width != b.width || a.height != b.height || a.refresh_mhz != b.refresh_mhz)
+        changes |= kTargetModeChanged;
+    if (a.hdr_enabled != b.hdr_enabled || a.bits_per_color != b.bits_per_color)
+        changes |= kTargetHdrChanged;
+    if (a.sdr_white_level_nits != b.sdr_white_level_nits)
+        changes |= kTargetWhiteLevelChanged;
+    return changes;
+}
+
+} // namespace
+
+TopologyTarget topology_target(const DisplayPath& path, uint64_t fingerprint) {
+    TopologyTarget target;
+    target.fingerprint = fingerprint;
+    target.adapter_id = path.adapter_id;
+    target.source_adapter_id = path.source_adapter_id;
+    target.source_id = path.source_id;
+    target.target_id = path.target_id;
+    target.width = path.width;
+    target.height = path.height;
+    target.refresh_mhz = path.refresh_mhz;
+    target.hdr_enabled = path.hdr_enabled;
+    target.bits_per_color = path.bits_per_color;
+    target.sdr_white_level_nits = path.sdr_white_level_nits;
+    return target;
+}
+
+TopologySnapshot::TopologySnapshot(std::vector<TopologyTarget> targets)
+    : targets_(std::move(targets)), next_same_(targets_.size(), kNone) {
+    // Chain targets that share a fingerprint so diff() can pair them in order
+    std::unordered_map<uint64_t, size_t> last;
+    for (size_t i = 0; i < targets_.size(); ++i) {
+        uint64_t fp = targets_[i].fingerprint;
+        auto [it, first] = last.try_emplace(fp, i);
+        if (first) {
+            index_.emplace(fp, i);
+        } else {
+            next_same_[it->second] = i;
+            it->second = i;
+        }
+    }
+}
+
+TopologyDiff TopologySnapshot::diff(const TopologySnapshot& next) const {
+    TopologyDiff diff;
+    std::vector<bool> matched(next.targets_.size(), false);
+    // Per fingerprint: the target in `next` to pair with the next occurrence here
+    std::unordered_map<uint64_t, size_t> cursor;
+
+    for (const auto& before : targets_) {
+        auto [it, fresh] = cursor.try_emplace(before.fingerprint, kNone);
+        if (fresh) {
+            auto first = next.index_.find(before.fingerprint);
+            if (first != next.index_.end()) it->second = first->second;
+        }
+        size_t j = it->second;
+        if (j == kNone) {
+            diff.removed.push_back(before.fingerprint);
+            continue;
+        }
+        it->second = next.next_same_[j];
+        matched[j] = true;
+        if (uint32_t changes = compare_targets(before, next.targets_[j]))
+            diff.changed.push_back({before.fingerprint, changes});
+    }
+
+    for (size_t j = 0; j < next.targets_.size(); ++j) {
+        if (!matched[j]) diff.added.push_back(next.targets_[j].fingerprint);
+    }
+    return diff;
+}
+
+const TopologyTarget* TopologySnapshot::find(uint64_t fingerprint) const {
+    auto it = index_.find(fingerprint);
+    return it != index_.end() ? &targets_[it->second] : nullptr;
+}
+
+std::vector<uint64_t> TopologySnapshot::fingerprints() const {
+    std::vector<uint64_t> out;
+    out.reserve(targets_.size());
+    for (const auto& t : targets_) out.push_back(t.fingerprint);
+    return out;
+}
+
+std::expected<TopologySnapshot, std::string> probe_topology() {
+    auto paths = query_display_paths();
+    if (!paths.has_value())
+        return std::unexpected(paths.error());
+
+    std::vector<TopologyTarget> targets;
+    targets.reserve(paths->size());
+    for (const auto& path : paths.value()) {
+        std::vector<uint8_t> edid;
+        if (!path.monitor_device_path.empty()) {
+            auto data = read_edid(path.monitor_device_path);
+            if (data.has_value())
+                edid = std::move(data.value());
+        }
+        targets.push_back(topology_target(path, display_fingerprint(path.monitor_device_path, edid)));
+    }
+    return TopologySnapshot(std::move(targets));
+}
+
+} // namespace hdrfixer::display
@@ -0,0 +1,80 @@
+#pragma once
+#include "display_info.h"
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hdrfixer::display {
+
+struct DisplayPath;
+
+// Live state of one active target, keyed by display_fingerprint().  Unlike
+// the fingerprint, all of it can change while the monitor stays connected.
+struct TopologyTarget {
+    uint64_t fingerprint = 0;
+    LUID adapter_id = {};             // target's adapter
+    LUID source_adapter_id = {};
+    uint32_t source_id = 0;
+    uint32_t target_id = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t refresh_mhz = 0;
+    bool hdr_enabled = false;
+    uint32_t bits_per_color = 0;      // 0 when unknown
+    float sdr_white_level_nits = 80.0f;
+};
+
+TopologyTarget topology_target(const DisplayPath& path, uint64_t fingerprint);
+
+// What changed about a target present on both sides of a diff
+enum TargetChange : uint32_t {
+    kTargetPathChanged       = 1u << 0,   // adapter, source or target id
+    kTargetModeChanged       = 1u << 1,   // resolution or refresh rate
+    kTargetHdrChanged        = 1u << 2,   // HDR on/off or bit depth
+    kTargetWhiteLevelChanged = 1u << 3,
+};
+
+struct ChangedTarget {
+    uint64_t fingerprint = 0;
+    uint32_t changes = 0;             // TargetChange bits
+};
+
+struct TopologyDiff {
+    std::vector<uint64_t> added;
+    std::vector<uint64_t> removed;
+    std::vector<ChangedTarget> changed;
+
+    bool empty() const { return added.empty() && removed.empty() && changed.empty(); }
+};
+
+// The active display paths at one point in time, indexed by fingerprint.
+// Two outputs with the same fingerprint (no path, no EDID) are matched up
+// in order, as the identity cache does.
+class TopologySnapshot {
+public:
+    TopologySnapshot() = default;
+    explicit TopologySnapshot(std::vector<TopologyTarget> targets);
+
+    // Structural diff from this snapshot to `next`, in O(targets)
+    TopologyDiff diff(const TopologySnapshot& next) const;
+
+    const TopologyTarget* find(uint64_t fingerprint) const;
+    std::vector<uint64_t> fingerprints() const;
+    const std::vector<TopologyTarget>& targets() const { return targets_; }
+    size_t size() const { return targets_.size(); }
+    bool empty() const { return targets_.empty(); }
+
+private:
+    std::vector<TopologyTarget> targets_;
+    // fingerprint -> first target with it
+    std::unordered_map<uint64_t, size_t> index_;
+    // target -> next target with the same fingerprint, or npos
+    std::vector<size_t> next_same_;
+};
+
+// One QueryDisplayConfig plus one EDID read per path; no DXGI enumeration.
+std::expected<TopologySnapshot, std::string> probe_topology();
+
+} // namespace hdrfixer::display
@@ -0,0 +1,147 @@
+#include "displayid_reader.h"
+#include <cmath>
+#include <limits>
+
+namespace hdrfixer::display {
+
+namespace {
+
+constexpr uint8_t kDisplayIdExtensionTag = 0x70;
+
+// DisplayID data block tags
+constexpr uint8_t kTagColorCharacteristics = 0x0E;   // 1.3
+constexpr uint8_t kTagTiledTopologyV1 = 0x12;        // 1.3
+constexpr uint8_t kTagDisplayParameters = 0x21;      // 2.0
+constexpr uint8_t kTagTiledTopology = 0x28;          // 2.0
+
+constexpr size_t kDisplayParametersSize = 29;
+constexpr size_t kTiledTopologySize = 22;
+
+// 12-bit x/y pair packed into 3 bytes: x[7:0], y[3:0]|x[11:8], y[11:4]
+Chromaticity unpack_xy12(std::span<const uint8_t> p) {
+    uint16_t x = static_cast<uint16_t>(p[0] | ((p[1] & 0x0F) << 8));
+    uint16_t y = static_cast<uint16_t>((p[1] >> 4) | (p[2] << 4));
+    return {static_cast<float>(x) / 4096.0f, static_cast<float>(y) / 4096.0f};
+}
+
+void parse_display_parameters(std::span<const uint8_t> payload, DisplayIdInfo& info) {
+    if (payload.size() < kDisplayParametersSize) return;
+    auto& p = info.params;
+    p.h_image_size_mm10 = read_le16(payload, 0);
+    p.v_image_size_mm10 = read_le16(payload, 2);
+    p.h_pixels = read_le16(payload, 4);
+    p.v_pixels = read_le16(payload, 6);
+    p.feature_flags = payload[8];
+    p.red   = unpack_xy12(payload.subspan(9, 3));
+    p.green = unpack_xy12(payload.subspan(12, 3));
+    p.blue  = unpack_xy12(payload.subspan(15, 3));
+    p.white = unpack_xy12(payload.subspan(18, 3));
+    p.max_full_frame_luminance = half_to_float(read_le16(payload, 21));
+    p.max_luminance = half_to_float(read_le16(payload, 23));
+    p.min_luminance = half_to_float(read_le16(payload, 25));
+
+    static constexpr uint8_t kDepths[8] = {0, 6, 8, 10, 12, 14, 16, 0};
+    p.bits_per_color = kDepths[payload[27] & 0x07];
+    p.native_gamma = payload[28] == 0xFF
+        ? 0.0f
+        : (static_cast<float>(payload[28]) + 100.0f) / 100.0f;
+    info.has_display_parameters = true;
+}
+
+void parse_color_characteristics(std::span<const uint8_t> payload, DisplayIdInfo& info) {
+    if (payload.empty()) return;
+    auto& c = info.color;
+    c.cie1976_uv = payload[0] & 0x80;
+    c.primary_count = payload[0] & 0x0F;
+    c.white_point_count = (payload[0] >> 4) & 0x07;
+
+    size_t entries = c.primary_count + c.white_point_count;
+    if (payload.size() < 1 + entries * 3) return;
+
+    for (size_t i = 0; i < c.primary_count; ++i) {
+        auto xy = unpack_xy12(payload.subspan(1 + i * 3, 3));
+        if (i < DisplayIdColorCharacteristics::kMaxPrimaries)
+            c.primaries[i] = xy;
+    }
+    if (c.white_point_count > 0)
+        c.white = unpack_xy12(payload.subspan(1 + c.primary_count * 3, 3));
+    info.has_color_characteristics = true;
+}
+
+void parse_tiled_topology(std::span<const uint8_t> payload, DisplayIdInfo& info) {
+    if (payload.size() < kTiledTopologySize) return;
+    auto& t = info.tile;
+    uint8_t high = payload[3];
+    t.capabilities = payload[0];
+    t.h_tiles = static_cast<uint8_t>(((payload[1] >> 4) | (((high >> 6) & 0x03) << 4)) + 1);
+    t.v_tiles = static_cast<uint8_t>(((payload[1] & 0x0F) | (((high >> 4) & 0x03) << 4)) + 1);
+    t.h_location = static_cast<uint8_t>((payload[2] >> 4) | (((high >> 2) & 0x03) << 4));
+    t.v_location = static_cast<uint8_t>((payload[2] & 0x0F) | ((high & 0x03) << 4));
+    t.tile_width = static_cast<uint16_t>(read_le16(payload, 4) + 1);
+    t.tile_height = static_cast<uint16_t>(read_le16(payload, 6) + 1);
+    t.topology_vendor = read_le24(payload, 13);
+    t.topology_product = read_le16(payload, 16);
+    t.topology_serial = static_cast<uint32_t>(read_le16(payload, 18)) |
+                        (static_cast<uint32_t>(read_le16(payload, 20)) << 16);
+    info.has_tiled_topology = true;
+}
+
+} // anonymous namespace
+
+float half_to_float(uint16_t half) {
+    int exponent = (half >> 10) & 0x1F;
+    int mantissa = half & 0x3FF;
+    float sign = (half & 0x8000) ? -1.0f : 1.0f;
+
+    if (exponent == 0)
+        return sign * std::ldexp(static_cast<float>(mantissa), -24);
+    if (exponent == 0x1F)
+        return mantissa ? std::numeric_limits<float>::quiet_NaN()
+                        : sign * std::numeric_limits<float>::infinity();
+    return sign * std::ldexp(static_cast<float>(mantissa | 0x400), exponent - 25);
+}
+
+bool parse_displayid_section(std::span<const uint8_t> section, DisplayIdInfo& info) {
+    // version, section bytes, product type, extension count, blocks..., checksum
+    if (section.size() < 5) return false;
+    size_t payload_len = section[1];
+    if (4 + payload_len + 1 > section.size()) {
+        info.truncated = true;
+        return false;
+    }
+
+    info.version = section[0];
+    info.checksum_valid = checksum_valid(section.subspan(0, 4 + payload_len + 1));
+    if (!info.checksum_valid) return false;
+
+    bool complete = for_each_displayid_data_block(section.subspan(4, payload_len),
+        [&](uint8_t tag, uint8_t, std::span<const uint8_t> payload) {
+            switch (tag) {
+                case kTagDisplayParameters:
+                    parse_display_parameters(payload, info);
+                    break;
+                case kTagColorCharacteristics:
+                    parse_color_characteristics(payload, info);
+                    break;
+                case kTagTiledTopology:
+                case kTagTiledTopologyV1:
+                    parse_tiled_topology(payload, info);
+                    break;
+                default:
+                    break;
+            }
+        });
+    info.truncated = !complete;
+    return true;
+}
+
+bool parse_displayid_extension(std::span<const uint8_t> block, DisplayIdInfo& info) {
+    if (block.size() < kEdidBlockSize || block[0] != kDisplayIdExtensionTag)
+        return false;
+    if (!checksum_valid(block.subspan(0, kEdidBlockSize)))
+        return false;
+    // The section occupies bytes 1..126; byte 127 is the EDID block checksum
+    return parse_displayid_section(block.subspan(1, kEdidBlockSize - 2), info);
+}
+
+} // namespace hdrfixer::display
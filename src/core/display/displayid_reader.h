@@ -0,0 +1,78 @@
+#pragma once
+#include "edid_blocks.h"
+#include <cstdint>
+#include <span>
+
+namespace hdrfixer::display {
+
+// DisplayID 2.0 Display Parameters data block (tag 0x21).
+// Luminance values are in cd/m2; 0 means not reported.
+struct DisplayIdParameters {
+    uint16_t h_image_size_mm10 = 0;     // 0.1 mm units
+    uint16_t v_image_size_mm10 = 0;
+    uint16_t h_pixels = 0;
+    uint16_t v_pixels = 0;
+    uint8_t feature_flags = 0;
+    Chromaticity red;
+    Chromaticity green;
+    Chromaticity blue;
+    Chromaticity white;
+    float max_luminance = 0.0f;          // 10% rectangular coverage
+    float max_full_frame_luminance = 0.0f;
+    float min_luminance = 0.0f;
+    uint8_t bits_per_color = 0;          // 0 = not defined
+    float native_gamma = 0.0f;           // 0 = not defined
+};
+
+// Color Characteristics data block (DisplayID 1.3 tag 0x0E, still
+// emitted alongside 2.0 blocks by some panels).
+struct DisplayIdColorCharacteristics {
+    static constexpr size_t kMaxPrimaries = 4;
+    bool cie1976_uv = false;
+    uint8_t primary_count = 0;
+    uint8_t white_point_count = 0;
+    Chromaticity primaries[kMaxPrimaries];
+    Chromaticity white;
+};
+
+// Tiled Display Topology data block (tag 0x28 in 2.0, 0x12 in 1.3).
+struct DisplayIdTiledTopology {
+    uint8_t capabilities = 0;
+    uint8_t h_tiles = 0;             // total tiles, not minus one
+    uint8_t v_tiles = 0;
+    uint8_t h_location = 0;          // zero-based position of this tile
+    uint8_t v_location = 0;
+    uint16_t tile_width = 0;         // pixels
+    uint16_t tile_height = 0;
+    uint32_t topology_vendor = 0;    // 3-byte vendor id shared by all tiles
+    uint16_t topology_product = 0;
+    uint32_t topology_serial = 0;
+};
+
+struct DisplayIdInfo {
+    uint8_t version = 0;             // 0x20 for DisplayID 2.0
+    bool checksum_valid = false;
+    bool truncated = false;
+
+    bool has_display_parameters = false;
+    DisplayIdParameters params;
+
+    bool has_color_characteristics = false;
+    DisplayIdColorCharacteristics color;
+
+    bool has_tiled_topology = false;
+    DisplayIdTiledTopology tile;
+};
+
+// Parses one DisplayID section (starting at the version byte).  Data
+// blocks are only decoded when the section checksum is valid.
+bool parse_displayid_section(std::span<const uint8_t> section, DisplayIdInfo& info);
+
+// Parses a DisplayID EDID extension block (tag 0x70).  Returns false if the
+// block is not a DisplayID extension or its checksums do not validate.
+bool parse_displayid_extension(std::span<const uint8_t> block, DisplayIdInfo& info);
+
+// IEEE 754 binary16 decode, as used for DisplayID 2.0 luminance fields.
+float half_to_float(uint16_t half);
+
+} // namespace hdrfixer::display
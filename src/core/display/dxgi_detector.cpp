@@ -2,6 +2,7 @@
 #include "display_config.h"
 #include <dxgi1_6.h>
 #include <wrl/client.h>
+#include <algorithm>
 
 using Microsoft::WRL::ComPtr;
 
@@ -13,10 +14,12 @@ std::expected<std::vector<DisplayInfo>, std::string> detect_displays() {
     if (FAILED(hr))
         return std::unexpected(std::format("CreateDXGIFactory1 failed: 0x{:08X}", static_cast<unsigned>(hr)));
 
-    // Query display paths for LUID/source/target mapping
+    // Query display paths for LUID/source/target mapping, indexed once so
+    // each output is matched in O(1)
     auto paths_result = query_display_paths();
     std::vector<DisplayPath> empty_paths;
     auto& paths = paths_result.has_value() ? paths_result.value() : empty_paths;
+    DisplayPathIndex path_index(paths);
 
     std::vector<DisplayInfo> displays;
 
@@ -55,15 +58,28 @@ std::expected<std::vector<DisplayInfo>, std::string> detect_displays() {
                 info.white_point[0] = desc.WhitePoint[0];
                 info.white_point[1] = desc.WhitePoint[1];
 
-                // Match with DisplayConfig path for LUID + source/target
+                // Match with the DisplayConfig path for this output's
+                // source: same adapter LUID and GDI device name.  The
+                // target may sit on another adapter (hybrid GPUs), and
+                // target-level queries need that one.
                 info.adapter_luid = adapter_desc.AdapterLuid;
-                for (const auto& path : paths) {
-                    if (path.adapter_id.LowPart == adapter_desc.AdapterLuid.LowPart &&
-                        path.adapter_id.HighPart == adapter_desc.AdapterLuid.HighPart) {
-                        info.source_id = path.source_id;
-                        info.target_id = path.target_id;
-                        info.sdr_white_level_nits = path.sdr_white_level_nits;
-                        break;
+                info.source_adapter_luid = adapter_desc.AdapterLuid;
+                if (const auto* path = path_index.find(adapter_desc.AdapterLuid, info.device_name)) {
+                    info.adapter_luid = path->adapter_id;
+                    info.source_adapter_luid = path->source_adapter_id;
+                    info.source_id = path->source_id;
+                    info.target_id = path->target_id;
+                    info.sdr_white_level_nits = path->sdr_white_level_nits;
+                    info.monitor_device_path = path->monitor_device_path;
+                }
+
+                // One registry read gives the panel's own view of its
+                // capabilities, used for quirks and validation.
+                if (!info.monitor_device_path.empty()) {
+                    auto edid = read_edid(info.monitor_device_path);
+                    if (edid.has_value()) {
+                        info.edid_data = std::move(edid.value());
+                        info.edid = parse_edid(info.edid_data);
                     }
                 }
 
@@ -77,4 +93,36 @@ std::expected<std::vector<DisplayInfo>, std::string> detect_displays() {
     return displays;
 }
 
+size_t apply_panel_quirks(std::vector<DisplayInfo>& displays, const QuirksDatabase& quirks) {
+    if (quirks.empty())
+        return 0;
+
+    size_t applied = 0;
+    for (auto& info : displays) {
+        if (!info.edid.has_value())
+            continue;
+        auto quirk = quirks.lookup(info.edid->manufacturer_id, info.edid->product_code);
+        if (!quirk.has_value())
+            continue;
+
+        if (quirk->flags & kQuirkMaxLuminance)
+            info.max_luminance = quirk->max_luminance;
+        if (quirk->flags & kQuirkMinLuminance)
+            info.min_luminance = quirk->min_luminance;
+        if (quirk->flags & kQuirkFullFrameLuminance)
+            info.max_full_frame_luminance = quirk->max_full_frame_luminance;
+        // Each primary is overridden on its own; the others keep their EDID value
+        if (quirk->flags & kQuirkRedPrimary)
+            std::copy_n(quirk->red_primary, 2, info.red_primary);
+        if (quirk->flags & kQuirkGreenPrimary)
+            std::copy_n(quirk->green_primary, 2, info.green_primary);
+        if (quirk->flags & kQuirkBluePrimary)
+            std::copy_n(quirk->blue_primary, 2, info.blue_primary);
+        if (quirk->flags & kQuirkWhitePoint)
+            std::copy_n(quirk->white_point, 2, info.white_point);
+        ++applied;
+    }
+    return applied;
+}
+
 } // namespace hdrfixer::display
@@ -1,5 +1,6 @@
 #pragma once
 #include "display_info.h"
+#include "panel_quirks.h"
 #include <vector>
 #include <expected>
 
@@ -7,4 +8,9 @@ namespace hdrfixer::display {
 
 std::expected<std::vector<DisplayInfo>, std::string> detect_displays();
 
+// Override luminance/primaries of displays whose EDID (manufacturer,
+// product code) has an entry in the quirks database.  Returns the number
+// of displays that were changed.
+size_t apply_panel_quirks(std::vector<DisplayInfo>& displays, const QuirksDatabase& quirks);
+
 } // namespace hdrfixer::display
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace hdrfixer::display {
+
+// Shared low-level helpers for walking EDID-family binary structures
+// (EDID base/extension blocks, CTA-861 and DisplayID data blocks).
+// Everything here works on non-owning spans and never allocates.
+
+inline constexpr size_t kEdidBlockSize = 128;
+
+struct Chromaticity {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Sum of all bytes modulo 256 must be zero for EDID blocks and
+// DisplayID sections.
+inline bool checksum_valid(std::span<const uint8_t> bytes) {
+    uint8_t sum = 0;
+    for (uint8_t b : bytes) sum = static_cast<uint8_t>(sum + b);
+    return sum == 0;
+}
+
+// 64-bit FNV-1a over the raw bytes; used to key caches by EDID content.
+inline uint64_t edid_hash(std::span<const uint8_t> bytes, uint64_t seed = 0xcbf29ce484222325ull) {
+    uint64_t h = seed;
+    for (uint8_t b : bytes) {
+        h ^= b;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// Number of complete 128-byte blocks actually present, clamped to the
+// extension count the base block declares (byte 126).
+inline size_t edid_block_count(std::span<const uint8_t> edid) {
+    if (edid.size() < kEdidBlockSize) return 0;
+    size_t declared = 1 + static_cast<size_t>(edid[126]);
+    size_t available = edid.size() / kEdidBlockSize;
+    return declared < available ? declared : available;
+}
+
+inline std::span<const uint8_t> edid_block(std::span<const uint8_t> edid, size_t index) {
+    return edid.subspan(index * kEdidBlockSize, kEdidBlockSize);
+}
+
+// Calls fn(index, block) for every complete block (base block first).
+template <typename Fn>
+void for_each_edid_block(std::span<const uint8_t> edid, Fn&& fn) {
+    size_t count = edid_block_count(edid);
+    for (size_t i = 0; i < count; ++i) {
+        fn(i, edid_block(edid, i));
+    }
+}
+
+// CTA-861 data block collection: 1-byte header (tag in bits 7:5, payload
+// length in bits 4:0).  Calls fn(tag, payload) for each complete block and
+// returns false if the collection is truncated.
+template <typename Fn>
+bool for_each_cta_data_block(std::span<const uint8_t> blocks, Fn&& fn) {
+    size_t pos = 0;
+    while (pos < blocks.size()) {
+        uint8_t tag = blocks[pos] >> 5;
+        size_t len = blocks[pos] & 0x1F;
+        if (pos + 1 + len > blocks.size()) return false;
+        fn(tag, blocks.subspan(pos + 1, len));
+        pos += 1 + len;
+    }
+    return true;
+}
+
+// DisplayID data blocks: 3-byte header (tag, revision, payload length).
+// Calls fn(tag, revision, payload) for each complete block.  Zero bytes
+// after the last block are padding.  Returns false if a block overruns
+// the section.
+template <typename Fn>
+bool for_each_displayid_data_block(std::span<const uint8_t> blocks, Fn&& fn) {
+    size_t pos = 0;
+    while (pos < blocks.size()) {
+        if (blocks[pos] == 0) return true;
+        if (pos + 3 > blocks.size()) return false;
+        uint8_t tag = blocks[pos];
+        uint8_t revision = blocks[pos + 1];
+        size_t len = blocks[pos + 2];
+        if (pos + 3 + len > blocks.size()) return false;
+        fn(tag, revision, blocks.subspan(pos + 3, len));
+        pos += 3 + len;
+    }
+    return true;
+}
+
+inline uint16_t read_le16(std::span<const uint8_t> bytes, size_t offset) {
+    return static_cast<uint16_t>(bytes[offset] | (bytes[offset + 1] << 8));
+}
+
+inline uint32_t read_le24(std::span<const uint8_t> bytes, size_t offset) {
+    return static_cast<uint32_t>(bytes[offset]) |
+           (static_cast<uint32_t>(bytes[offset + 1]) << 8) |
+           (static_cast<uint32_t>(bytes[offset + 2]) << 16);
+}
+
+} // namespace hdrfixer::display
@@ -1,45 +1,234 @@
 #include "edid_reader.h"
-#include <cstring>
-#include <algorithm>
+#include "edid_blocks.h"
+#include <cmath>
 
 namespace hdrfixer::display {
 
-std::optional<EdidInfo> parse_edid(const uint8_t* data, size_t length) {
-    if (!data || length < 128)
-        return std::nullopt;
+namespace {
 
-    EdidInfo info{};
+constexpr uint8_t kCtaExtensionTag = 0x02;
+constexpr uint8_t kDisplayIdExtensionTag = 0x70;
 
-    // Manufacturer ID (bytes 8-9, compressed 3-letter ASCII)
-    uint16_t mfg = (static_cast<uint16_t>(data[8]) << 8) | data[9];
-    char c1 = static_cast<char>(((mfg >> 10) & 0x1F) + 'A' - 1);
-    char c2 = static_cast<char>(((mfg >> 5) & 0x1F) + 'A' - 1);
-    char c3 = static_cast<char>((mfg & 0x1F) + 'A' - 1);
-    info.manufacturer = {c1, c2, c3};
+// CTA-861 data block tag codes
+constexpr uint8_t kCtaTagVendorSpecific = 3;
+constexpr uint8_t kCtaTagExtended = 7;
 
-    // Product code (bytes 10-11, little-endian)
-    info.product_code = data[10] | (static_cast<uint16_t>(data[11]) << 8);
+// CTA-861 extended tag codes
+constexpr uint8_t kCtaExtVendorSpecificVideo = 0x01;
+constexpr uint8_t kCtaExtColorimetry = 0x05;
+constexpr uint8_t kCtaExtHdrStaticMetadata = 0x06;
 
-    // Serial number (bytes 12-15, little-endian)
-    info.serial_number = data[12] | (data[13] << 8) | (data[14] << 16) | (data[15] << 24);
+float chroma10(uint8_t high, uint8_t low_bits, int shift) {
+    uint16_t v = static_cast<uint16_t>((high << 2) | ((low_bits >> shift) & 0x03));
+    return static_cast<float>(v) / 1024.0f;
+}
+
+void parse_chromaticity(std::span<const uint8_t> base, EdidInfo& info) {
+    uint8_t rg_low = base[25];
+    uint8_t bw_low = base[26];
+    info.red   = {chroma10(base[27], rg_low, 6), chroma10(base[28], rg_low, 4)};
+    info.green = {chroma10(base[29], rg_low, 2), chroma10(base[30], rg_low, 0)};
+    info.blue  = {chroma10(base[31], bw_low, 6), chroma10(base[32], bw_low, 4)};
+    info.white = {chroma10(base[33], bw_low, 2), chroma10(base[34], bw_low, 0)};
+}
 
+void parse_monitor_name(std::span<const uint8_t> base, EdidInfo& info) {
     // Monitor name from descriptor blocks (starting at byte 54, each 18 bytes)
-    for (int offset = 54; offset <= 108; offset += 18) {
-        if (data[offset] == 0 && data[offset + 1] == 0 && data[offset + 3] == 0xFC) {
-            char name_buf[14] = {};
-            std::memcpy(name_buf, &data[offset + 5], 13);
-            std::string name(name_buf);
+    for (size_t offset = 54; offset <= 108; offset += 18) {
+        if (base[offset] == 0 && base[offset + 1] == 0 && base[offset + 3] == 0xFC) {
+            auto text = base.subspan(offset + 5, 13);
+            size_t len = 0;
+            while (len < text.size() && text[len] != '\0') ++len;
             // Trim trailing whitespace and control chars
-            while (!name.empty() && (name.back() == '\n' || name.back() == '\r' ||
-                                      name.back() == ' ' || name.back() == '\0')) {
-                name.pop_back();
+            while (len > 0 && (text[len - 1] == '\n' || text[len - 1] == '\r' ||
+                               text[len - 1] == ' ')) {
+                --len;
             }
-            info.monitor_name = name;
+            info.monitor_name.assign(reinterpret_cast<const char*>(text.data()), len);
             break;
         }
     }
+}
+
+// CTA-861.3: max = 50 * 2^(CV/32), min = max * (CV/255)^2 / 100
+float cta_max_luminance(uint8_t cv) {
+    return 50.0f * std::pow(2.0f, static_cast<float>(cv) / 32.0f);
+}
+
+float cta_min_luminance(uint8_t cv, float max_luminance) {
+    float ratio = static_cast<float>(cv) / 255.0f;
+    return max_luminance * ratio * ratio / 100.0f;
+}
+
+void parse_hdr_static_metadata(std::span<const uint8_t> payload, EdidInfo& info) {
+    // payload[0] is the extended tag itself
+    if (payload.size() < 3) return;
+    HdrStaticMetadata hdr{};
+    hdr.eotf_flags = payload[1];
+    hdr.metadata_descriptors = payload[2];
+    if (payload.size() > 3 && payload[3] != 0)
+        hdr.max_luminance = cta_max_luminance(payload[3]);
+    if (payload.size() > 4 && payload[4] != 0)
+        hdr.max_frame_avg_luminance = cta_max_luminance(payload[4]);
+    if (payload.size() > 5 && hdr.max_luminance > 0.0f)
+        hdr.min_luminance = cta_min_luminance(payload[5], hdr.max_luminance);
+    info.hdr = hdr;
+    info.has_hdr_static_metadata = true;
+}
+
+void parse_vendor_specific(std::span<const uint8_t> payload, EdidInfo& info) {
+    if (payload.size() < 3) return;
+    uint32_t oui = read_le24(payload, 0);
+    auto& vendor = info.vendor;
+
+    if (oui == kOuiHdmi) {
+        vendor.has_hdmi = true;
+        if (payload.size() >= 5)
+            vendor.hdmi_physical_address = static_cast<uint16_t>((payload[3] << 8) | payload[4]);
+        if (payload.size() >= 6) {
+            vendor.hdmi_deep_color_30 = payload[5] & 0x10;
+            vendor.hdmi_deep_color_36 = payload[5] & 0x20;
+        }
+        if (payload.size() >= 7)
+            vendor.hdmi_max_tmds_mhz = payload[6] * 5u;
+    } else if (oui == kOuiHdmiForum) {
+        vendor.has_hdmi_forum = true;
+        if (payload.size() >= 5)
+            vendor.hdmi_forum_max_tmds_mhz = payload[4] * 5u;
+        if (payload.size() >= 7)
+            vendor.hdmi_forum_max_frl_rate = static_cast<uint8_t>(payload[6] >> 4);
+    } else if (vendor.unknown_block_count < 0xFF) {
+        ++vendor.unknown_block_count;
+    }
+}
+
+void parse_vendor_specific_video(std::span<const uint8_t> payload, EdidInfo& info) {
+    // payload[0] is the extended tag, the OUI follows
+    if (payload.size() < 4) return;
+    uint32_t oui = read_le24(payload, 1);
+    if (oui == kOuiDolbyVision) {
+        info.vendor.has_dolby_vision = true;
+    } else if (oui == kOuiHdr10Plus) {
+        info.vendor.has_hdr10_plus = true;
+    } else if (info.vendor.unknown_block_count < 0xFF) {
+        ++info.vendor.unknown_block_count;
+    }
+}
+
+void parse_cta_extension(std::span<const uint8_t> block, EdidInfo& info) {
+    info.has_cta_extension = true;
+
+    // Byte 2 is the offset of the first detailed timing descriptor; the data
+    // block collection occupies bytes 4 .. dtd_offset-1 (revision 3+).
+    size_t dtd_offset = block[2];
+    if (block[1] < 3 || dtd_offset < 4 || dtd_offset > kEdidBlockSize - 1)
+        return;
+
+    for_each_cta_data_block(block.subspan(4, dtd_offset - 4),
+        [&](uint8_t tag, std::span<const uint8_t> payload) {
+            if (tag == kCtaTagVendorSpecific) {
+                parse_vendor_specific(payload, info);
+                return;
+            }
+            if (tag != kCtaTagExtended || payload.empty())
+                return;
+            switch (payload[0]) {
+                case kCtaExtColorimetry:
+                    if (payload.size() >= 2)
+                        info.colorimetry = payload[1];
+                    if (payload.size() >= 3)
+                        info.colorimetry |= static_cast<uint16_t>(payload[2] << 8);
+                    break;
+                case kCtaExtHdrStaticMetadata:
+                    parse_hdr_static_metadata(payload, info);
+                    break;
+                case kCtaExtVendorSpecificVideo:
+                    parse_vendor_specific_video(payload, info);
+                    break;
+                default:
+                    break;
+            }
+        });
+}
+
+} // anonymous namespace
+
+std::string decode_manufacturer_id(uint16_t mfg) {
+    char c1 = static_cast<char>(((mfg >> 10) & 0x1F) + 'A' - 1);
+    char c2 = static_cast<char>(((mfg >> 5) & 0x1F) + 'A' - 1);
+    char c3 = static_cast<char>((mfg & 0x1F) + 'A' - 1);
+    return {c1, c2, c3};
+}
+
+uint16_t encode_manufacturer_id(std::string_view code) {
+    if (code.size() != 3) return 0;
+    uint16_t id = 0;
+    for (char c : code) {
+        id = static_cast<uint16_t>((id << 5) | ((c - 'A' + 1) & 0x1F));
+    }
+    return id;
+}
+
+std::optional<EdidInfo> parse_edid(std::span<const uint8_t> data) {
+    if (data.size() < kEdidBlockSize)
+        return std::nullopt;
+
+    EdidInfo info{};
+    auto base = edid_block(data, 0);
+
+    // Manufacturer ID (bytes 8-9, compressed 3-letter ASCII)
+    info.manufacturer_id = static_cast<uint16_t>((base[8] << 8) | base[9]);
+    info.manufacturer = decode_manufacturer_id(info.manufacturer_id);
+
+    // Product code (bytes 10-11, little-endian)
+    info.product_code = read_le16(base, 10);
+
+    // Serial number (bytes 12-15, little-endian)
+    info.serial_number = static_cast<uint32_t>(base[12]) |
+                         (static_cast<uint32_t>(base[13]) << 8) |
+                         (static_cast<uint32_t>(base[14]) << 16) |
+                         (static_cast<uint32_t>(base[15]) << 24);
+
+    parse_chromaticity(base, info);
+    parse_monitor_name(base, info);
+
+    info.checksums_valid = true;
+    for_each_edid_block(data, [&](size_t index, std::span<const uint8_t> block) {
+        bool valid = checksum_valid(block);
+        if (!valid) info.checksums_valid = false;
+        if (index == 0) return;
+
+        ++info.extension_count;
+        if (!valid) return;
+        if (block[0] == kCtaExtensionTag) {
+            parse_cta_extension(block, info);
+        } else if (block[0] == kDisplayIdExtensionTag) {
+            if (parse_displayid_extension(block, info.displayid))
+                info.has_displayid = true;
+        }
+    });
 
     return info;
 }
 
+std::optional<PanelLuminance> panel_luminance(const EdidInfo& info) {
+    const auto& params = info.displayid.params;
+    if (info.has_displayid && info.displayid.has_display_parameters &&
+        params.max_luminance > 0.0f) {
+        return PanelLuminance{params.max_luminance, params.max_full_frame_luminance,
+                              params.min_luminance};
+    }
+    if (info.has_hdr_static_metadata && info.hdr.max_luminance > 0.0f) {
+        return PanelLuminance{info.hdr.max_luminance, info.hdr.max_frame_avg_luminance,
+                              info.hdr.min_luminance};
+    }
+    return std::nullopt;
+}
+
+std::optional<EdidInfo> parse_edid(const uint8_t* data, size_t length) {
+    if (!data)
+        return std::nullopt;
+    return parse_edid(std::span<const uint8_t>(data, length));
+}
+
 } // namespace hdrfixer::display
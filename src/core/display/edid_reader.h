@@ -1,18 +1,110 @@
 #pragma once
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <span>
+#include "edid_blocks.h"
+#include "displayid_reader.h"
 
 namespace hdrfixer::display {
 
+// CTA-861.3 HDR Static Metadata data block (extended tag 0x06).
+// Luminance values are in cd/m2; 0 means the sink did not report it.
+struct HdrStaticMetadata {
+    uint8_t eotf_flags = 0;
+    uint8_t metadata_descriptors = 0;
+    float max_luminance = 0.0f;
+    float max_frame_avg_luminance = 0.0f;
+    float min_luminance = 0.0f;
+
+    bool supports_sdr() const { return eotf_flags & 0x01; }
+    bool supports_pq() const { return eotf_flags & 0x04; }
+    bool supports_hlg() const { return eotf_flags & 0x08; }
+};
+
+// CTA-861 Colorimetry data block (extended tag 0x05): payload byte 1 in
+// the low byte, payload byte 2 in the high byte.
+inline constexpr uint16_t kColorimetryXvYcc601 = 0x0001;
+inline constexpr uint16_t kColorimetryXvYcc709 = 0x0002;
+inline constexpr uint16_t kColorimetrySYcc601  = 0x0004;
+inline constexpr uint16_t kColorimetryOpYcc601 = 0x0008;
+inline constexpr uint16_t kColorimetryOpRgb    = 0x0010;
+inline constexpr uint16_t kColorimetryBt2020cYcc = 0x0020;
+inline constexpr uint16_t kColorimetryBt2020Ycc  = 0x0040;
+inline constexpr uint16_t kColorimetryBt2020Rgb  = 0x0080;
+inline constexpr uint16_t kColorimetryIctcp      = 0x4000;
+inline constexpr uint16_t kColorimetryDciP3      = 0x8000;
+
+// IEEE OUIs of the vendor-specific blocks we decode.
+inline constexpr uint32_t kOuiHdmi = 0x000C03;
+inline constexpr uint32_t kOuiHdmiForum = 0xC45DD8;
+inline constexpr uint32_t kOuiDolbyVision = 0x00D046;
+inline constexpr uint32_t kOuiHdr10Plus = 0x90848B;
+
+// Decoded CTA-861 vendor-specific data (VSDB and vendor-specific video
+// blocks).  Unknown OUIs are only counted.
+struct VendorSpecificInfo {
+    bool has_hdmi = false;
+    uint16_t hdmi_physical_address = 0;
+    bool hdmi_deep_color_30 = false;
+    bool hdmi_deep_color_36 = false;
+    uint32_t hdmi_max_tmds_mhz = 0;
+
+    bool has_hdmi_forum = false;
+    uint32_t hdmi_forum_max_tmds_mhz = 0;
+    uint8_t hdmi_forum_max_frl_rate = 0;
+
+    bool has_dolby_vision = false;
+    bool has_hdr10_plus = false;
+    uint8_t unknown_block_count = 0;
+};
+
 struct EdidInfo {
     std::string manufacturer;
+    uint16_t manufacturer_id = 0;   // raw big-endian EISA id from bytes 8-9
     uint16_t product_code = 0;
     std::string monitor_name;
     uint32_t serial_number = 0;
+
+    // Base block chromaticity coordinates (bytes 25-34, 10-bit precision)
+    Chromaticity red;
+    Chromaticity green;
+    Chromaticity blue;
+    Chromaticity white;
+
+    uint8_t extension_count = 0;    // extension blocks actually present
+    bool checksums_valid = false;   // every present block sums to zero
+
+    bool has_cta_extension = false;
+    bool has_hdr_static_metadata = false;
+    HdrStaticMetadata hdr;
+    uint16_t colorimetry = 0;
+    VendorSpecificInfo vendor;
+
+    bool has_displayid = false;
+    DisplayIdInfo displayid;
 };
 
+// Panel luminance as reported by the EDID, preferring DisplayID Display
+// Parameters over CTA-861 HDR static metadata.  Values are in cd/m2.
+struct PanelLuminance {
+    float max_luminance = 0.0f;
+    float max_full_frame_luminance = 0.0f;
+    float min_luminance = 0.0f;
+};
+
+std::optional<PanelLuminance> panel_luminance(const EdidInfo& info);
+
+// Parses the base block and every extension block present in the buffer
+// (CTA-861 and DisplayID).
+// Extension blocks with a bad checksum are skipped; the base block is
+// decoded regardless so identity fields remain available.
+std::optional<EdidInfo> parse_edid(std::span<const uint8_t> data);
 std::optional<EdidInfo> parse_edid(const uint8_t* data, size_t length);
 
+// Pack/unpack the compressed 3-letter EISA manufacturer id.
+std::string decode_manufacturer_id(uint16_t id);
+uint16_t encode_manufacturer_id(std::string_view code);
+
 } // namespace hdrfixer::display
@@ -0,0 +1,289 @@
+#include "edid_validator.h"
+#include "edid_blocks.h"
+#include <cmath>
+#include <cstdio>
+
+namespace hdrfixer::display {
+
+namespace {
+
+constexpr uint8_t kEdidHeader[8] = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+constexpr uint8_t kCtaExtensionTag = 0x02;
+constexpr uint8_t kDisplayIdExtensionTag = 0x70;
+
+// Relative luminance disagreement tolerated between EDID and DXGI
+constexpr float kLuminanceTolerance = 0.25f;
+// Absolute CIE xy disagreement tolerated between EDID and DXGI
+constexpr float kChromaticityTolerance = 0.02f;
+
+void add(EdidReport& report, EdidIssueSeverity severity, std::string message) {
+    report.issues.push_back({severity, std::move(message)});
+}
+
+std::string fmt_float(float v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.4g", static_cast<double>(v));
+    return buf;
+}
+
+bool in_unit_range(const Chromaticity& c) {
+    return c.x > 0.0f && c.x < 0.8f && c.y > 0.0f && c.y < 0.9f;
+}
+
+void check_chromaticity(const EdidInfo& info, EdidReport& report) {
+    struct Point { const char* name; const Chromaticity& xy; };
+    const Point points[] = {
+        {"red", info.red}, {"green", info.green},
+        {"blue", info.blue}, {"white", info.white},
+    };
+    bool all_zero = true;
+    for (const auto& p : points) {
+        if (p.xy.x != 0.0f || p.xy.y != 0.0f) all_zero = false;
+    }
+    if (all_zero) {
+        add(report, EdidIssueSeverity::Warning, "Chromaticity coordinates are all zero");
+        return;
+    }
+
+    for (const auto& p : points) {
+        if (!in_unit_range(p.xy)) {
+            add(report, EdidIssueSeverity::Error,
+                std::string("Implausible ") + p.name + " chromaticity (" +
+                fmt_float(p.xy.x) + ", " + fmt_float(p.xy.y) + ")");
+        }
+    }
+
+    // Primaries must form a counter-clockwise triangle (R -> G -> B)
+    float area = (info.green.x - info.red.x) * (info.blue.y - info.red.y) -
+                 (info.blue.x - info.red.x) * (info.green.y - info.red.y);
+    if (area <= 0.0f) {
+        add(report, EdidIssueSeverity::Error, "Primaries do not form a valid gamut triangle");
+    }
+
+    // White point should sit near the daylight locus (D50..D93)
+    if (info.white.x < 0.26f || info.white.x > 0.36f ||
+        info.white.y < 0.27f || info.white.y > 0.38f) {
+        add(report, EdidIssueSeverity::Warning,
+            "White point (" + fmt_float(info.white.x) + ", " + fmt_float(info.white.y) +
+            ") is far from the daylight locus");
+    }
+}
+
+void check_luminance(const EdidInfo& info, EdidReport& report) {
+    auto lum = panel_luminance(info);
+    if (!lum) return;
+
+    if (lum->max_luminance < 80.0f || lum->max_luminance > 10000.0f) {
+        add(report, EdidIssueSeverity::Error,
+            "Implausible max luminance " + fmt_float(lum->max_luminance) + " nits");
+    }
+    if (lum->max_full_frame_luminance > lum->max_luminance * 1.001f) {
+        add(report, EdidIssueSeverity::Warning,
+            "Full-frame luminance " + fmt_float(lum->max_full_frame_luminance) +
+            " nits exceeds peak " + fmt_float(lum->max_luminance) + " nits");
+    }
+    if (lum->min_luminance < 0.0f || lum->min_luminance >= lum->max_luminance ||
+        lum->min_luminance > 10.0f) {
+        add(report, EdidIssueSeverity::Error,
+            "Implausible min luminance " + fmt_float(lum->min_luminance) + " nits");
+    }
+}
+
+void check_base_block(std::span<const uint8_t> base, EdidReport& report) {
+    for (size_t i = 0; i < sizeof(kEdidHeader); ++i) {
+        if (base[i] != kEdidHeader[i]) {
+            add(report, EdidIssueSeverity::Error, "Base block header pattern is invalid");
+            break;
+        }
+    }
+
+    // Manufacturer id: bit 15 reserved, each letter 1..26
+    uint16_t mfg = static_cast<uint16_t>((base[8] << 8) | base[9]);
+    if (mfg & 0x8000) {
+        add(report, EdidIssueSeverity::Warning, "Manufacturer id reserved bit is set");
+    }
+    for (int shift : {10, 5, 0}) {
+        int letter = (mfg >> shift) & 0x1F;
+        if (letter < 1 || letter > 26) {
+            add(report, EdidIssueSeverity::Error, "Manufacturer id is not three letters");
+            break;
+        }
+    }
+
+    uint8_t version = base[18];
+    uint8_t revision = base[19];
+    if (version != 1 || revision > 4) {
+        add(report, EdidIssueSeverity::Error,
+            "Unsupported EDID version " + std::to_string(version) + "." +
+            std::to_string(revision));
+    }
+
+    // EDID 1.4 digital input: bit depth 0b111 and interface >= 6 are reserved
+    uint8_t input = base[20];
+    if (version == 1 && revision >= 4 && (input & 0x80)) {
+        if (((input >> 4) & 0x07) == 0x07) {
+            add(report, EdidIssueSeverity::Warning, "Video input bit depth uses a reserved value");
+        }
+        if ((input & 0x0F) > 5) {
+            add(report, EdidIssueSeverity::Warning, "Video interface uses a reserved value");
+        }
+    }
+}
+
+} // anonymous namespace
+
+bool EdidReport::has_errors() const {
+    return error_count() > 0;
+}
+
+size_t EdidReport::error_count() const {
+    size_t n = 0;
+    for (const auto& issue : issues) {
+        if (issue.severity == EdidIssueSeverity::Error) ++n;
+    }
+    return n;
+}
+
+size_t EdidReport::warning_count() const {
+    return issues.size() - error_count();
+}
+
+std::string EdidReport::summary() const {
+    std::string out = std::to_string(error_count()) + " error(s), " +
+                      std::to_string(warning_count()) + " warning(s)";
+    for (size_t i = 0; i < issues.size(); ++i) {
+        out += i == 0 ? ": " : "; ";
+        out += issues[i].message;
+    }
+    return out;
+}
+
+EdidReport validate_edid(std::span<const uint8_t> edid) {
+    EdidReport report;
+    if (edid.size() < kEdidBlockSize) {
+        add(report, EdidIssueSeverity::Error,
+            "EDID is " + std::to_string(edid.size()) + " bytes, shorter than one block");
+        return report;
+    }
+    if (edid.size() % kEdidBlockSize != 0) {
+        add(report, EdidIssueSeverity::Warning, "EDID length is not a multiple of 128 bytes");
+    }
+
+    check_base_block(edid_block(edid, 0), report);
+
+    size_t declared = 1 + static_cast<size_t>(edid[126]);
+    if (declared > edid.size() / kEdidBlockSize) {
+        add(report, EdidIssueSeverity::Error,
+            "Base block declares " + std::to_string(declared - 1) +
+            " extension(s) but only " + std::to_string(edid.size() / kEdidBlockSize - 1) +
+            " are present");
+    }
+
+    for_each_edid_block(edid, [&](size_t index, std::span<const uint8_t> block) {
+        if (!checksum_valid(block)) {
+            add(report, EdidIssueSeverity::Error,
+                "Block " + std::to_string(index) + " checksum is invalid");
+            return;
+        }
+        if (index == 0) return;
+        if (block[0] == kCtaExtensionTag && (block[1] == 0 || block[1] > 3)) {
+            add(report, EdidIssueSeverity::Warning,
+                "CTA-861 block " + std::to_string(index) + " has unknown revision " +
+                std::to_string(block[1]));
+        }
+        if (block[0] == kDisplayIdExtensionTag) {
+            DisplayIdInfo displayid{};
+            if (!parse_displayid_extension(block, displayid) || displayid.truncated) {
+                add(report, EdidIssueSeverity::Error,
+                    "DisplayID block " + std::to_string(index) + " is malformed");
+            }
+        }
+    });
+
+    auto info = parse_edid(edid);
+    if (info) {
+        check_chromaticity(*info, report);
+        check_luminance(*info, report);
+    }
+    return report;
+}
+
+void cross_check_edid(const EdidInfo& info, const ReportedCapabilities& reported,
+                      EdidReport& report) {
+    auto lum = panel_luminance(info);
+    if (lum && reported.max_luminance > 0.0f && lum->max_luminance > 0.0f) {
+        float diff = std::abs(lum->max_luminance - reported.max_luminance) / lum->max_luminance;
+        if (diff > kLuminanceTolerance) {
+            add(report, EdidIssueSeverity::Warning,
+                "DXGI max luminance " + fmt_float(reported.max_luminance) +
+                " nits differs from EDID " + fmt_float(lum->max_luminance) + " nits");
+        }
+    }
+
+    struct Point { const char* name; const Chromaticity& edid_xy; const Chromaticity& os_xy; };
+    const Point points[] = {
+        {"red", info.red, reported.red},
+        {"green", info.green, reported.green},
+        {"blue", info.blue, reported.blue},
+        {"white", info.white, reported.white},
+    };
+    for (const auto& p : points) {
+        if (p.os_xy.x == 0.0f && p.os_xy.y == 0.0f) continue;
+        if (p.edid_xy.x == 0.0f && p.edid_xy.y == 0.0f) continue;
+        if (std::abs(p.edid_xy.x - p.os_xy.x) > kChromaticityTolerance ||
+            std::abs(p.edid_xy.y - p.os_xy.y) > kChromaticityTolerance) {
+            add(report, EdidIssueSeverity::Warning,
+                std::string("DXGI ") + p.name + " chromaticity differs from EDID");
+        }
+    }
+}
+
+EdidReport EdidValidationCache::validate(std::span<const uint8_t> edid,
+                                         const ReportedCapabilities& reported) {
+    uint64_t key = edid_hash(
+        std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(&reported), sizeof(reported)),
+        edid_hash(edid));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = reports_.find(key);
+        if (it != reports_.end()) {
+            ++hits_;
+            return it->second;
+        }
+        ++misses_;
+    }
+
+    auto report = validate_edid(edid);
+    if (auto info = parse_edid(edid)) {
+        cross_check_edid(*info, reported, report);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    reports_.emplace(key, report);
+    return report;
+}
+
+size_t EdidValidationCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reports_.size();
+}
+
+size_t EdidValidationCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t EdidValidationCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+void EdidValidationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reports_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+
+} // namespace hdrfixer::display
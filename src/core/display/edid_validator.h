@@ -0,0 +1,71 @@
+#pragma once
+#include "edid_reader.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <span>
+
+namespace hdrfixer::display {
+
+enum class EdidIssueSeverity {
+    Warning,
+    Error
+};
+
+struct EdidIssue {
+    EdidIssueSeverity severity;
+    std::string message;
+};
+
+struct EdidReport {
+    std::vector<EdidIssue> issues;
+
+    bool has_errors() const;
+    size_t warning_count() const;
+    size_t error_count() const;
+    // "N error(s), M warning(s): first message; second message; ..."
+    std::string summary() const;
+};
+
+// Capabilities the OS reports for the same panel (from DXGI), used to
+// cross-check the EDID.  Zero luminance / chromaticity means "unknown".
+struct ReportedCapabilities {
+    float max_luminance = 0.0f;
+    float min_luminance = 0.0f;
+    float max_full_frame_luminance = 0.0f;
+    Chromaticity red;
+    Chromaticity green;
+    Chromaticity blue;
+    Chromaticity white;
+};
+
+// Structural checks (header, block checksums, version, reserved bits,
+// declared extension count) plus luminance and chromaticity plausibility.
+EdidReport validate_edid(std::span<const uint8_t> edid);
+
+// Append issues where the EDID disagrees with what DXGI reports.
+void cross_check_edid(const EdidInfo& info, const ReportedCapabilities& reported,
+                      EdidReport& report);
+
+// Caches validation reports keyed by the EDID bytes and the reported
+// capabilities, so repeated diagnoses cost one hash and one lookup.
+// Thread-safe.
+class EdidValidationCache {
+public:
+    EdidReport validate(std::span<const uint8_t> edid, const ReportedCapabilities& reported);
+
+    size_t size() const;
+    size_t hits() const;
+    size_t misses() const;
+    void clear();
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, EdidReport> reports_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
+
+} // namespace hdrfixer::display
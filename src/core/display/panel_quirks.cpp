@@ -0,0 +1,346 @@
+#include "panel_quirks.h"
+#include "edid_reader.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hdrfixer::display {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Little-endian encoding helpers
+// ---------------------------------------------------------------------------
+
+void put_le16(std::vector<uint8_t>& buf, uint16_t v) {
+    buf.push_back(static_cast<uint8_t>(v & 0xFF));
+    buf.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void put_le32(std::vector<uint8_t>& buf, uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        buf.push_back(static_cast<uint8_t>((v >> (i * 8)) & 0xFF));
+}
+
+void put_float(std::vector<uint8_t>& buf, float f) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &f, sizeof(bits));
+    put_le32(buf, bits);
+}
+
+uint32_t get_le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+float get_float(const uint8_t* p) {
+    uint32_t bits = get_le32(p);
+    float f = 0.0f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// Sort key: manufacturer in the high half so records group by vendor
+uint32_t quirk_key(uint16_t manufacturer_id, uint16_t product_code) {
+    return (static_cast<uint32_t>(manufacturer_id) << 16) | product_code;
+}
+
+void encode_record(std::vector<uint8_t>& buf, const PanelQuirk& q) {
+    put_le32(buf, quirk_key(q.manufacturer_id, q.product_code));
+    put_le32(buf, q.flags);
+    put_float(buf, q.max_luminance);
+    put_float(buf, q.min_luminance);
+    put_float(buf, q.max_full_frame_luminance);
+    for (const float* xy : {q.red_primary, q.green_primary, q.blue_primary, q.white_point}) {
+        put_float(buf, xy[0]);
+        put_float(buf, xy[1]);
+    }
+}
+
+PanelQuirk decode_record(const uint8_t* p) {
+    PanelQuirk q{};
+    uint32_t key = get_le32(p);
+    q.manufacturer_id = static_cast<uint16_t>(key >> 16);
+    q.product_code = static_cast<uint16_t>(key & 0xFFFF);
+    q.flags = get_le32(p + 4);
+    q.max_luminance = get_float(p + 8);
+    q.min_luminance = get_float(p + 12);
+    q.max_full_frame_luminance = get_float(p + 16);
+    size_t offset = 20;
+    for (float* xy : {q.red_primary, q.green_primary, q.blue_primary, q.white_point}) {
+        xy[0] = get_float(p + offset);
+        xy[1] = get_float(p + offset + 4);
+        offset += 8;
+    }
+    return q;
+}
+
+// ---------------------------------------------------------------------------
+// Text source parsing
+// ---------------------------------------------------------------------------
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+std::string_view next_token(std::string_view& line) {
+    line = trim(line);
+    auto end = line.find_first_of(" \t");
+    auto token = line.substr(0, end);
+    line = end == std::string_view::npos ? std::string_view{} : line.substr(end);
+    return token;
+}
+
+bool parse_float(std::string_view s, float& out) {
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc{} && ptr == s.data() + s.size();
+}
+
+bool parse_xy(std::string_view s, float xy[2]) {
+    auto comma = s.find(',');
+    if (comma == std::string_view::npos) return false;
+    return parse_float(s.substr(0, comma), xy[0]) && parse_float(s.substr(comma + 1), xy[1]);
+}
+
+bool parse_product_code(std::string_view s, uint16_t& out) {
+    int base = 10;
+    if (s.size() > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+        s.remove_prefix(2);
+        base = 16;
+    }
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out, base);
+    return ec == std::errc{} && ptr == s.data() + s.size();
+}
+
+std::expected<PanelQuirk, std::string> parse_quirk_line(std::string_view line) {
+    PanelQuirk q{};
+
+    auto mfg = next_token(line);
+    if (mfg.size() != 3 || !std::all_of(mfg.begin(), mfg.end(),
+                                        [](char c) { return c >= 'A' && c <= 'Z'; })) {
+        return std::unexpected("invalid manufacturer '" + std::string(mfg) + "'");
+    }
+    q.manufacturer_id = encode_manufacturer_id(mfg);
+
+    auto product = next_token(line);
+    if (!parse_product_code(product, q.product_code))
+        return std::unexpected("invalid product code '" + std::string(product) + "'");
+
+    for (auto token = next_token(line); !token.empty(); token = next_token(line)) {
+        auto eq = token.find('=');
+        if (eq == std::string_view::npos)
+            return std::unexpected("expected key=value, got '" + std::string(token) + "'");
+        auto key = token.substr(0, eq);
+        auto value = token.substr(eq + 1);
+
+        bool ok = false;
+        if (key == "max_luminance") {
+            ok = parse_float(value, q.max_luminance);
+            q.flags |= kQuirkMaxLuminance;
+        } else if (key == "min_luminance") {
+            ok = parse_float(value, q.min_luminance);
+            q.flags |= kQuirkMinLuminance;
+        } else if (key == "full_frame_luminance") {
+            ok = parse_float(value, q.max_full_frame_luminance);
+            q.flags |= kQuirkFullFrameLuminance;
+        } else if (key == "red") {
+            ok = parse_xy(value, q.red_primary);
+            q.flags |= kQuirkRedPrimary;
+        } else if (key == "green") {
+            ok = parse_xy(value, q.green_primary);
+            q.flags |= kQuirkGreenPrimary;
+        } else if (key == "blue") {
+            ok = parse_xy(value, q.blue_primary);
+            q.flags |= kQuirkBluePrimary;
+        } else if (key == "white") {
+            ok = parse_xy(value, q.white_point);
+            q.flags |= kQuirkWhitePoint;
+        } else {
+            return std::unexpected("unknown key '" + std::string(key) + "'");
+        }
+        if (!ok)
+            return std::unexpected("invalid value for '" + std::string(key) + "'");
+    }
+
+    if (q.flags == 0)
+        return std::unexpected("no overrides given");
+    return q;
+}
+
+// ---------------------------------------------------------------------------
+// File mapping
+// ---------------------------------------------------------------------------
+
+struct Mapping {
+    std::shared_ptr<const void> owner;
+    std::span<const uint8_t> bytes;
+};
+
+std::expected<Mapping, std::string> map_file(const std::filesystem::path& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return std::unexpected("Failed to open quirks database: " + path.string());
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(kQuirksHeaderSize)) {
+        CloseHandle(file);
+        return std::unexpected("Quirks database is too small: " + path.string());
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return std::unexpected("Failed to map quirks database: " + path.string());
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view)
+        return std::unexpected("Failed to map quirks database view: " + path.string());
+
+    Mapping m;
+    m.owner = std::shared_ptr<const void>(view, [](const void* p) { UnmapViewOfFile(p); });
+    m.bytes = {static_cast<const uint8_t*>(view), static_cast<size_t>(size.QuadPart)};
+    return m;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return std::unexpected("Failed to open quirks database: " + path.string());
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kQuirksHeaderSize)) {
+        ::close(fd);
+        return std::unexpected("Quirks database is too small: " + path.string());
+    }
+
+    size_t length = static_cast<size_t>(st.st_size);
+    void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+        return std::unexpected("Failed to map quirks database: " + path.string());
+
+    Mapping m;
+    m.owner = std::shared_ptr<const void>(view, [length](const void* p) {
+        ::munmap(const_cast<void*>(p), length);
+    });
+    m.bytes = {static_cast<const uint8_t*>(view), length};
+    return m;
+#endif
+}
+
+} // anonymous namespace
+
+std::expected<std::vector<uint8_t>, std::string> compile_quirks(std::string_view source) {
+    std::vector<PanelQuirk> quirks;
+    size_t line_no = 0;
+
+    while (!source.empty()) {
+        auto nl = source.find('\n');
+        auto line = source.substr(0, nl);
+        source = nl == std::string_view::npos ? std::string_view{} : source.substr(nl + 1);
+        ++line_no;
+
+        auto hash = line.find('#');
+        if (hash != std::string_view::npos) line = line.substr(0, hash);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        auto quirk = parse_quirk_line(line);
+        if (!quirk)
+            return std::unexpected("line " + std::to_string(line_no) + ": " + quirk.error());
+        quirks.push_back(*quirk);
+    }
+
+    std::sort(quirks.begin(), quirks.end(), [](const PanelQuirk& a, const PanelQuirk& b) {
+        return quirk_key(a.manufacturer_id, a.product_code) <
+               quirk_key(b.manufacturer_id, b.product_code);
+    });
+    for (size_t i = 1; i < quirks.size(); ++i) {
+        const auto& q = quirks[i];
+        if (quirk_key(q.manufacturer_id, q.product_code) ==
+            quirk_key(quirks[i - 1].manufacturer_id, quirks[i - 1].product_code)) {
+            return std::unexpected("duplicate entry for " +
+                                   decode_manufacturer_id(q.manufacturer_id) + " " +
+                                   std::to_string(q.product_code));
+        }
+    }
+
+    std::vector<uint8_t> out;
+    out.reserve(kQuirksHeaderSize + quirks.size() * kQuirksRecordSize);
+    put_le32(out, kQuirksMagic);
+    put_le16(out, kQuirksVersion);
+    put_le16(out, static_cast<uint16_t>(kQuirksRecordSize));
+    put_le32(out, static_cast<uint32_t>(quirks.size()));
+    put_le32(out, 0); // reserved
+    for (const auto& q : quirks) encode_record(out, q);
+    return out;
+}
+
+std::expected<QuirksDatabase, std::string> QuirksDatabase::from_bytes(std::span<const uint8_t> bytes) {
+    if (bytes.size() < kQuirksHeaderSize)
+        return std::unexpected("Quirks database header truncated");
+    if (get_le32(bytes.data()) != kQuirksMagic)
+        return std::unexpected("Not a quirks database (bad magic)");
+
+    uint16_t version = static_cast<uint16_t>(bytes[4] | (bytes[5] << 8));
+    uint16_t record_size = static_cast<uint16_t>(bytes[6] | (bytes[7] << 8));
+    if (version != kQuirksVersion || record_size != kQuirksRecordSize)
+        return std::unexpected("Unsupported quirks database version " + std::to_string(version));
+
+    size_t count = get_le32(bytes.data() + 8);
+    size_t available = (bytes.size() - kQuirksHeaderSize) / kQuirksRecordSize;
+    if (count > available)
+        return std::unexpected("Quirks database truncated: " + std::to_string(count) +
+                               " records declared, " + std::to_string(available) + " present");
+
+    QuirksDatabase db;
+    db.records_ = bytes.subspan(kQuirksHeaderSize, count * kQuirksRecordSize);
+    db.count_ = count;
+    return db;
+}
+
+std::expected<QuirksDatabase, std::string> QuirksDatabase::open(const std::filesystem::path& path) {
+    auto mapping = map_file(path);
+    if (!mapping)
+        return std::unexpected(mapping.error());
+
+    auto db = from_bytes(mapping->bytes);
+    if (!db)
+        return std::unexpected(db.error() + ": " + path.string());
+    db->mapping_ = std::move(mapping->owner);
+    return db;
+}
+
+std::optional<PanelQuirk> QuirksDatabase::lookup(uint16_t manufacturer_id, uint16_t product_code) const {
+    uint32_t key = quirk_key(manufacturer_id, product_code);
+    const uint8_t* base = records_.data();
+
+    // Binary search over fixed-size records straight from the mapping
+    size_t lo = 0, hi = count_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        uint32_t mid_key = get_le32(base + mid * kQuirksRecordSize);
+        if (mid_key < key) {
+            lo = mid + 1;
+        } else if (mid_key > key) {
+            hi = mid;
+        } else {
+            return decode_record(base + mid * kQuirksRecordSize);
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace hdrfixer::display
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <expected>
+#include <filesystem>
+#include <span>
+
+namespace hdrfixer::display {
+
+// Which override fields of a PanelQuirk are set.
+inline constexpr uint32_t kQuirkMaxLuminance       = 0x0001;
+inline constexpr uint32_t kQuirkMinLuminance       = 0x0002;
+inline constexpr uint32_t kQuirkFullFrameLuminance = 0x0004;
+inline constexpr uint32_t kQuirkRedPrimary         = 0x0008;
+inline constexpr uint32_t kQuirkWhitePoint         = 0x0010;
+inline constexpr uint32_t kQuirkGreenPrimary       = 0x0020;
+inline constexpr uint32_t kQuirkBluePrimary        = 0x0040;
+inline constexpr uint32_t kQuirkPrimaries = kQuirkRedPrimary | kQuirkGreenPrimary | kQuirkBluePrimary;
+
+// Known-bad panel data, keyed by the EDID (manufacturer, product code).
+struct PanelQuirk {
+    uint16_t manufacturer_id = 0;   // raw EISA id, see encode_manufacturer_id
+    uint16_t product_code = 0;
+    uint32_t flags = 0;
+    float max_luminance = 0.0f;
+    float min_luminance = 0.0f;
+    float max_full_frame_luminance = 0.0f;
+    float red_primary[2] = {};
+    float green_primary[2] = {};
+    float blue_primary[2] = {};
+    float white_point[2] = {};
+};
+
+// Binary layout: 16-byte header ("HDRQ", version, record size, count)
+// followed by fixed-size little-endian records sorted by
+// (manufacturer_id, product_code), so lookups binary-search the mapping
+// directly without parsing or copying the file.
+inline constexpr uint32_t kQuirksMagic = 0x51524448; // "HDRQ"
+inline constexpr uint16_t kQuirksVersion = 2;  // 2: one flag per primary
+inline constexpr size_t kQuirksHeaderSize = 16;
+inline constexpr size_t kQuirksRecordSize = 52;
+
+// Compile the text source into the binary format.  One panel per line:
+//   DEL 0x4321 max_luminance=1000 min_luminance=0.0005 red=0.680,0.320
+// Keys: max_luminance, min_luminance, full_frame_luminance, red, green,
+// blue, white.  '#' starts a comment.  Duplicate panels are an error.
+std::expected<std::vector<uint8_t>, std::string> compile_quirks(std::string_view source);
+
+class QuirksDatabase {
+public:
+    QuirksDatabase() = default;
+
+    // Memory-map a compiled database; the mapping lives as long as any copy.
+    static std::expected<QuirksDatabase, std::string> open(const std::filesystem::path& path);
+
+    // View over caller-owned bytes, which must outlive the database.
+    static std::expected<QuirksDatabase, std::string> from_bytes(std::span<const uint8_t> bytes);
+
+    std::optional<PanelQuirk> lookup(uint16_t manufacturer_id, uint16_t product_code) const;
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+private:
+    std::shared_ptr<const void> mapping_;
+    std::span<const uint8_t> records_;
+    size_t count_ = 0;
+};
+
+} // namespace hdrfixer::display
@@ -0,0 +1,39 @@
+#include "adaptive_poll.h"
+#include <algorithm>
+
+namespace hdrfixer::fixes {
+
+AdaptivePoll::AdaptivePoll(AdaptivePollConfig config) : config_(config) {
+    config_.min_interval = std::max(config_.min_interval, std::chrono::milliseconds(1));
+    config_.max_interval = std::max(config_.max_interval, config_.min_interval);
+    config_.backoff_factor = std::max(config_.backoff_factor, 1u);
+    interval_ms_.store(config_.min_interval.count(), std::memory_order_relaxed);
+}
+
+void AdaptivePoll::record_check(bool drift) {
+    if (drift) {
+        interval_ms_.store(config_.min_interval.count(), std::memory_order_relaxed);
+        return;
+    }
+    // Only the UI thread records, so a plain load/store pair cannot lose
+    // an update
+    int64_t current = interval_ms_.load(std::memory_order_relaxed);
+    int64_t max = config_.max_interval.count();
+    int64_t next = current > max / config_.backoff_factor ? max : current * config_.backoff_factor;
+    interval_ms_.store(next, std::memory_order_relaxed);
+}
+
+void AdaptivePoll::set_paused(bool paused) {
+    paused_.store(paused, std::memory_order_relaxed);
+}
+
+std::chrono::milliseconds AdaptivePoll::interval() const {
+    return std::chrono::milliseconds(interval_ms_.load(std::memory_order_relaxed));
+}
+
+std::optional<AdaptivePoll::Clock::time_point> AdaptivePoll::next_poll(Clock::time_point last) const {
+    if (paused()) return std::nullopt;
+    return last + interval();
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace hdrfixer::fixes {
+
+struct AdaptivePollConfig {
+    // Interval after drift was found, and the starting point
+    std::chrono::milliseconds min_interval{std::chrono::seconds(60)};
+    // Ceiling the interval backs off to while checks keep finding nothing
+    std::chrono::milliseconds max_interval{std::chrono::minutes(30)};
+    unsigned backoff_factor = 2;
+};
+
+// Schedule for the watchdog's fallback re-checks.  Each check that finds
+// nothing to fix multiplies the interval by backoff_factor up to
+// max_interval; a check that finds drift snaps it back to min_interval.
+// While paused (session locked, display off) no poll is ever due.
+//
+// Thread-safe: the watchdog thread reads the schedule while the UI thread
+// records check results.
+class AdaptivePoll {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit AdaptivePoll(AdaptivePollConfig config = {});
+
+    void record_check(bool drift);
+    void set_paused(bool paused);
+
+    bool paused() const { return paused_.load(std::memory_order_relaxed); }
+    std::chrono::milliseconds interval() const;
+    // When the next poll is due if the last check ran at `last`; nullopt
+    // while paused
+    std::optional<Clock::time_point> next_poll(Clock::time_point last) const;
+    const AdaptivePollConfig& config() const { return config_; }
+
+private:
+    AdaptivePollConfig config_;
+    std::atomic<int64_t> interval_ms_;
+    std::atomic<bool> paused_{false};
+};
+
+} // namespace hdrfixer::fixes
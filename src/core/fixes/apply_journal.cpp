@@ -0,0 +1,195 @@
+#include "apply_journal.h"
+#include <fstream>
+#include <iterator>
+
+namespace hdrfixer::fixes {
+
+namespace {
+
+constexpr char kMagic[4] = {'H', 'D', 'R', 'J'};
+constexpr uint8_t kVersion = 1;
+
+constexpr char kBeginRecord = 'B';
+constexpr char kStartRecord = 'S';
+constexpr char kCommitRecord = 'C';
+
+void put_varint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+void put_string(std::string& out, const std::string& s) {
+    put_varint(out, s.size());
+    out += s;
+}
+
+// One varint per code unit: ASCII-heavy registry paths stay one byte per
+// character whatever the width of wchar_t
+void put_wstring(std::string& out, const std::wstring& s) {
+    put_varint(out, s.size());
+    for (wchar_t c : s) put_varint(out, static_cast<uint32_t>(c));
+}
+
+struct Reader {
+    const std::string& bytes;
+    size_t pos = 0;
+    bool ok = true;
+
+    bool at_end() const { return pos >= bytes.size(); }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= bytes.size()) break;
+            uint8_t b = static_cast<uint8_t>(bytes[pos++]);
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    // Lengths are bounded by what is left in the file, so a corrupt count
+    // cannot trigger a huge allocation
+    size_t length() {
+        uint64_t n = varint();
+        if (n > bytes.size() - pos) {
+            ok = false;
+            return 0;
+        }
+        return static_cast<size_t>(n);
+    }
+
+    std::string string() {
+        size_t n = length();
+        if (!ok) return {};
+        std::string s = bytes.substr(pos, n);
+        pos += n;
+        return s;
+    }
+
+    std::wstring wstring() {
+        size_t n = length();
+        std::wstring s;
+        s.reserve(n);
+        for (size_t i = 0; ok && i < n; ++i) s += static_cast<wchar_t>(varint());
+        return s;
+    }
+};
+
+bool read_step(Reader& r, JournalStep& step) {
+    step.fix = FixId{r.varint()};
+    step.owner = r.varint();
+    step.pre_state.name = r.string();
+    step.pre_state.created_at = std::chrono::system_clock::time_point(
+        std::chrono::system_clock::duration(static_cast<int64_t>(r.varint())));
+    size_t entries = r.length();
+    for (size_t i = 0; r.ok && i < entries; ++i) {
+        registry::BackupEntry entry;
+        entry.key_path = r.wstring();
+        entry.value_name = r.wstring();
+        entry.value_kind = static_cast<uint32_t>(r.varint());
+        entry.original_value = r.wstring();
+        step.pre_state.entries.push_back(std::move(entry));
+    }
+    return r.ok;
+}
+
+} // anonymous namespace
+
+ApplyJournal::ApplyJournal(std::filesystem::path path)
+    : path_(std::move(path)) {}
+
+std::expected<void, std::string> ApplyJournal::write(const std::string& bytes, bool truncate) {
+    std::error_code ec;
+    if (path_.has_parent_path()) std::filesystem::create_directories(path_.parent_path(), ec);
+
+    auto mode = std::ios::binary | (truncate ? std::ios::trunc : std::ios::app);
+    std::ofstream out(path_, mode);
+    if (!out.is_open()) {
+        return std::unexpected("Failed to open apply journal: " + path_.string());
+    }
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    out.flush();
+    if (!out.good()) {
+        return std::unexpected("Failed to write apply journal: " + path_.string());
+    }
+    return {};
+}
+
+std::expected<void, std::string> ApplyJournal::begin(const std::vector<JournalStep>& steps) {
+    std::string bytes(kMagic, sizeof(kMagic));
+    bytes += static_cast<char>(kVersion);
+    bytes += kBeginRecord;
+    put_varint(bytes, steps.size());
+    for (const auto& step : steps) {
+        put_varint(bytes, step.fix.value);
+        put_varint(bytes, step.owner);
+        put_string(bytes, step.pre_state.name);
+        put_varint(bytes, static_cast<uint64_t>(step.pre_state.created_at.time_since_epoch().count()));
+        put_varint(bytes, step.pre_state.entries.size());
+        for (const auto& entry : step.pre_state.entries) {
+            put_wstring(bytes, entry.key_path);
+            put_wstring(bytes, entry.value_name);
+            put_varint(bytes, entry.value_kind);
+            put_wstring(bytes, entry.original_value);
+        }
+    }
+    return write(bytes, true);
+}
+
+std::expected<void, std::string> ApplyJournal::mark_started(size_t step) {
+    std::string bytes(1, kStartRecord);
+    put_varint(bytes, step);
+    return write(bytes, false);
+}
+
+std::expected<void, std::string> ApplyJournal::commit() {
+    std::error_code ec;
+    if (!std::filesystem::exists(path_, ec)) return {};
+
+    // The commit record makes the journal inert even if the delete fails
+    auto sealed = write(std::string(1, kCommitRecord), false);
+    std::filesystem::remove(path_, ec);
+    if (!sealed && std::filesystem::exists(path_, ec)) return sealed;
+    return {};
+}
+
+std::expected<std::vector<JournalStep>, std::string> ApplyJournal::load() const {
+    std::error_code ec;
+    if (!std::filesystem::exists(path_, ec)) return std::vector<JournalStep>{};
+
+    std::ifstream in(path_, std::ios::binary);
+    if (!in.is_open()) {
+        return std::unexpected("Failed to open apply journal: " + path_.string());
+    }
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    // Crash before the begin record landed: nothing was applied
+    if (bytes.size() < sizeof(kMagic) + 2) return std::vector<JournalStep>{};
+    if (bytes.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) != 0 ||
+        static_cast<uint8_t>(bytes[4]) != kVersion || bytes[5] != kBeginRecord) {
+        return std::unexpected("Apply journal is corrupt: " + path_.string());
+    }
+
+    Reader r{bytes, 6};
+    std::vector<JournalStep> steps(r.length());
+    for (auto& step : steps) {
+        if (!read_step(r, step)) return std::vector<JournalStep>{};
+    }
+
+    while (!r.at_end()) {
+        char tag = bytes[r.pos++];
+        if (tag == kCommitRecord) return std::vector<JournalStep>{};
+        if (tag != kStartRecord) break;
+        uint64_t index = r.varint();
+        if (!r.ok) break;
+        if (index < steps.size()) steps[index].started = true;
+    }
+    return steps;
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,50 @@
+#pragma once
+#include "fix_id.h"
+#include "core/registry/backup_set.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <expected>
+
+namespace hdrfixer::fixes {
+
+// One fix of a transactional apply and the state it is about to overwrite.
+struct JournalStep {
+    FixId fix;
+    uint64_t owner = 0;
+    registry::BackupSet pre_state;   // name is the fix name
+    bool started = false;            // apply() was entered
+};
+
+// Append-only on-disk record of one transactional apply.  begin() writes
+// every step's pre-state in a single append; each step then appends a few
+// bytes before its fix runs, and commit() seals the transaction and deletes
+// the file.  A journal still present at startup belongs to an apply that
+// was interrupted.
+//
+// Records are varint-encoded; a torn trailing record (crash mid-write) is
+// ignored on load.
+class ApplyJournal {
+public:
+    explicit ApplyJournal(std::filesystem::path path);
+
+    const std::filesystem::path& path() const { return path_; }
+
+    // Start a new transaction, replacing any previous journal
+    std::expected<void, std::string> begin(const std::vector<JournalStep>& steps);
+    std::expected<void, std::string> mark_started(size_t step);
+    // Also used once a transaction has been rolled back: either way there
+    // is nothing left to recover
+    std::expected<void, std::string> commit();
+
+    // Steps of an uncommitted transaction; empty if there is none
+    std::expected<std::vector<JournalStep>, std::string> load() const;
+
+private:
+    std::expected<void, std::string> write(const std::string& bytes, bool truncate);
+
+    std::filesystem::path path_;
+};
+
+} // namespace hdrfixer::fixes
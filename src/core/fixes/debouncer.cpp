@@ -0,0 +1,60 @@
+#include "debouncer.h"
+#include <algorithm>
+
+namespace hdrfixer::fixes {
+
+Debouncer::Debouncer(DebounceConfig config) : config_(config) {
+    // With neither edge nothing would ever fire
+    if (!config_.leading && !config_.trailing) config_.trailing = true;
+}
+
+bool Debouncer::on_event(Clock::time_point now) {
+    events_.fetch_add(1, std::memory_order_relaxed);
+    last_event_ = now;
+
+    if (!in_burst_) {
+        in_burst_ = true;
+        if (config_.leading) {
+            fired_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    if (!pending_) {
+        pending_ = true;
+        oldest_pending_ = now;
+    }
+    return false;
+}
+
+std::optional<Debouncer::Clock::time_point> Debouncer::deadline() const {
+    if (!in_burst_) return std::nullopt;
+    auto quiet = last_event_ + config_.window;
+    if (!pending_) return quiet;
+    return std::min(quiet, oldest_pending_ + config_.max_latency);
+}
+
+bool Debouncer::poll(Clock::time_point now) {
+    if (!in_burst_) return false;
+
+    bool quiet = now >= last_event_ + config_.window;
+    bool overdue = pending_ && now >= oldest_pending_ + config_.max_latency;
+    if (!quiet && !overdue) return false;
+
+    // The latency cap fires whatever the edges; a quiet burst end only
+    // fires on the trailing edge
+    bool fire = pending_ && (overdue || config_.trailing);
+    pending_ = false;
+    if (quiet) in_burst_ = false;
+    if (fire) fired_.fetch_add(1, std::memory_order_relaxed);
+    return fire;
+}
+
+DebounceStats Debouncer::stats() const {
+    DebounceStats s;
+    s.events = events_.load(std::memory_order_relaxed);
+    s.fired = fired_.load(std::memory_order_relaxed);
+    s.suppressed = s.events > s.fired ? s.events - s.fired : 0;
+    return s;
+}
+
+} // namespace hdrfixer::fixes
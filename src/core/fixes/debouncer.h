@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace hdrfixer::fixes {
+
+struct DebounceConfig {
+    // A burst ends once no event has arrived for this long
+    std::chrono::milliseconds window{250};
+    // No event waits longer than this for a fire, even while a burst keeps
+    // extending the window
+    std::chrono::milliseconds max_latency{2000};
+    bool leading = true;    // fire on the first event of a burst
+    bool trailing = true;   // fire when a burst ends, if events arrived since the last fire
+};
+
+struct DebounceStats {
+    uint64_t events = 0;       // raw events seen
+    uint64_t fired = 0;        // fires they were coalesced into
+    uint64_t suppressed = 0;   // events - fired
+};
+
+// Collapses bursts of events into leading and/or trailing fires.  Time is
+// passed in, so the owner drives it from its own wait loop (and tests from
+// a fake clock): call on_event() per raw event and poll() once deadline()
+// has passed.  Both come from one thread; stats() may be read from any.
+class Debouncer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Debouncer(DebounceConfig config = {});
+
+    // True if this event fires immediately (leading edge)
+    bool on_event(Clock::time_point now);
+    // When poll() next needs to run; nullopt while idle
+    std::optional<Clock::time_point> deadline() const;
+    // True if a deferred fire is due at `now`
+    bool poll(Clock::time_point now);
+
+    DebounceStats stats() const;
+    const DebounceConfig& config() const { return config_; }
+
+private:
+    DebounceConfig config_;
+    bool in_burst_ = false;
+    bool pending_ = false;            // events since the last fire
+    Clock::time_point last_event_{};
+    Clock::time_point oldest_pending_{};
+    std::atomic<uint64_t> events_{0};
+    std::atomic<uint64_t> fired_{0};
+};
+
+} // namespace hdrfixer::fixes
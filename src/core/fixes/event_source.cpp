@@ -0,0 +1,82 @@
+#include "event_source.h"
+#include <charconv>
+#include <optional>
+
+namespace hdrfixer::fixes {
+
+namespace {
+
+constexpr std::string_view kHeader = "hdrfixer-trace";
+constexpr std::string_view kVersion = "1";
+
+template <typename T>
+std::optional<T> parse_number(std::string_view s) {
+    T v{};
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (ec != std::errc() || end != s.data() + s.size() || s.empty()) return std::nullopt;
+    return v;
+}
+
+std::vector<std::string_view> split(std::string_view line) {
+    std::vector<std::string_view> fields;
+    size_t start = 0;
+    while (true) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab - start));
+        if (tab == std::string_view::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+} // namespace
+
+std::string serialize_event_trace(const std::vector<TraceEvent>& trace) {
+    std::string out(kHeader);
+    out += '\t';
+    out += kVersion;
+    out += '\n';
+    for (const auto& e : trace) {
+        out += "event\t" + std::to_string(e.at.count()) + '\t' + std::to_string(e.key) + '\n';
+    }
+    return out;
+}
+
+std::expected<std::vector<TraceEvent>, std::string> parse_event_trace(std::string_view text) {
+    std::vector<TraceEvent> trace;
+    size_t line_no = 0;
+    bool header = false;
+
+    while (!text.empty()) {
+        size_t nl = text.find('\n');
+        std::string_view line = text.substr(0, nl);
+        text = nl == std::string_view::npos ? std::string_view{} : text.substr(nl + 1);
+        ++line_no;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+
+        auto error = [&](const std::string& what) {
+            return std::unexpected("Trace line " + std::to_string(line_no) + ": " + what);
+        };
+
+        auto f = split(line);
+        if (!header) {
+            if (f[0] != kHeader || f.size() != 2) return error("not an event trace");
+            if (f[1] != kVersion) return error("unsupported trace version " + std::string(f[1]));
+            header = true;
+        } else if (f[0] == "event") {
+            if (f.size() != 3) return error("event needs 2 fields");
+            auto at = parse_number<int64_t>(f[1]);
+            auto key = parse_number<size_t>(f[2]);
+            if (!at || !key || *at < 0) return error("malformed event");
+            if (!trace.empty() && trace.back().at.count() > *at) return error("events out of order");
+            trace.push_back({std::chrono::microseconds(*at), *key});
+        } else {
+            return error("unknown record '" + std::string(f[0]) + "'");
+        }
+    }
+    if (!header) return std::unexpected(std::string("Trace is empty"));
+    return trace;
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,30 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hdrfixer::fixes {
+
+// One recorded watchdog notification: `key` fired `at` after the trace
+// started.  Traces are replayed into a WatchLoop on a virtual-clock Reactor.
+struct TraceEvent {
+    std::chrono::microseconds at{0};
+    size_t key = 0;
+
+    bool operator==(const TraceEvent&) const = default;
+};
+
+// Text form of an event trace, one tab-separated record per line:
+//
+//   hdrfixer-trace  1
+//   event           <microseconds since start>  <key>
+//
+// Events must be in time order.
+std::string serialize_event_trace(const std::vector<TraceEvent>& trace);
+std::expected<std::vector<TraceEvent>, std::string> parse_event_trace(std::string_view text);
+
+} // namespace hdrfixer::fixes
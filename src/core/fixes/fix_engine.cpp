@@ -1,29 +1,566 @@
 #include "fix_engine.h"
+#include "worker_pool.h"
+#include "apply_journal.h"
+#include "fix_executor.h"
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <algorithm>
 
 namespace hdrfixer::fixes {
 
-void FixEngine::register_fix(std::unique_ptr<IFix> fix) {
-    fixes_.push_back(std::move(fix));
+namespace {
+
+struct ApplyOutcome {
+    FixStatus status;       // pre-apply status
+    bool diagnosed = false; // status is fresh (not from the cache)
+    bool applied = false;
+    bool succeeded = false; // apply() reported success
+};
+
+using Clock = std::chrono::steady_clock;
+
+FixOutcome outcome_of(const FixStatus& status) {
+    if (status.state == FixState::NotNeeded) return FixOutcome::NotNeeded;
+    if (status.state == FixState::Error) return FixOutcome::Failure;
+    return FixOutcome::Success;
+}
+
+FixOutcome outcome_of(const FixResult& result) {
+    return result.success ? FixOutcome::Success : FixOutcome::Failure;
+}
+
+// Run one fix call, recording its latency and outcome; a call that throws
+// counts as a failure
+template <typename Call>
+auto timed(FixStats& stats, FixOp op, Call&& call) -> decltype(call()) {
+    auto start = Clock::now();
+    try {
+        auto result = call();
+        stats.record(op, Clock::now() - start, outcome_of(result));
+        return result;
+    } catch (...) {
+        stats.record(op, Clock::now() - start, FixOutcome::Failure);
+        throw;
+    }
+}
+
+bool needs_apply(const FixStatus& status) {
+    return status.state == FixState::NotApplied || status.state == FixState::Error;
+}
+
+// `known` is a still-valid cached status, which saves the diagnose call
+ApplyOutcome apply_if_needed(IFix& fix, FixStats& stats, const std::optional<FixStatus>& known) {
+    ApplyOutcome outcome{known ? *known : timed(stats, FixOp::Diagnose, [&] { return fix.diagnose(); }),
+                         !known, false};
+    if (needs_apply(outcome.status)) {
+        outcome.succeeded = timed(stats, FixOp::Apply, [&] { return fix.apply(); }).success;
+        outcome.applied = true;
+    } else {
+        stats.count(FixOp::Apply, FixOutcome::NotNeeded);
+    }
+    return outcome;
+}
+
+} // anonymous namespace
+
+std::future<FixResult> IFix::apply_async(FixExecutor& executor,
+                                         std::function<void(const FixResult&)> on_done) {
+    return executor.run<FixResult>([this]() -> FixResult {
+        try {
+            return apply();
+        } catch (const std::exception& ex) {
+            return {false, std::string("Apply failed: ") + ex.what()};
+        } catch (...) {
+            return {false, "Apply failed"};
+        }
+    }, std::move(on_done));
+}
+
+std::future<FixResult> IFix::revert_async(FixExecutor& executor,
+                                          std::function<void(const FixResult&)> on_done) {
+    return executor.run<FixResult>([this]() -> FixResult {
+        try {
+            return revert();
+        } catch (const std::exception& ex) {
+            return {false, std::string("Revert failed: ") + ex.what()};
+        } catch (...) {
+            return {false, "Revert failed"};
+        }
+    }, std::move(on_done));
+}
+
+std::future<FixStatus> IFix::diagnose_async(FixExecutor& executor,
+                                            std::function<void(const FixStatus&)> on_done) {
+    return executor.run<FixStatus>([this]() -> FixStatus {
+        try {
+            return diagnose();
+        } catch (const std::exception& ex) {
+            return {FixState::Error, std::string("Diagnosis failed: ") + ex.what()};
+        } catch (...) {
+            return {FixState::Error, "Diagnosis failed"};
+        }
+    }, std::move(on_done));
+}
+
+std::expected<void, std::string> FixEngine::register_fix(std::unique_ptr<IFix> fix, uint64_t owner) {
+    FixId id = fix_id(fix->name());
+    Entry entry;
+    entry.id = id;
+    entry.dependencies = fix->dependencies();
+    entry.resources = fix->observed_resources();
+    entry.fix = std::move(fix);
+    entry.owner = owner;
+    entry.busy = std::make_shared<std::atomic<bool>>(false);
+    // Re-registering the same fix for the same owner (a display coming
+    // back) continues its statistics
+    auto& record = stats_[Key{owner, id}];
+    bool fresh_stats = !record.stats;
+    if (fresh_stats) {
+        record.name = entry.fix->name();
+        record.stats = std::make_shared<FixStats>();
+    }
+    entry.stats = record.stats;
+    fixes_.push_back(std::move(entry));
+    index_.emplace(Key{owner, id}, fixes_.size() - 1);
+    if (reaches_itself(fixes_.size() - 1)) {
+        std::string name = fixes_.back().fix->name();
+        fixes_.pop_back();
+        auto it = index_.find({owner, id});
+        if (it != index_.end() && it->second == fixes_.size()) index_.erase(it);
+        if (fresh_stats) stats_.erase({owner, id});
+        return std::unexpected("Dependency cycle through fix '" + name + "'");
+    }
+    return {};
+}
+
+size_t FixEngine::remove_fixes(uint64_t owner) {
+    size_t before = fixes_.size();
+    std::erase_if(fixes_, [owner](const Entry& e) { return e.owner == owner; });
+    if (fixes_.size() != before) reindex();
+    return before - fixes_.size();
+}
+
+void FixEngine::reindex() {
+    index_.clear();
+    index_.reserve(fixes_.size());
+    for (size_t i = 0; i < fixes_.size(); ++i) {
+        index_.emplace(Key{fixes_[i].owner, fixes_[i].id}, i);
+    }
+}
+
+std::optional<size_t> FixEngine::find(FixId id, uint64_t owner) const {
+    auto it = index_.find({owner, id});
+    if (it == index_.end()) return std::nullopt;
+    return it->second;
+}
+
+bool FixEngine::has_fixes(uint64_t owner) const {
+    for (const auto& e : fixes_) {
+        if (e.owner == owner) return true;
+    }
+    return false;
 }
 
 size_t FixEngine::fix_count() const {
     return fixes_.size();
 }
 
+std::vector<uint64_t> FixEngine::owners() const {
+    std::vector<uint64_t> out;
+    for (const auto& e : fixes_) {
+        if (std::find(out.begin(), out.end(), e.owner) == out.end()) out.push_back(e.owner);
+    }
+    return out;
+}
+
+std::vector<size_t> FixEngine::resolve_dependencies(size_t i) const {
+    std::vector<size_t> out;
+    uint64_t owner = fixes_[i].owner;
+    for (FixId dep : fixes_[i].dependencies) {
+        // Same owner first, then the global instance
+        auto j = find(dep, owner);
+        if (!j && owner != 0) j = find(dep, 0);
+        if (j && *j != i) out.push_back(*j);
+    }
+    return out;
+}
+
+std::vector<std::vector<size_t>> FixEngine::dependency_edges() const {
+    std::vector<std::vector<size_t>> deps(fixes_.size());
+    for (size_t i = 0; i < fixes_.size(); ++i) {
+        deps[i] = resolve_dependencies(i);
+    }
+    return deps;
+}
+
+bool FixEngine::reaches_itself(size_t start) const {
+    // Every edge a registration adds or redirects ends at or leaves the new
+    // fix, so a new cycle has to pass through it: walk its dependencies
+    std::vector<bool> seen(fixes_.size(), false);
+    std::vector<size_t> stack = resolve_dependencies(start);
+    while (!stack.empty()) {
+        size_t i = stack.back();
+        stack.pop_back();
+        if (i == start) return true;
+        if (seen[i]) continue;
+        seen[i] = true;
+        for (size_t j : resolve_dependencies(i)) {
+            if (!seen[j]) stack.push_back(j);
+        }
+    }
+    return false;
+}
+
+std::optional<std::vector<size_t>> FixEngine::topological_order() const {
+    auto deps = dependency_edges();
+    std::vector<std::vector<size_t>> dependents(fixes_.size());
+    std::vector<size_t> remaining(fixes_.size());
+    for (size_t i = 0; i < deps.size(); ++i) {
+        remaining[i] = deps[i].size();
+        for (size_t j : deps[i]) dependents[j].push_back(i);
+    }
+
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+    for (size_t i = 0; i < remaining.size(); ++i) {
+        if (remaining[i] == 0) ready.push(i);
+    }
+
+    std::vector<size_t> order;
+    order.reserve(fixes_.size());
+    while (!ready.empty()) {
+        size_t i = ready.top();
+        ready.pop();
+        order.push_back(i);
+        for (size_t d : dependents[i]) {
+            if (--remaining[d] == 0) ready.push(d);
+        }
+    }
+    if (order.size() != fixes_.size()) return std::nullopt;
+    return order;
+}
+
 void FixEngine::apply_all() {
-    for (auto& fix : fixes_) {
-        auto status = fix->diagnose();
-        if (status.state == FixState::NotApplied || status.state == FixState::Error) {
-            fix->apply();
+    // register_fix rejects cycles, so an order always exists
+    for (size_t i : topological_order().value_or(std::vector<size_t>{})) {
+        auto& e = fixes_[i];
+        if (e.busy->load()) continue;   // a timed-out diagnosis still owns it
+        uint64_t snapshot = generation_;
+        auto outcome = apply_if_needed(*e.fix, *e.stats, valid_status(e));
+        if (outcome.applied) {
+            ran(e, outcome.succeeded);
+        } else if (outcome.diagnosed) {
+            store_status(e, outcome.status, snapshot);
         }
     }
 }
 
+FixStatus FixEngine::still_running(const Entry& e) {
+    return {FixState::Error, e.fix->name() + ": previous diagnosis still running"};
+}
+
+void FixEngine::abandon_async() {
+    for (auto& e : fixes_) {
+        e.busy->store(false);
+    }
+    transaction_active_ = false;
+}
+
 void FixEngine::revert_all() {
-    for (auto& fix : fixes_) {
-        auto status = fix->diagnose();
-        if (status.state == FixState::Applied) {
-            fix->revert();
+    auto order = topological_order().value_or(std::vector<size_t>{});
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        auto& e = fixes_[*it];
+        if (e.busy->load()) continue;
+        uint64_t snapshot = generation_;
+        auto status = valid_status(e);
+        if (!status) {
+            status = timed(*e.stats, FixOp::Diagnose, [&] { return e.fix->diagnose(); });
+            store_status(e, *status, snapshot);
+        }
+        if (status->state == FixState::Applied) {
+            timed(*e.stats, FixOp::Revert, [&] { return e.fix->revert(); });
+            ran(e, false);
+        } else {
+            e.stats->count(FixOp::Revert, FixOutcome::NotNeeded);
+        }
+    }
+}
+
+// State of one journaled apply.  The fixes' pre-apply statuses and
+// references are taken on the UI thread; run() only calls the fixes and
+// the journal, so it may run on a worker, and the engine's bookkeeping
+// happens in finish_transaction(), back on the UI thread.
+struct FixEngine::Transaction {
+    struct Node {
+        std::shared_ptr<IFix> fix;
+        FixId id;
+        uint64_t owner = 0;
+        std::shared_ptr<std::atomic<bool>> busy;
+        std::shared_ptr<FixStats> stats;
+        std::optional<FixStatus> known = std::nullopt;
+        std::optional<FixStatus> diagnosed = std::nullopt;   // fresh diagnosis taken by run()
+        bool ran = false;                     // applied or restored
+        bool applied = false;                 // apply() succeeded and was kept
+    };
+
+    ApplyJournal* journal = nullptr;
+    uint64_t snapshot = 0;
+    std::vector<Node> nodes;   // in dependency order
+    std::expected<void, std::string> result;
+
+    void run() {
+        try {
+            result = transact();
+        } catch (const std::exception& ex) {
+            result = std::unexpected(std::string("Apply aborted: ") + ex.what());
+        } catch (...) {
+            result = std::unexpected("Apply aborted: unknown exception");
+        }
+    }
+
+private:
+    std::expected<void, std::string> transact() {
+        // Diagnose first so the journal lists exactly the fixes that will run
+        std::vector<size_t> pending;
+        std::vector<JournalStep> steps;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            auto& n = nodes[i];
+            auto status = n.known;
+            if (!status) {
+                status = timed(*n.stats, FixOp::Diagnose, [&] { return n.fix->diagnose(); });
+                n.diagnosed = status;
+            }
+            if (!needs_apply(*status)) {
+                n.stats->count(FixOp::Apply, FixOutcome::NotNeeded);
+                continue;
+            }
+
+            JournalStep step;
+            step.fix = n.id;
+            step.owner = n.owner;
+            step.pre_state = n.fix->capture_state();
+            step.pre_state.name = n.fix->name();
+            steps.push_back(std::move(step));
+            pending.push_back(i);
+        }
+        if (pending.empty()) return {};
+
+        if (auto begun = journal->begin(steps); !begun) {
+            return std::unexpected("Apply aborted: " + begun.error());
+        }
+
+        for (size_t k = 0; k < pending.size(); ++k) {
+            auto& n = nodes[pending[k]];
+            if (auto marked = journal->mark_started(k); !marked) {
+                size_t restored = restore(pending, steps, k);
+                (void)journal->commit();
+                return std::unexpected("Apply aborted: " + marked.error() + "; rolled back " +
+                                       std::to_string(restored) + " fix(es)");
+            }
+
+            FixResult result{false, ""};
+            try {
+                result = timed(*n.stats, FixOp::Apply, [&] { return n.fix->apply(); });
+            } catch (const std::exception& ex) {
+                result = {false, ex.what()};
+            } catch (...) {
+                result = {false, "unknown exception"};
+            }
+            n.ran = true;
+            n.applied = result.success;
+
+            if (!result.success) {
+                size_t restored = restore(pending, steps, k + 1);
+                (void)journal->commit();
+                return std::unexpected(n.fix->name() + " failed: " + result.message + "; rolled back " +
+                                       std::to_string(restored) + " fix(es)");
+            }
+        }
+        return journal->commit();
+    }
+
+    // Restore nodes pending[0, count) newest first; returns how many succeeded
+    size_t restore(const std::vector<size_t>& pending, const std::vector<JournalStep>& steps, size_t count) {
+        size_t restored = 0;
+        for (size_t k = count; k-- > 0;) {
+            auto& n = nodes[pending[k]];
+            try {
+                auto result = timed(*n.stats, FixOp::Revert,
+                                    [&] { return n.fix->restore_state(steps[k].pre_state); });
+                if (result.success) ++restored;
+            } catch (...) {
+                // Keep unwinding; the remaining steps are independent
+            }
+            n.ran = true;
+            n.applied = false;
+        }
+        return restored;
+    }
+};
+
+std::shared_ptr<FixEngine::Transaction> FixEngine::begin_transaction(ApplyJournal& journal) {
+    if (transaction_active_) return nullptr;
+    transaction_active_ = true;
+
+    auto txn = std::make_shared<Transaction>();
+    txn->journal = &journal;
+    txn->snapshot = generation_;
+    for (size_t i : topological_order().value_or(std::vector<size_t>{})) {
+        auto& e = fixes_[i];
+        if (e.busy->exchange(true)) continue;   // e.g. a timed-out diagnosis still owns it
+        txn->nodes.push_back({.fix = e.fix, .id = e.id, .owner = e.owner, .busy = e.busy,
+                              .stats = e.stats, .known = valid_status(e)});
+    }
+    return txn;
+}
+
+std::expected<void, std::string> FixEngine::finish_transaction(Transaction& txn) {
+    for (auto& n : txn.nodes) {
+        n.busy->store(false);
+        // The fix may have been removed (hotplug) while the apply ran
+        auto* e = entry_for(n.fix.get(), n.id, n.owner);
+        if (!e) continue;
+        if (n.ran) {
+            ran(*e, n.applied);
+        } else if (n.diagnosed) {
+            store_status(*e, *n.diagnosed, txn.snapshot);
+        }
+    }
+    transaction_active_ = false;
+    return txn.result;
+}
+
+std::expected<void, std::string> FixEngine::apply_all(ApplyJournal& journal) {
+    auto txn = begin_transaction(journal);
+    if (!txn) return std::unexpected("Apply aborted: another apply is in progress");
+    txn->run();
+    return finish_transaction(*txn);
+}
+
+void FixEngine::apply_all_async(FixExecutor& executor, ApplyJournal& journal,
+                                std::function<void(const std::expected<void, std::string>&)> done) {
+    auto txn = begin_transaction(journal);
+    if (!txn) {
+        if (done) done(std::unexpected("Apply aborted: another apply is in progress"));
+        return;
+    }
+    // One worker runs the whole transaction: its fixes apply in order anyway
+    executor.run<bool>([txn] {
+        txn->run();
+        return true;
+    }, [this, txn, done = std::move(done)](const bool&) {
+        auto result = finish_transaction(*txn);
+        if (done) done(result);
+    });
+}
+
+std::expected<size_t, std::string> FixEngine::recover(ApplyJournal& journal) {
+    auto steps = journal.load();
+    if (!steps.has_value()) return std::unexpected(steps.error());
+
+    // Steps are started in order, so the started ones form a prefix
+    size_t started = 0;
+    while (started < steps->size() && (*steps)[started].started) ++started;
+    size_t restored = restore_steps(*steps, started);
+
+    if (auto sealed = journal.commit(); !sealed) return std::unexpected(sealed.error());
+    return restored;
+}
+
+size_t FixEngine::restore_steps(const std::vector<JournalStep>& steps, size_t count) {
+    size_t restored = 0;
+    for (size_t k = count; k-- > 0;) {
+        auto i = find(steps[k].fix, steps[k].owner);
+        if (!i) continue;   // e.g. its display has been unplugged
+        auto& e = fixes_[*i];
+        try {
+            auto result = timed(*e.stats, FixOp::Revert,
+                                [&] { return e.fix->restore_state(steps[k].pre_state); });
+            if (result.success) ++restored;
+        } catch (...) {
+            // Keep unwinding; the remaining steps are independent
+        }
+        ran(e, false);
+    }
+    return restored;
+}
+
+void FixEngine::apply_all(WorkerPool& pool) {
+    if (fixes_.empty()) return;
+
+    struct Schedule {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::shared_ptr<IFix>> fixes;
+        std::vector<std::shared_ptr<FixStats>> stats;
+        std::vector<std::vector<size_t>> dependents;
+        std::vector<size_t> remaining;
+        std::vector<std::optional<FixStatus>> known;
+        std::vector<bool> skip;
+        std::vector<std::optional<ApplyOutcome>> outcomes;
+        size_t finished = 0;
+        WorkerPool* pool = nullptr;
+
+        void start(const std::shared_ptr<Schedule>& self, size_t i) {
+            pool->submit([self, i] {
+                std::optional<ApplyOutcome> outcome;
+                if (!self->skip[i]) {
+                    try {
+                        outcome = apply_if_needed(*self->fixes[i], *self->stats[i], self->known[i]);
+                    } catch (...) {
+                        // A failing fix must not take down the worker or
+                        // stall its dependents
+                    }
+                }
+                std::vector<size_t> ready;
+                {
+                    std::lock_guard<std::mutex> lock(self->mutex);
+                    self->outcomes[i] = std::move(outcome);
+                    for (size_t d : self->dependents[i]) {
+                        if (--self->remaining[d] == 0) ready.push_back(d);
+                    }
+                    ++self->finished;
+                }
+                for (size_t d : ready) self->start(self, d);
+                self->cv.notify_all();
+            });
+        }
+    };
+
+    auto schedule = std::make_shared<Schedule>();
+    auto deps = dependency_edges();
+    schedule->pool = &pool;
+    schedule->dependents.resize(fixes_.size());
+    schedule->remaining.resize(fixes_.size());
+    schedule->outcomes.resize(fixes_.size());
+    uint64_t snapshot = generation_;
+    for (size_t i = 0; i < fixes_.size(); ++i) {
+        schedule->fixes.push_back(fixes_[i].fix);
+        schedule->stats.push_back(fixes_[i].stats);
+        schedule->known.push_back(valid_status(fixes_[i]));
+        schedule->skip.push_back(fixes_[i].busy->load());
+        schedule->remaining[i] = deps[i].size();
+        for (size_t j : deps[i]) schedule->dependents[j].push_back(i);
+    }
+
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < fixes_.size(); ++i) {
+        if (schedule->remaining[i] == 0) roots.push_back(i);
+    }
+    for (size_t i : roots) schedule->start(schedule, i);
+
+    std::unique_lock<std::mutex> lock(schedule->mutex);
+    schedule->cv.wait(lock, [&] { return schedule->finished == schedule->fixes.size(); });
+    for (size_t i = 0; i < fixes_.size(); ++i) {
+        const auto& outcome = schedule->outcomes[i];
+        if (schedule->skip[i]) continue;
+        if (!outcome || outcome->applied) {
+            ran(fixes_[i], outcome && outcome->succeeded);
+        } else if (outcome->diagnosed) {
+            store_status(fixes_[i], outcome->status, snapshot);
         }
     }
 }
@@ -31,19 +568,494 @@ void FixEngine::revert_all() {
 std::vector<FixStatus> FixEngine::diagnose_all() {
     std::vector<FixStatus> results;
     results.reserve(fixes_.size());
-    for (auto& fix : fixes_) {
-        results.push_back(fix->diagnose());
+    for (auto& e : fixes_) {
+        if (e.busy->load()) {   // e.g. a timed-out diagnosis still owns it
+            results.push_back(still_running(e));
+            continue;
+        }
+        uint64_t snapshot = generation_;
+        results.push_back(timed(*e.stats, FixOp::Diagnose, [&] { return e.fix->diagnose(); }));
+        store_status(e, results.back(), snapshot);
+    }
+    return results;
+}
+
+std::vector<FixStatus> FixEngine::diagnose_all(WorkerPool& pool, std::chrono::milliseconds timeout) {
+    std::vector<size_t> all(fixes_.size());
+    for (size_t i = 0; i < all.size(); ++i) all[i] = i;
+    std::vector<bool> completed;
+    uint64_t snapshot = generation_;
+    auto results = run_diagnoses(pool, timeout, all, completed);
+    for (size_t i = 0; i < fixes_.size(); ++i) {
+        if (completed[i]) store_status(fixes_[i], results[i], snapshot);
+    }
+    return results;
+}
+
+std::vector<FixStatus> FixEngine::run_diagnoses(WorkerPool& pool, std::chrono::milliseconds timeout,
+                                                const std::vector<size_t>& which,
+                                                std::vector<bool>& completed) {
+    // Shared with the worker tasks, which may finish after we return
+    struct Batch {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::optional<FixStatus>> results;
+        std::vector<bool> started;
+        size_t pending = 0;
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->results.resize(which.size());
+    batch->started.resize(which.size(), false);
+    completed.assign(which.size(), false);
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    for (size_t slot = 0; slot < which.size(); ++slot) {
+        auto& e = fixes_[which[slot]];
+        if (e.busy->exchange(true)) {
+            batch->results[slot] = still_running(e);
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            ++batch->pending;
+        }
+        pool.submit([batch, slot, fix = e.fix, busy = e.busy, stats = e.stats] {
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->started[slot] = true;
+            }
+            FixStatus status;
+            try {
+                status = timed(*stats, FixOp::Diagnose, [&] { return fix->diagnose(); });
+            } catch (const std::exception& ex) {
+                status = {FixState::Error, std::string("Diagnosis failed: ") + ex.what()};
+            } catch (...) {
+                status = {FixState::Error, "Diagnosis failed"};
+            }
+            busy->store(false);
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->results[slot] = std::move(status);
+                --batch->pending;
+            }
+            batch->cv.notify_all();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->cv.wait_until(lock, deadline, [&] { return batch->pending == 0; });
+
+    std::vector<FixStatus> results;
+    results.reserve(which.size());
+    for (size_t slot = 0; slot < which.size(); ++slot) {
+        const auto& e = fixes_[which[slot]];
+        if (batch->results[slot]) {
+            results.push_back(*batch->results[slot]);
+            completed[slot] = batch->started[slot];
+        } else {
+            std::string ms = std::to_string(timeout.count());
+            results.push_back({FixState::Error, batch->started[slot]
+                ? e.fix->name() + ": diagnosis timed out after " + ms + " ms"
+                : e.fix->name() + ": no worker available within " + ms + " ms"});
+        }
+    }
+    return results;
+}
+
+bool FixEngine::needs_diagnose(const Entry& e) const {
+    return !e.cached || e.cached_at < e.invalidated_at;
+}
+
+std::optional<FixStatus> FixEngine::valid_status(const Entry& e) const {
+    if (needs_diagnose(e)) return std::nullopt;
+    return e.cached;
+}
+
+// `snapshot` is the generation read before diagnose() started; anything
+// invalidated since then leaves the stored status stale.
+void FixEngine::store_status(Entry& e, const FixStatus& status, uint64_t snapshot) {
+    e.cached = status;
+    e.cached_at = snapshot;
+    if (snapshot < e.invalidated_at) return;
+    if (e.apply_unverified) {
+        e.apply_ineffective = status.state == FixState::NotApplied;
+        e.apply_unverified = false;
+    } else if (status.state != FixState::NotApplied) {
+        e.apply_ineffective = false;
+    }
+}
+
+void FixEngine::ran(Entry& e, bool apply_succeeded) {
+    invalidate(e);
+    e.apply_unverified = apply_succeeded;
+}
+
+size_t FixEngine::drift_count() const {
+    size_t count = 0;
+    for (const auto& e : fixes_) {
+        auto status = valid_status(e);
+        if (status && status->state == FixState::NotApplied && !e.apply_ineffective) ++count;
+    }
+    return count;
+}
+
+void FixEngine::invalidate(Entry& e) {
+    e.invalidated_at = ++generation_;
+}
+
+void FixEngine::invalidate(const IFix* fix) {
+    for (auto& e : fixes_) {
+        if (e.fix.get() == fix) invalidate(e);
+    }
+}
+
+void FixEngine::notify_changed(const ObservedResource& changed) {
+    for (auto& e : fixes_) {
+        // Fixes that declare nothing could depend on anything
+        bool affected = e.resources.empty();
+        for (const auto& r : e.resources) {
+            if (resource_affected(r, changed)) {
+                affected = true;
+                break;
+            }
+        }
+        if (affected) invalidate(e);
+    }
+}
+
+void FixEngine::mark_all_dirty() {
+    for (auto& e : fixes_) invalidate(e);
+}
+
+size_t FixEngine::dirty_count() const {
+    size_t n = 0;
+    for (const auto& e : fixes_) {
+        if (needs_diagnose(e)) ++n;
+    }
+    return n;
+}
+
+std::vector<FixStatus> FixEngine::diagnose_dirty() {
+    std::vector<FixStatus> results;
+    results.reserve(fixes_.size());
+    for (auto& e : fixes_) {
+        if (!needs_diagnose(e)) {
+            results.push_back(*e.cached);
+        } else if (e.busy->load()) {
+            results.push_back(still_running(e));
+        } else {
+            uint64_t snapshot = generation_;
+            store_status(e, timed(*e.stats, FixOp::Diagnose, [&] { return e.fix->diagnose(); }), snapshot);
+            results.push_back(*e.cached);
+        }
+    }
+    return results;
+}
+
+std::vector<FixStatus> FixEngine::diagnose_dirty(WorkerPool& pool, std::chrono::milliseconds timeout) {
+    std::vector<size_t> dirty;
+    for (size_t i = 0; i < fixes_.size(); ++i) {
+        if (needs_diagnose(fixes_[i])) dirty.push_back(i);
+    }
+    std::vector<bool> completed;
+    uint64_t snapshot = generation_;
+    auto fresh = run_diagnoses(pool, timeout, dirty, completed);
+
+    std::vector<FixStatus> results(fixes_.size());
+    for (size_t i = 0; i < fixes_.size(); ++i) {
+        if (fixes_[i].cached) results[i] = *fixes_[i].cached;
+    }
+    // Timed-out fixes report the error but stay dirty for the next pass
+    for (size_t slot = 0; slot < dirty.size(); ++slot) {
+        results[dirty[slot]] = fresh[slot];
+        if (completed[slot]) store_status(fixes_[dirty[slot]], fresh[slot], snapshot);
     }
     return results;
 }
 
-IFix* FixEngine::get_fix(const std::string& name) {
-    for (auto& fix : fixes_) {
-        if (fix->name() == name) {
-            return fix.get();
+FixPlan FixEngine::plan(WorkerPool& pool, std::chrono::milliseconds timeout, PlanOp goal) {
+    diagnose_dirty(pool, timeout);
+
+    FixPlan plan;
+    plan.goal = goal;
+    auto order = topological_order().value_or(std::vector<size_t>{});
+    if (goal == PlanOp::Revert) std::reverse(order.begin(), order.end());
+    for (size_t i : order) {
+        const auto& e = fixes_[i];
+        auto status = valid_status(e);
+        if (!status || e.busy->load()) {
+            plan.undiagnosed.push_back({e.fix->name(), e.id, e.owner, std::nullopt});
+            continue;
+        }
+        bool act = goal == PlanOp::Apply ? needs_apply(*status) : status->state == FixState::Applied;
+        if (!act) continue;
+        plan.actions.push_back({goal, e.id, e.owner, e.fix->name(), *status, e.fix->planned_effects(goal)});
+    }
+    return plan;
+}
+
+std::vector<FixResult> FixEngine::execute(const FixPlan& plan) {
+    std::vector<FixResult> results;
+    results.reserve(plan.actions.size());
+    for (const auto& action : plan.actions) {
+        auto i = find(action.fix, action.owner);
+        if (!i) {
+            results.push_back({false, action.name + " is no longer registered"});
+            continue;
+        }
+        auto& e = fixes_[*i];
+        if (e.busy->load()) {
+            results.push_back({false, action.name + " is busy"});
+            continue;
+        }
+        bool apply = action.op == PlanOp::Apply;
+        std::string failed = apply ? "Apply failed" : "Revert failed";
+        try {
+            results.push_back(timed(*e.stats, apply ? FixOp::Apply : FixOp::Revert, [&] {
+                return apply ? e.fix->apply() : e.fix->revert();
+            }));
+        } catch (const std::exception& ex) {
+            results.push_back({false, failed + ": " + ex.what()});
+        } catch (...) {
+            results.push_back({false, failed});
         }
+        ran(e, apply && results.back().success);
     }
-    return nullptr;
+    return results;
+}
+
+// State of one apply_all_async()/revert_all_async().  Only touched on the
+// UI thread: workers hand results back through FixExecutor::post.
+struct FixEngine::AsyncRun : std::enable_shared_from_this<AsyncRun> {
+    struct Node {
+        std::shared_ptr<IFix> fix;
+        FixId id;
+        uint64_t owner = 0;
+        std::shared_ptr<std::atomic<bool>> busy;
+        std::shared_ptr<FixStats> stats;
+        std::optional<FixStatus> known;
+        std::vector<size_t> next;   // nodes waiting on this one
+        size_t waiting = 0;         // unfinished nodes this one waits on
+        bool skip = false;          // was already busy when the run started
+    };
+
+    FixEngine* engine = nullptr;
+    FixExecutor* executor = nullptr;
+    bool revert = false;
+    uint64_t snapshot = 0;
+    std::vector<Node> nodes;
+    size_t unfinished = 0;
+    std::function<void()> done;
+
+    void start(size_t i) {
+        auto& n = nodes[i];
+        if (n.skip) {
+            finish(i);
+            return;
+        }
+        if (n.known) {
+            act(i, *n.known);
+            return;
+        }
+        // Async latency runs from dispatch to the completion reaching the UI
+        // thread, i.e. what the user waits for
+        n.fix->diagnose_async(*executor, [self = shared_from_this(), i, start = Clock::now()](const FixStatus& status) {
+            const auto& n = self->nodes[i];
+            n.stats->record(FixOp::Diagnose, Clock::now() - start, outcome_of(status));
+            if (auto* e = self->engine->entry_for(n.fix.get(), n.id, n.owner)) {
+                self->engine->store_status(*e, status, self->snapshot);
+            }
+            self->act(i, status);
+        });
+    }
+
+    void act(size_t i, const FixStatus& status) {
+        FixOp op = revert ? FixOp::Revert : FixOp::Apply;
+        bool needed = revert ? status.state == FixState::Applied : needs_apply(status);
+        if (!needed) {
+            nodes[i].stats->count(op, FixOutcome::NotNeeded);
+            finish(i);
+            return;
+        }
+
+        auto on_done = [self = shared_from_this(), i, op, start = Clock::now()](const FixResult& result) {
+            const auto& n = self->nodes[i];
+            n.stats->record(op, Clock::now() - start, outcome_of(result));
+            if (auto* e = self->engine->entry_for(n.fix.get(), n.id, n.owner)) {
+                self->engine->ran(*e, !self->revert && result.success);
+            }
+            self->finish(i);
+        };
+        if (revert) {
+            nodes[i].fix->revert_async(*executor, std::move(on_done));
+        } else {
+            nodes[i].fix->apply_async(*executor, std::move(on_done));
+        }
+    }
+
+    void finish(size_t i) {
+        if (!nodes[i].skip) nodes[i].busy->store(false);
+        bool last = --unfinished == 0;
+        for (size_t d : nodes[i].next) {
+            if (--nodes[d].waiting == 0) start(d);
+        }
+        if (last && done) done();
+    }
+};
+
+void FixEngine::apply_all_async(FixExecutor& executor, std::function<void()> done) {
+    run_async(executor, false, std::move(done));
+}
+
+void FixEngine::revert_all_async(FixExecutor& executor, std::function<void()> done) {
+    run_async(executor, true, std::move(done));
+}
+
+void FixEngine::apply_async(FixExecutor& executor, const std::vector<uint64_t>& owners,
+                            std::function<void()> done) {
+    run_async(executor, false, std::move(done), &owners);
+}
+
+void FixEngine::toggle_async(FixExecutor& executor, FixId id, uint64_t owner,
+                             std::function<void(const std::optional<ToggleResult>&)> done) {
+    auto i = find(id, owner);
+    if (!i || fixes_[*i].busy->exchange(true)) {
+        if (done) done(std::nullopt);
+        return;
+    }
+
+    struct Toggle {
+        FixEngine* engine;
+        FixExecutor* executor;
+        std::shared_ptr<IFix> fix;
+        FixId id;
+        uint64_t owner;
+        std::shared_ptr<std::atomic<bool>> busy;
+        std::shared_ptr<FixStats> stats;
+        std::function<void(const std::optional<ToggleResult>&)> done;
+
+        void act(std::shared_ptr<Toggle> self, const FixStatus& status) {
+            PlanOp op = status.state == FixState::Applied ? PlanOp::Revert : PlanOp::Apply;
+            auto on_done = [self, op, start = Clock::now()](const FixResult& result) {
+                FixOp fop = op == PlanOp::Revert ? FixOp::Revert : FixOp::Apply;
+                self->stats->record(fop, Clock::now() - start, outcome_of(result));
+                if (auto* e = self->engine->entry_for(self->fix.get(), self->id, self->owner)) {
+                    self->engine->ran(*e, op == PlanOp::Apply && result.success);
+                }
+                self->busy->store(false);
+                if (self->done) self->done(ToggleResult{op, result});
+            };
+            if (op == PlanOp::Revert) {
+                fix->revert_async(*executor, std::move(on_done));
+            } else {
+                fix->apply_async(*executor, std::move(on_done));
+            }
+        }
+    };
+    auto& e = fixes_[*i];
+    auto toggle = std::make_shared<Toggle>(Toggle{this, &executor, e.fix, e.id, e.owner, e.busy, e.stats,
+                                                  std::move(done)});
+    if (auto known = valid_status(e)) {
+        toggle->act(toggle, *known);
+        return;
+    }
+    uint64_t snapshot = generation_;
+    e.fix->diagnose_async(executor, [toggle, snapshot, start = Clock::now()](const FixStatus& status) {
+        toggle->stats->record(FixOp::Diagnose, Clock::now() - start, outcome_of(status));
+        if (auto* e = toggle->engine->entry_for(toggle->fix.get(), toggle->id, toggle->owner)) {
+            toggle->engine->store_status(*e, status, snapshot);
+        }
+        toggle->act(toggle, status);
+    });
+}
+
+void FixEngine::run_async(FixExecutor& executor, bool revert, std::function<void()> done,
+                          const std::vector<uint64_t>* owners) {
+    if (fixes_.empty()) {
+        if (done) done();
+        return;
+    }
+
+    auto run = std::make_shared<AsyncRun>();
+    run->engine = this;
+    run->executor = &executor;
+    run->revert = revert;
+    run->snapshot = generation_;
+    run->done = std::move(done);
+    run->unfinished = fixes_.size();
+    run->nodes.resize(fixes_.size());
+    for (size_t i = 0; i < fixes_.size(); ++i) {
+        auto& e = fixes_[i];
+        auto& n = run->nodes[i];
+        n.fix = e.fix;
+        n.id = e.id;
+        n.owner = e.owner;
+        n.busy = e.busy;
+        n.stats = e.stats;
+        n.known = valid_status(e);
+        // Fixes outside the run still pass their dependents on, untouched
+        bool selected = !owners || std::ranges::find(*owners, e.owner) != owners->end();
+        n.skip = !selected || e.busy->exchange(true);
+    }
+    // Reverting walks the dependency edges backwards
+    auto deps = dependency_edges();
+    for (size_t i = 0; i < deps.size(); ++i) {
+        for (size_t j : deps[i]) {
+            size_t first = revert ? i : j;
+            size_t then = revert ? j : i;
+            run->nodes[first].next.push_back(then);
+            ++run->nodes[then].waiting;
+        }
+    }
+
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < run->nodes.size(); ++i) {
+        if (run->nodes[i].waiting == 0) roots.push_back(i);
+    }
+    for (size_t i : roots) run->start(i);
+}
+
+FixEngine::Entry* FixEngine::entry_for(const IFix* fix, FixId id, uint64_t owner) {
+    // The fix may have been removed (hotplug) while its work was in flight
+    auto i = find(id, owner);
+    if (!i || fixes_[*i].fix.get() != fix) return nullptr;
+    return &fixes_[*i];
+}
+
+std::vector<FixStatsSnapshot> FixEngine::stats() const {
+    std::vector<FixStatsSnapshot> out;
+    out.reserve(stats_.size());
+    for (const auto& [key, record] : stats_) {
+        FixStatsSnapshot snap;
+        snap.name = record.name;
+        snap.id = key.id;
+        snap.owner = key.owner;
+        snap.registered = index_.contains(key);
+        for (size_t op = 0; op < kFixOpCount; ++op) {
+            snap.ops[op] = record.stats->snapshot(static_cast<FixOp>(op));
+        }
+        out.push_back(std::move(snap));
+    }
+    // Hash order is meaningless to a reader; group by fix, then owner
+    std::sort(out.begin(), out.end(), [](const FixStatsSnapshot& a, const FixStatsSnapshot& b) {
+        return a.name != b.name ? a.name < b.name : a.owner < b.owner;
+    });
+    return out;
+}
+
+std::vector<FixReport> FixEngine::report(uint64_t owner) const {
+    std::vector<FixReport> out;
+    for (const auto& e : fixes_) {
+        if (e.owner != owner) continue;
+        out.push_back({e.fix->name(), e.id, e.owner, valid_status(e)});
+    }
+    return out;
+}
+
+IFix* FixEngine::get_fix(FixId id, uint64_t owner) {
+    auto i = find(id, owner);
+    return i ? fixes_[*i].fix.get() : nullptr;
 }
 
 } // namespace hdrfixer::fixes
@@ -2,6 +2,18 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+#include <expected>
+#include <optional>
+#include <unordered_map>
+#include <functional>
+#include <future>
+#include "fix_id.h"
+#include "core/registry/backup_set.h"
+#include "observed_resource.h"
+#include "fix_stats.h"
 
 namespace hdrfixer::fixes {
 
@@ -19,7 +31,10 @@ enum class FixState {
     NotApplied,
     Applied,
     Error,
-    NotNeeded
+    NotNeeded,
+    // A problem no apply() can solve (detect-and-warn fixes): reported,
+    // but never applied, planned or retried
+    Warning
 };
 
 struct FixResult {
@@ -32,6 +47,49 @@ struct FixStatus {
     std::string message;
 };
 
+// One registered fix and its last known status, for status displays
+struct FixReport {
+    std::string name;
+    FixId id;
+    uint64_t owner = 0;
+    std::optional<FixStatus> status;   // nullopt if stale or never diagnosed
+};
+
+enum class PlanOp {
+    Apply,
+    Revert
+};
+
+// A change a fix predicts apply() or revert() will make, e.g. a profile
+// file written or an SDR white level set.  `target` uses the same keys as
+// observed_resources(); `change` is human-readable UTF-8.
+struct PlannedEffect {
+    ObservedResource target;
+    std::string change;
+
+    bool operator==(const PlannedEffect&) const = default;
+};
+
+struct PlannedAction {
+    PlanOp op = PlanOp::Apply;
+    FixId fix;
+    uint64_t owner = 0;
+    std::string name;
+    FixStatus status;   // the diagnosis the action was planned from
+    std::vector<PlannedEffect> effects;
+};
+
+// Output of FixEngine::plan(): what apply_all() or revert_all() would do
+struct FixPlan {
+    PlanOp goal = PlanOp::Apply;
+    std::vector<PlannedAction> actions;   // in execution order
+    // Fixes that could not be planned: their diagnosis timed out or they
+    // were still busy.  They get no action.
+    std::vector<FixReport> undiagnosed;
+};
+
+class FixExecutor;
+
 struct IFix {
     virtual ~IFix() = default;
     virtual std::string name() const = 0;
@@ -40,19 +98,273 @@ struct IFix {
     virtual FixResult apply() = 0;
     virtual FixResult revert() = 0;
     virtual FixStatus diagnose() = 0;
+
+    // Fixes that must be applied before this one.  Resolved against fixes
+    // with the same owner (or global ones); ids that are not registered are
+    // ignored.
+    virtual std::vector<FixId> dependencies() const { return {}; }
+
+    // Resources diagnose() reads.  An empty list means "unknown": the fix
+    // is re-diagnosed on every diagnose_dirty().
+    virtual std::vector<ObservedResource> observed_resources() const { return {}; }
+
+    // State apply() is about to overwrite, written to the apply journal
+    // before the fix runs.  restore_state() puts it back after a failed or
+    // interrupted transaction -- possibly in a later process, on a fresh
+    // instance.  The defaults record nothing and roll back via revert().
+    virtual registry::BackupSet capture_state() const { return {}; }
+    virtual FixResult restore_state(const registry::BackupSet&) { return revert(); }
+
+    // What apply() or revert() is expected to change, for dry-run plans.
+    // Must not modify anything.  The default predicts nothing, which is
+    // right for detect-and-warn fixes.
+    virtual std::vector<PlannedEffect> planned_effects(PlanOp) const { return {}; }
+
+    // Asynchronous variants: the work runs on `executor`'s pool and the
+    // result also goes to `on_done` on the UI thread.  The defaults adapt
+    // the synchronous methods, turning exceptions into failures.  Fixes
+    // with natively asynchronous work may override them but must always
+    // deliver on_done; the fix has to stay alive until then.
+    virtual std::future<FixResult> apply_async(FixExecutor& executor,
+                                               std::function<void(const FixResult&)> on_done = {});
+    virtual std::future<FixResult> revert_async(FixExecutor& executor,
+                                                std::function<void(const FixResult&)> on_done = {});
+    virtual std::future<FixStatus> diagnose_async(FixExecutor& executor,
+                                                  std::function<void(const FixStatus&)> on_done = {});
 };
 
+class WorkerPool;
+class ApplyJournal;
+struct JournalStep;
+
 class FixEngine {
 public:
-    void register_fix(std::unique_ptr<IFix> fix);
+    // `owner` groups fixes that belong to one display (its fingerprint) so
+    // they can be dropped together on hotplug; 0 means not display-bound.
+    // A fix is keyed by fix_id(name()) within its owner; if the key is
+    // registered twice, lookups find the first.  Fails, leaving the engine
+    // unchanged, if the fix closes a dependency cycle.
+    std::expected<void, std::string> register_fix(std::unique_ptr<IFix> fix, uint64_t owner = 0);
+    size_t remove_fixes(uint64_t owner);
+    bool has_fixes(uint64_t owner) const;
     size_t fix_count() const;
+    // Owners with at least one registered fix, in first-registration order
+    std::vector<uint64_t> owners() const;
+
+    // Apply in dependency order (registration order among independent
+    // fixes); revert in the reverse order.
     void apply_all();
     void revert_all();
+
+    // Apply on `pool`: each fix starts as soon as all of its dependencies
+    // have finished, so independent fixes run concurrently.  Blocks until
+    // every fix has been handled.
+    void apply_all(WorkerPool& pool);
+
+    // Non-blocking apply_all()/revert_all() for the UI thread.  Fixes are
+    // driven through their async interface on `executor`, in the same
+    // dependency order (reversed for revert), with independent fixes
+    // running concurrently.  All engine bookkeeping happens in completions
+    // posted back to the UI thread, where `done` runs once every fix has
+    // been handled.  Fixes already busy are skipped; fixes in flight count
+    // as busy.  The engine must outlive the run.
+    void apply_all_async(FixExecutor& executor, std::function<void()> done = {});
+    void revert_all_async(FixExecutor& executor, std::function<void()> done = {});
+
+    // apply_all_async() restricted to the fixes registered under `owners`,
+    // for hotplug deltas: the other fixes are neither diagnosed nor
+    // applied, and do not count as busy for the run.
+    void apply_async(FixExecutor& executor, const std::vector<uint64_t>& owners,
+                     std::function<void()> done = {});
+
+    // Transactional apply_all().  The fixes that need applying are written
+    // to `journal` with their captured pre-state before any of them runs.
+    // If one fails or throws, every fix already started (including the
+    // failing one) is restored newest first and the error is returned.
+    // Busy fixes are skipped.  Fails without running anything while
+    // another transaction is in flight.
+    std::expected<void, std::string> apply_all(ApplyJournal& journal);
+
+    // Non-blocking apply_all(ApplyJournal&) for the UI thread: the whole
+    // transaction runs on one of `executor`'s workers, and its result goes
+    // to `done` on the UI thread.  The fixes it runs count as busy until
+    // then.  The engine and `journal` must outlive the run.
+    void apply_all_async(FixExecutor& executor, ApplyJournal& journal,
+                         std::function<void(const std::expected<void, std::string>&)> done);
+
+    struct ToggleResult {
+        PlanOp op;
+        FixResult result;
+    };
+
+    // Revert the fix registered under (id, owner) if it is Applied, apply
+    // it otherwise, through its async interface on `executor`.  A valid
+    // cached status is reused.  `done` gets the op taken and its result on
+    // the UI thread, or nullopt if the fix is not registered or busy.
+    void toggle_async(FixExecutor& executor, FixId id, uint64_t owner,
+                      std::function<void(const std::optional<ToggleResult>&)> done);
+
+    // Finish a transaction interrupted by a crash: restore each started
+    // step of `journal`, newest first, through the registered fix with the
+    // same id and owner, then seal the journal.  Returns how many steps
+    // were restored; steps whose fix is no longer registered are skipped.
+    std::expected<size_t, std::string> recover(ApplyJournal& journal);
+
+    // Give up on asynchronous runs whose pool was cancelled and has gone
+    // idle: their fixes stop counting as busy and the transaction slot is
+    // freed, so a final revert_all() reaches every fix.
+    void abandon_async();
+
+    // Dry run of apply_all() (goal Apply) or revert_all() (goal Revert):
+    // re-diagnose stale fixes on `pool`, reusing valid cached statuses, and
+    // list the actions the real run would take, in its order, with each
+    // fix's predicted effects.  Nothing is applied or reverted.
+    FixPlan plan(WorkerPool& pool, std::chrono::milliseconds timeout, PlanOp goal = PlanOp::Apply);
+
+    // Run exactly the actions in `plan`, in order, through the fixes
+    // registered under the same id and owner; no other fix is called and
+    // nothing is re-diagnosed.  Results are in plan order; an action whose
+    // fix is gone or busy fails without running.
+    std::vector<FixResult> execute(const FixPlan& plan);
+
+    // Diagnose every fix on the calling thread.  A busy fix is not called
+    // and reports FixState::Error, as in the pooled overload.
     std::vector<FixStatus> diagnose_all();
-    IFix* get_fix(const std::string& name);
+
+    // Diagnose every fix concurrently on `pool`, waiting at most `timeout`.
+    // Statuses come back in registration order; a fix that has not finished
+    // by the deadline reports FixState::Error and keeps running in the
+    // background, and is reported as still busy until it returns.
+    std::vector<FixStatus> diagnose_all(WorkerPool& pool, std::chrono::milliseconds timeout);
+
+    // Status cache.  Each fix's last diagnosis is kept with the engine
+    // generation it was taken at; apply, revert, invalidate() and change
+    // events bump the generation for the affected fixes.  diagnose_dirty()
+    // re-diagnoses only stale fixes, and apply_all()/revert_all() reuse
+    // valid statuses, so a trigger costs one diagnose pass.  Fixes that
+    // declare no resources go stale on every change event.
+    void notify_changed(const ObservedResource& changed);
+    void mark_all_dirty();
+    void invalidate(const IFix* fix);
+    size_t dirty_count() const;
+    uint64_t generation() const { return generation_; }
+    std::vector<FixStatus> diagnose_dirty();
+    std::vector<FixStatus> diagnose_dirty(WorkerPool& pool, std::chrono::milliseconds timeout);
+
+    // Drift: fixes whose cached status is NotApplied, not counting those
+    // the first diagnosis after a successful apply already found
+    // NotApplied again.  Re-applying those changes nothing (the fix only
+    // recommends, or the system overrides it), so they must not keep a
+    // watchdog re-applying.  Never diagnoses.
+    size_t drift_count() const;
+
+    // Per-fix latency and outcome counters for every fix instance the
+    // engine has run, including removed ones, sorted by name then owner.
+    // Timings cover the synchronous calls on whichever thread ran them;
+    // for the async paths they run from dispatch to the UI-thread
+    // completion.  Safe to call while fixes are running.
+    std::vector<FixStatsSnapshot> stats() const;
+
+    // Cached statuses of the fixes registered for `owner`, in registration
+    // order.  Never diagnoses; run diagnose_dirty() first for fresh results.
+    std::vector<FixReport> report(uint64_t owner) const;
+
+    // O(1) lookup by (id, owner)
+    IFix* get_fix(FixId id, uint64_t owner = 0);
+
+    // Typed lookup for fix classes that declare `static constexpr FixId kId`.
+    // The id names exactly one class, so no dynamic_cast is needed.
+    template <typename T>
+    T* get(uint64_t owner = 0) {
+        return static_cast<T*>(get_fix(T::kId, owner));
+    }
 
 private:
-    std::vector<std::unique_ptr<IFix>> fixes_;
+    struct Entry {
+        // Shared so a timed-out diagnosis can outlive remove_fixes()
+        std::shared_ptr<IFix> fix;
+        FixId id;
+        uint64_t owner = 0;
+        std::shared_ptr<std::atomic<bool>> busy;
+        // Shared with in-flight tasks and kept in stats_ past removal
+        std::shared_ptr<FixStats> stats;
+        std::vector<FixId> dependencies;
+        std::vector<ObservedResource> resources;
+        std::optional<FixStatus> cached;
+        uint64_t cached_at = 0;
+        uint64_t invalidated_at = 0;
+        // A successful apply awaits its first diagnosis; once that is in,
+        // whether the apply left the fix NotApplied
+        bool apply_unverified = false;
+        bool apply_ineffective = false;
+    };
+
+    struct AsyncRun;
+    struct Transaction;
+    // `owners`: only run these owners' fixes; nullptr runs every fix
+    void run_async(FixExecutor& executor, bool revert, std::function<void()> done,
+                   const std::vector<uint64_t>* owners = nullptr);
+    Entry* entry_for(const IFix* fix, FixId id, uint64_t owner);
+
+    bool needs_diagnose(const Entry& e) const;
+    // What a diagnosis reports for a fix that is busy and cannot be called
+    static FixStatus still_running(const Entry& e);
+    std::optional<FixStatus> valid_status(const Entry& e) const;
+    void store_status(Entry& e, const FixStatus& status, uint64_t snapshot);
+    void invalidate(Entry& e);
+    // Invalidate after the fix's own apply, revert or restore; a successful
+    // apply gets verified by the next diagnosis
+    void ran(Entry& e, bool apply_succeeded);
+    // Diagnose `which` on `pool`; completed[i] is false for fixes that did
+    // not finish (their status is a synthesized Error)
+    std::vector<FixStatus> run_diagnoses(WorkerPool& pool, std::chrono::milliseconds timeout,
+                                         const std::vector<size_t>& which,
+                                         std::vector<bool>& completed);
+
+    // Restore steps[0, count) newest first; returns how many succeeded
+    size_t restore_steps(const std::vector<JournalStep>& steps, size_t count);
+
+    // Collect the fixes of a journaled apply and mark them busy; nullptr
+    // if another transaction is in flight
+    std::shared_ptr<Transaction> begin_transaction(ApplyJournal& journal);
+    // Cache, invalidate and release the transaction's fixes; its result
+    std::expected<void, std::string> finish_transaction(Transaction& txn);
+
+    // Indices of the registered fixes that fix i depends on
+    std::vector<size_t> resolve_dependencies(size_t i) const;
+    // deps[i] = resolve_dependencies(i) for every fix
+    std::vector<std::vector<size_t>> dependency_edges() const;
+    // Whether fix `start` is among its own transitive dependencies; O(fixes
+    // it reaches), so registration need not build the whole order
+    bool reaches_itself(size_t start) const;
+    // Kahn's algorithm, stable by registration index; nullopt on a cycle
+    std::optional<std::vector<size_t>> topological_order() const;
+
+    struct Key {
+        uint64_t owner;
+        FixId id;
+
+        bool operator==(const Key&) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            return static_cast<size_t>(k.id.value ^ (k.owner * 0x9e3779b97f4a7c15ULL));
+        }
+    };
+
+    std::optional<size_t> find(FixId id, uint64_t owner) const;
+    void reindex();
+
+    std::vector<Entry> fixes_;
+    // (owner, id) -> index into fixes_
+    std::unordered_map<Key, size_t, KeyHash> index_;
+    struct StatsRecord {
+        std::string name;
+        std::shared_ptr<FixStats> stats;
+    };
+    std::unordered_map<Key, StatsRecord, KeyHash> stats_;
+    uint64_t generation_ = 0;
+    bool transaction_active_ = false;   // they share one journal
 };
 
 } // namespace hdrfixer::fixes
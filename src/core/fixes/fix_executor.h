@@ -0,0 +1,50 @@
+#pragma once
+#include "worker_pool.h"
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+
+namespace hdrfixer::fixes {
+
+// Runs fix work on a WorkerPool and hands results back to the UI thread.
+// `post` must queue its argument to run on the UI thread (the tray app
+// posts a window message); it is called from worker threads and may be
+// called after the executor itself is gone, so it should not capture
+// state that dies first.
+class FixExecutor {
+public:
+    using Post = std::function<void(std::function<void()>)>;
+
+    FixExecutor(WorkerPool& pool, Post post)
+        : pool_(pool), post_(std::move(post)) {}
+
+    WorkerPool& pool() { return pool_; }
+    void post(std::function<void()> task) { post_(std::move(task)); }
+
+    // Run `work` on the pool.  Its result is delivered to the returned
+    // future and, on the UI thread, to `on_done`.  If `work` throws, the
+    // future carries the exception and `on_done` is not called.
+    template <typename T>
+    std::future<T> run(std::function<T()> work, std::function<void(const T&)> on_done = {}) {
+        auto promise = std::make_shared<std::promise<T>>();
+        auto future = promise->get_future();
+        pool_.submit([post = post_, work = std::move(work), on_done = std::move(on_done), promise] {
+            try {
+                T result = work();
+                if (on_done) post([on_done, result] { on_done(result); });
+                promise->set_value(std::move(result));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        return future;
+    }
+
+private:
+    WorkerPool& pool_;
+    Post post_;
+};
+
+} // namespace hdrfixer::fixes
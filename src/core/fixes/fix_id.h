@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+namespace hdrfixer::fixes {
+
+// Stable identifier of a fix type: the 64-bit FNV-1a hash of its name.
+// Fix classes expose `static constexpr FixId kId = fix_id(kName)` so
+// lookups and dependencies are resolved at compile time instead of by
+// comparing name strings.
+struct FixId {
+    uint64_t value = 0;
+
+    constexpr bool operator==(const FixId&) const = default;
+};
+
+constexpr FixId fix_id(std::string_view name) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (char c : name) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 0x100000001b3ULL;
+    }
+    return FixId{h};
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,211 @@
+#include "fix_plan.h"
+#include <charconv>
+#include <vector>
+
+namespace hdrfixer::fixes {
+
+namespace {
+
+constexpr std::string_view kHeader = "hdrfixer-plan";
+constexpr std::string_view kVersion = "1";
+
+const char* op_name(PlanOp op) {
+    return op == PlanOp::Apply ? "apply" : "revert";
+}
+
+const char* state_name(FixState state) {
+    switch (state) {
+        case FixState::NotApplied: return "not_applied";
+        case FixState::Applied: return "applied";
+        case FixState::Error: return "error";
+        case FixState::NotNeeded: return "not_needed";
+        case FixState::Warning: return "warning";
+    }
+    return "error";
+}
+
+const char* kind_name(ResourceKind kind) {
+    switch (kind) {
+        case ResourceKind::RegistryKey: return "registry_key";
+        case ResourceKind::DisplayTarget: return "display_target";
+        case ResourceKind::File: return "file";
+    }
+    return "file";
+}
+
+std::optional<PlanOp> parse_op(std::string_view s) {
+    if (s == "apply") return PlanOp::Apply;
+    if (s == "revert") return PlanOp::Revert;
+    return std::nullopt;
+}
+
+std::optional<FixState> parse_state(std::string_view s) {
+    for (auto state : {FixState::NotApplied, FixState::Applied, FixState::Error, FixState::NotNeeded,
+                       FixState::Warning}) {
+        if (s == state_name(state)) return state;
+    }
+    return std::nullopt;
+}
+
+std::optional<ResourceKind> parse_kind(std::string_view s) {
+    for (auto kind : {ResourceKind::RegistryKey, ResourceKind::DisplayTarget, ResourceKind::File}) {
+        if (s == kind_name(kind)) return kind;
+    }
+    return std::nullopt;
+}
+
+std::string hex(uint64_t v) {
+    char buf[17];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), v, 16);
+    return std::string(buf, end);
+}
+
+std::optional<uint64_t> parse_hex(std::string_view s) {
+    uint64_t v = 0;
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), v, 16);
+    if (ec != std::errc() || end != s.data() + s.size() || s.empty()) return std::nullopt;
+    return v;
+}
+
+void put_field(std::string& out, std::string_view field) {
+    out += '\t';
+    for (char c : field) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out += c; break;
+        }
+    }
+}
+
+std::optional<std::string> unescape(std::string_view field) {
+    std::string out;
+    out.reserve(field.size());
+    for (size_t i = 0; i < field.size(); ++i) {
+        if (field[i] != '\\') {
+            out += field[i];
+            continue;
+        }
+        if (++i == field.size()) return std::nullopt;
+        switch (field[i]) {
+            case '\\': out += '\\'; break;
+            case 't': out += '\t'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            default: return std::nullopt;
+        }
+    }
+    return out;
+}
+
+std::vector<std::string_view> split(std::string_view line) {
+    std::vector<std::string_view> fields;
+    size_t start = 0;
+    while (true) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab - start));
+        if (tab == std::string_view::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+} // namespace
+
+std::string serialize_plan(const FixPlan& plan) {
+    std::string out(kHeader);
+    put_field(out, kVersion);
+    put_field(out, op_name(plan.goal));
+    out += '\n';
+
+    for (const auto& action : plan.actions) {
+        out += "action";
+        put_field(out, op_name(action.op));
+        put_field(out, hex(action.fix.value));
+        put_field(out, hex(action.owner));
+        put_field(out, state_name(action.status.state));
+        put_field(out, action.name);
+        put_field(out, action.status.message);
+        out += '\n';
+        for (const auto& effect : action.effects) {
+            out += "effect";
+            put_field(out, kind_name(effect.target.kind));
+            put_field(out, effect.target.key);
+            put_field(out, effect.change);
+            out += '\n';
+        }
+    }
+    for (const auto& fix : plan.undiagnosed) {
+        out += "undiagnosed";
+        put_field(out, hex(fix.id.value));
+        put_field(out, hex(fix.owner));
+        put_field(out, fix.name);
+        out += '\n';
+    }
+    return out;
+}
+
+std::expected<FixPlan, std::string> parse_plan(std::string_view text) {
+    FixPlan plan;
+    size_t line_no = 0;
+    bool header = false;
+
+    while (!text.empty()) {
+        size_t nl = text.find('\n');
+        std::string_view line = text.substr(0, nl);
+        text = nl == std::string_view::npos ? std::string_view{} : text.substr(nl + 1);
+        ++line_no;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+
+        auto error = [&](const std::string& what) {
+            return std::unexpected("Plan line " + std::to_string(line_no) + ": " + what);
+        };
+
+        auto raw = split(line);
+        std::vector<std::string> f;
+        for (size_t i = 1; i < raw.size(); ++i) {
+            auto field = unescape(raw[i]);
+            if (!field) return error("bad escape sequence");
+            f.push_back(std::move(*field));
+        }
+
+        if (!header) {
+            if (raw[0] != kHeader || f.size() != 2) return error("not a fix plan");
+            if (f[0] != kVersion) return error("unsupported plan version " + f[0]);
+            auto goal = parse_op(f[1]);
+            if (!goal) return error("unknown goal '" + f[1] + "'");
+            plan.goal = *goal;
+            header = true;
+        } else if (raw[0] == "action") {
+            if (f.size() != 6) return error("action needs 6 fields");
+            auto op = parse_op(f[0]);
+            auto id = parse_hex(f[1]);
+            auto owner = parse_hex(f[2]);
+            auto state = parse_state(f[3]);
+            if (!op || !id || !owner || !state) return error("malformed action");
+            plan.actions.push_back({*op, FixId{*id}, *owner, f[4], {*state, f[5]}, {}});
+        } else if (raw[0] == "effect") {
+            if (f.size() != 3) return error("effect needs 3 fields");
+            if (plan.actions.empty()) return error("effect before any action");
+            auto kind = parse_kind(f[0]);
+            if (!kind) return error("unknown resource kind '" + f[0] + "'");
+            plan.actions.back().effects.push_back({{*kind, f[1]}, f[2]});
+        } else if (raw[0] == "undiagnosed") {
+            if (f.size() != 3) return error("undiagnosed needs 3 fields");
+            auto id = parse_hex(f[0]);
+            auto owner = parse_hex(f[1]);
+            if (!id || !owner) return error("malformed undiagnosed fix");
+            plan.undiagnosed.push_back({f[2], FixId{*id}, *owner, std::nullopt});
+        } else {
+            return error("unknown record '" + std::string(raw[0]) + "'");
+        }
+    }
+
+    if (!header) return std::unexpected("Plan is empty");
+    return plan;
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,21 @@
+#pragma once
+#include "fix_engine.h"
+#include <expected>
+#include <string>
+#include <string_view>
+
+namespace hdrfixer::fixes {
+
+// Text form of a FixPlan for audits: one tab-separated record per line,
+//
+//   hdrfixer-plan  1  apply
+//   action         apply  <id hex>  <owner hex>  <state>  <name>  <message>
+//   effect         <kind>  <key>  <change>          (belongs to the action above)
+//   undiagnosed    <id hex>  <owner hex>  <name>
+//
+// Tabs, newlines and backslashes inside fields are backslash-escaped, so
+// every record stays on one line and diffs cleanly across machines.
+std::string serialize_plan(const FixPlan& plan);
+std::expected<FixPlan, std::string> parse_plan(std::string_view text);
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,112 @@
+#include "fix_stats.h"
+#include <bit>
+#include <cstdio>
+
+namespace hdrfixer::fixes {
+
+const char* fix_op_name(FixOp op) {
+    switch (op) {
+        case FixOp::Diagnose: return "diagnose";
+        case FixOp::Apply: return "apply";
+        case FixOp::Revert: return "revert";
+    }
+    return "unknown";
+}
+
+uint64_t HistogramSnapshot::percentile_us(double p) const {
+    if (count == 0) return 0;
+    auto rank = static_cast<uint64_t>(p * static_cast<double>(count));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t k = 0; k < kBuckets; ++k) {
+        seen += buckets[k];
+        if (seen >= rank) return uint64_t{1} << k;
+    }
+    return uint64_t{1} << (kBuckets - 1);
+}
+
+double HistogramSnapshot::mean_us() const {
+    if (count == 0) return 0.0;
+    return static_cast<double>(total_ns) / 1000.0 / static_cast<double>(count);
+}
+
+size_t LatencyHistogram::bucket_for(std::chrono::nanoseconds elapsed) {
+    auto us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    if (elapsed.count() < 0) us = 0;
+    size_t k = static_cast<size_t>(std::bit_width(us));
+    return k < HistogramSnapshot::kBuckets ? k : HistogramSnapshot::kBuckets - 1;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds elapsed) {
+    uint64_t ns = elapsed.count() > 0 ? static_cast<uint64_t>(elapsed.count()) : 0;
+    buckets_[bucket_for(elapsed)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_ns_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max = max_ns_.load(std::memory_order_relaxed);
+    while (ns > max && !max_ns_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot s;
+    for (size_t k = 0; k < s.buckets.size(); ++k) {
+        s.buckets[k] = buckets_[k].load(std::memory_order_relaxed);
+    }
+    s.count = count_.load(std::memory_order_relaxed);
+    s.total_ns = total_ns_.load(std::memory_order_relaxed);
+    s.max_ns = max_ns_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void FixStats::record(FixOp op, std::chrono::nanoseconds elapsed, FixOutcome outcome) {
+    ops_[static_cast<size_t>(op)].latency.record(elapsed);
+    count(op, outcome);
+}
+
+void FixStats::count(FixOp op, FixOutcome outcome) {
+    auto& o = ops_[static_cast<size_t>(op)];
+    switch (outcome) {
+        case FixOutcome::Success: o.success.fetch_add(1, std::memory_order_relaxed); break;
+        case FixOutcome::Failure: o.failure.fetch_add(1, std::memory_order_relaxed); break;
+        case FixOutcome::NotNeeded: o.not_needed.fetch_add(1, std::memory_order_relaxed); break;
+    }
+}
+
+OpStatsSnapshot FixStats::snapshot(FixOp op) const {
+    const auto& o = ops_[static_cast<size_t>(op)];
+    OpStatsSnapshot s;
+    s.latency = o.latency.snapshot();
+    s.success = o.success.load(std::memory_order_relaxed);
+    s.failure = o.failure.load(std::memory_order_relaxed);
+    s.not_needed = o.not_needed.load(std::memory_order_relaxed);
+    return s;
+}
+
+std::vector<std::string> format_stats(const std::vector<FixStatsSnapshot>& stats) {
+    std::vector<std::string> lines;
+    for (const auto& fix : stats) {
+        for (size_t op = 0; op < kFixOpCount; ++op) {
+            const auto& s = fix.ops[op];
+            if (s.latency.count == 0 && s.success + s.failure + s.not_needed == 0) continue;
+
+            char owner[32];
+            std::snprintf(owner, sizeof(owner), "%llx", static_cast<unsigned long long>(fix.owner));
+            char mean[32];
+            std::snprintf(mean, sizeof(mean), "%.0f", s.latency.mean_us());
+            lines.push_back(fix.name + " [owner " + owner + "] " +
+                            fix_op_name(static_cast<FixOp>(op)) + ": n=" +
+                            std::to_string(s.latency.count) +
+                            " ok=" + std::to_string(s.success) +
+                            " fail=" + std::to_string(s.failure) +
+                            " skip=" + std::to_string(s.not_needed) +
+                            " mean=" + mean + "us" +
+                            " p50<=" + std::to_string(s.latency.percentile_us(0.5)) + "us" +
+                            " p99<=" + std::to_string(s.latency.percentile_us(0.99)) + "us" +
+                            " max=" + std::to_string(s.latency.max_ns / 1000) + "us" +
+                            (fix.registered ? "" : " (removed)"));
+        }
+    }
+    return lines;
+}
+
+} // namespace hdrfixer::fixes
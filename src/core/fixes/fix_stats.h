@@ -0,0 +1,99 @@
+#pragma once
+#include "fix_id.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hdrfixer::fixes {
+
+enum class FixOp {
+    Diagnose,
+    Apply,
+    Revert
+};
+constexpr size_t kFixOpCount = 3;
+
+const char* fix_op_name(FixOp op);
+
+enum class FixOutcome {
+    Success,
+    Failure,
+    NotNeeded   // diagnosed NotNeeded, or an apply/revert that was skipped
+};
+
+struct HistogramSnapshot {
+    // bucket 0 is < 1 us; bucket k holds [2^(k-1), 2^k) us; the last bucket
+    // is open-ended
+    static constexpr size_t kBuckets = 26;
+
+    std::array<uint64_t, kBuckets> buckets{};
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+
+    // Upper bound of the bucket holding the p-th percentile (0 < p <= 1);
+    // 0 if empty
+    uint64_t percentile_us(double p) const;
+    double mean_us() const;
+};
+
+// Fixed-bucket log2 latency histogram.  record() is wait-free (relaxed
+// atomic adds plus a CAS loop for the max), so workers can record
+// concurrently with snapshot() on the UI thread.  A snapshot taken while
+// records are in flight may be off by those records.
+class LatencyHistogram {
+public:
+    void record(std::chrono::nanoseconds elapsed);
+    HistogramSnapshot snapshot() const;
+
+    static size_t bucket_for(std::chrono::nanoseconds elapsed);
+
+private:
+    std::array<std::atomic<uint64_t>, HistogramSnapshot::kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> total_ns_{0};
+    std::atomic<uint64_t> max_ns_{0};
+};
+
+struct OpStatsSnapshot {
+    HistogramSnapshot latency;
+    uint64_t success = 0;
+    uint64_t failure = 0;
+    uint64_t not_needed = 0;
+};
+
+// Latency and outcome counters for one fix instance, per operation
+class FixStats {
+public:
+    void record(FixOp op, std::chrono::nanoseconds elapsed, FixOutcome outcome);
+    // Outcome without a timed call (e.g. apply skipped as not needed)
+    void count(FixOp op, FixOutcome outcome);
+    OpStatsSnapshot snapshot(FixOp op) const;
+
+private:
+    struct Op {
+        LatencyHistogram latency;
+        std::atomic<uint64_t> success{0};
+        std::atomic<uint64_t> failure{0};
+        std::atomic<uint64_t> not_needed{0};
+    };
+    std::array<Op, kFixOpCount> ops_;
+};
+
+struct FixStatsSnapshot {
+    std::string name;
+    FixId id;
+    uint64_t owner = 0;
+    bool registered = false;   // false once removed (e.g. display unplugged)
+    std::array<OpStatsSnapshot, kFixOpCount> ops;
+};
+
+// One log line per fix and operation that has data, e.g.
+//   "SDR Brightness [owner 1f2e] diagnose: n=12 ok=9 fail=0 skip=3 mean=210us p50<=256us p99<=1024us max=812us"
+std::vector<std::string> format_stats(const std::vector<FixStatsSnapshot>& stats);
+
+} // namespace hdrfixer::fixes
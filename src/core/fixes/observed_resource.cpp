@@ -0,0 +1,101 @@
+#include "observed_resource.h"
+#include <cstdio>
+
+namespace hdrfixer::fixes {
+
+namespace {
+
+// UTF-16 (as used by wchar_t on Windows) to UTF-8; unpaired surrogates
+// become U+FFFD.
+std::string to_utf8(std::wstring_view wide) {
+    std::string out;
+    out.reserve(wide.size());
+    for (size_t i = 0; i < wide.size(); ++i) {
+        uint32_t cp = static_cast<uint32_t>(wide[i]);
+        if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < wide.size()) {
+            uint32_t low = static_cast<uint32_t>(wide[i + 1]);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                ++i;
+            }
+        }
+        if (cp >= 0xD800 && cp <= 0xDFFF) cp = 0xFFFD;
+
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+    return out;
+}
+
+char fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool equal_ci(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (fold(a[i]) != fold(b[i])) return false;
+    }
+    return true;
+}
+
+// `prefix` is `path` itself or one of its ancestor keys
+bool is_key_prefix(std::string_view prefix, std::string_view path) {
+    if (prefix.size() > path.size()) return false;
+    if (!equal_ci(prefix, path.substr(0, prefix.size()))) return false;
+    return prefix.size() == path.size() || path[prefix.size()] == '\\';
+}
+
+// `dir` is `path` itself or one of the directories above it
+bool is_path_prefix(std::string_view dir, std::string_view path) {
+    while (!dir.empty() && (dir.back() == '\\' || dir.back() == '/')) dir.remove_suffix(1);
+    if (dir.size() > path.size()) return false;
+    if (!equal_ci(dir, path.substr(0, dir.size()))) return false;
+    return dir.size() == path.size() || path[dir.size()] == '\\' || path[dir.size()] == '/';
+}
+
+} // anonymous namespace
+
+ObservedResource ObservedResource::registry_key(std::wstring_view hive, std::wstring_view path) {
+    return {ResourceKind::RegistryKey, to_utf8(hive) + "\\" + to_utf8(path)};
+}
+
+ObservedResource ObservedResource::display_target(uint64_t adapter_luid, uint32_t target_id) {
+    char buf[40];
+    std::snprintf(buf, sizeof(buf), "%016llx:%u",
+                  static_cast<unsigned long long>(adapter_luid), target_id);
+    return {ResourceKind::DisplayTarget, buf};
+}
+
+ObservedResource ObservedResource::file(std::wstring_view path) {
+    return {ResourceKind::File, to_utf8(path)};
+}
+
+bool resource_affected(const ObservedResource& observed, const ObservedResource& changed) {
+    if (observed.kind != changed.kind) return false;
+    switch (observed.kind) {
+        case ResourceKind::RegistryKey:
+            return is_key_prefix(changed.key, observed.key) ||
+                   is_key_prefix(observed.key, changed.key);
+        case ResourceKind::File:
+            return is_path_prefix(changed.key, observed.key);
+        case ResourceKind::DisplayTarget:
+            return observed.key == changed.key;
+    }
+    return false;
+}
+
+} // namespace hdrfixer::fixes
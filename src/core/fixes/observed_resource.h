@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace hdrfixer::fixes {
+
+enum class ResourceKind {
+    RegistryKey,     // key path incl. hive, e.g. "HKLM\SYSTEM\...\GraphicsDrivers"
+    DisplayTarget,   // one DisplayConfig target (adapter LUID + target id)
+    File
+};
+
+// Something a fix's diagnosis reads, so the engine can tell which cached
+// statuses a change event invalidates.  Keys are UTF-8.
+struct ObservedResource {
+    ResourceKind kind = ResourceKind::RegistryKey;
+    std::string key;
+
+    static ObservedResource registry_key(std::wstring_view hive, std::wstring_view path);
+    static ObservedResource display_target(uint64_t adapter_luid, uint32_t target_id);
+    static ObservedResource file(std::wstring_view path);
+
+    bool operator==(const ObservedResource&) const = default;
+};
+
+// True if a change to `changed` can affect a fix observing `observed`.
+// Registry keys match on either side of a key-path prefix (a subtree
+// notification on a parent covers every key below it, and a change below
+// an observed key changes what reading it returns).  A changed file also
+// matches when it is a directory holding the observed one, since directory
+// notifications do not name the file.  Registry and file paths compare
+// case-insensitively, as on Windows.
+bool resource_affected(const ObservedResource& observed, const ObservedResource& changed);
+
+} // namespace hdrfixer::fixes
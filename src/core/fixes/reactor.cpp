@@ -0,0 +1,278 @@
+#include "reactor.h"
+#include <algorithm>
+#include <future>
+
+namespace hdrfixer::fixes {
+
+PortableReactorBackend::PortableReactorBackend(bool virtual_clock) : virtual_clock_(virtual_clock) {}
+
+void PortableReactorBackend::signal(ReactorHandle handle) {
+    {
+        std::lock_guard lock(mutex_);
+        signaled_.insert(handle);
+    }
+    cv_.notify_all();
+}
+
+PortableReactorBackend::Clock::time_point PortableReactorBackend::now() const {
+    if (!virtual_clock_) return Clock::now();
+    std::lock_guard lock(mutex_);
+    return virtual_now_;
+}
+
+void PortableReactorBackend::wait(const std::vector<ReactorHandle>& handles,
+                                  std::optional<Clock::time_point> deadline,
+                                  std::vector<size_t>& signaled) {
+    std::unique_lock lock(mutex_);
+    auto pending = [&] {
+        return woken_ || std::any_of(handles.begin(), handles.end(),
+                                     [&](ReactorHandle h) { return signaled_.contains(h); });
+    };
+    if (virtual_clock_) {
+        if (!pending() && deadline) virtual_now_ = std::max(virtual_now_, *deadline);
+    } else if (deadline) {
+        cv_.wait_until(lock, *deadline, pending);
+    } else {
+        cv_.wait(lock, pending);
+    }
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (signaled_.erase(handles[i])) signaled.push_back(i);
+    }
+    woken_ = false;
+}
+
+void PortableReactorBackend::wake() {
+    {
+        std::lock_guard lock(mutex_);
+        woken_ = true;
+    }
+    cv_.notify_all();
+}
+
+Reactor::Reactor(std::unique_ptr<IReactorBackend> backend, ReactorConfig config)
+    : backend_(std::move(backend)), config_(config) {}
+
+Reactor::~Reactor() {
+    stop();
+}
+
+void Reactor::start() {
+    std::lock_guard lock(mutex_);
+    if (running_.load(std::memory_order_acquire)) return;
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&Reactor::thread_func, this);
+}
+
+void Reactor::stop() {
+    {
+        std::lock_guard lock(mutex_);
+        running_.store(false, std::memory_order_release);
+    }
+    backend_->wake();
+    if (thread_.joinable()) thread_.join();
+
+    // Posted tasks nobody will dispatch now; call() may be waiting on one
+    std::vector<Ready> leftover;
+    {
+        std::lock_guard lock(mutex_);
+        auto posted = std::stable_partition(ready_.begin(), ready_.end(),
+                                            [](const Ready& r) { return r.id != 0; });
+        std::move(posted, ready_.end(), std::back_inserter(leftover));
+        ready_.erase(posted, ready_.end());
+    }
+    for (auto& r : leftover) r.task();
+}
+
+void Reactor::thread_func() {
+    thread_id_.store(std::this_thread::get_id());
+    while (running_.load(std::memory_order_acquire)) {
+        run_once();
+    }
+    thread_id_.store(std::thread::id{});
+}
+
+void Reactor::post(Task task, ReactorPriority priority) {
+    {
+        std::lock_guard lock(mutex_);
+        ready_.push_back({0, std::move(task), priority, backend_->now(), next_seq_++});
+    }
+    backend_->wake();
+}
+
+void Reactor::call(Task task) {
+    std::promise<void> done;
+    {
+        std::lock_guard lock(mutex_);
+        if (running_.load(std::memory_order_acquire) && !on_reactor_thread()) {
+            ready_.push_back({0, [&] { task(); done.set_value(); }, ReactorPriority::High,
+                              backend_->now(), next_seq_++});
+        } else {
+            done.set_value();
+        }
+    }
+    auto future = done.get_future();
+    if (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        task();   // inline: stopped, or already on the reactor thread
+        return;
+    }
+    backend_->wake();
+    future.wait();
+}
+
+std::expected<ReactorId, std::string> Reactor::add_handle(ReactorHandle handle, Task on_signaled,
+                                                          ReactorPriority priority) {
+    if (!handle) return std::unexpected(std::string("Reactor: null handle"));
+    ReactorId id;
+    {
+        std::lock_guard lock(mutex_);
+        size_t handles = std::count_if(handlers_.begin(), handlers_.end(),
+                                       [](const auto& e) { return e.second.kind == Kind::Handle; });
+        if (handles >= backend_->max_handles()) {
+            return std::unexpected("Reactor: at most " + std::to_string(backend_->max_handles()) +
+                                   " handles can be watched");
+        }
+        id = next_id_++;
+        handlers_.emplace(id, Handler{Kind::Handle, handle, std::move(on_signaled), priority,
+                                      std::nullopt, {}, false});
+    }
+    backend_->wake();   // re-enter the wait with the new handle
+    return id;
+}
+
+ReactorId Reactor::add_timer(Clock::duration delay, Task task, ReactorPriority priority,
+                             Clock::duration period) {
+    ReactorId id;
+    {
+        std::lock_guard lock(mutex_);
+        id = next_id_++;
+        auto due = backend_->now() + std::max(delay, Clock::duration::zero());
+        handlers_.emplace(id, Handler{Kind::Timer, nullptr, std::move(task), priority, due,
+                                      std::max(period, Clock::duration::zero()), false});
+    }
+    backend_->wake();
+    return id;
+}
+
+ReactorId Reactor::add_signal(Task task, ReactorPriority priority) {
+    std::lock_guard lock(mutex_);
+    ReactorId id = next_id_++;
+    handlers_.emplace(id, Handler{Kind::Signal, nullptr, std::move(task), priority, std::nullopt, {}, false});
+    return id;
+}
+
+void Reactor::signal(ReactorId id) {
+    {
+        std::lock_guard lock(mutex_);
+        auto it = handlers_.find(id);
+        if (it == handlers_.end() || it->second.kind != Kind::Signal) return;
+        enqueue(id, it->second, backend_->now());
+    }
+    backend_->wake();
+}
+
+void Reactor::remove(ReactorId id) {
+    {
+        std::lock_guard lock(mutex_);
+        if (!handlers_.erase(id)) return;
+        std::erase_if(ready_, [id](const Ready& r) { return r.id == id; });
+    }
+    backend_->wake();
+}
+
+void Reactor::enqueue(ReactorId id, Handler& h, Clock::time_point since) {
+    // Repeated events before the handler runs coalesce into one dispatch
+    if (h.queued) return;
+    h.queued = true;
+    ready_.push_back({id, h.task, h.priority, since, next_seq_++});
+}
+
+size_t Reactor::run_once(std::optional<Clock::time_point> until) {
+    std::vector<ReactorHandle> handles;
+    std::vector<ReactorId> handle_ids;
+    std::optional<Clock::time_point> deadline = until;
+    {
+        std::lock_guard lock(mutex_);
+        for (const auto& [id, h] : handlers_) {
+            if (h.kind == Kind::Handle) {
+                handles.push_back(h.handle);
+                handle_ids.push_back(id);
+            }
+            if (h.due && (!deadline || *h.due < *deadline)) deadline = h.due;
+        }
+        // Work left over from the last turn: only poll
+        if (!ready_.empty()) deadline = backend_->now();
+    }
+
+    std::vector<size_t> signaled;
+    backend_->wait(handles, deadline, signaled);
+
+    std::vector<Ready> batch;
+    {
+        std::lock_guard lock(mutex_);
+        ++stats_.turns;
+        auto now = backend_->now();
+        for (size_t i : signaled) {
+            auto it = handlers_.find(handle_ids[i]);
+            if (it != handlers_.end()) enqueue(it->first, it->second, now);
+        }
+        for (auto& [id, h] : handlers_) {
+            if (!h.due || *h.due > now) continue;
+            // Latency counts from when the timer was due, not when noticed
+            enqueue(id, h, *h.due);
+            if (h.period > Clock::duration::zero()) {
+                // Skip missed periods instead of firing a burst to catch up
+                h.due = std::max(*h.due + h.period, now);
+            } else {
+                h.due.reset();
+            }
+        }
+
+        auto effective = [&](const Ready& r) {
+            return now - r.since >= config_.max_delay ? ReactorPriority::High : r.priority;
+        };
+        std::stable_sort(ready_.begin(), ready_.end(), [&](const Ready& a, const Ready& b) {
+            auto pa = effective(a), pb = effective(b);
+            return pa != pb ? pa < pb : a.seq < b.seq;
+        });
+        size_t take = std::min(ready_.size(), std::max<size_t>(config_.max_batch, 1));
+        for (size_t i = 0; i < take; ++i) {
+            auto& r = ready_[i];
+            if (r.id != 0) handlers_.at(r.id).queued = false;
+            if (effective(r) != r.priority) ++stats_.priorities[static_cast<size_t>(r.priority)].promoted;
+            batch.push_back(std::move(r));
+        }
+        ready_.erase(ready_.begin(), ready_.begin() + static_cast<std::ptrdiff_t>(take));
+    }
+
+    size_t dispatched = 0;
+    for (auto& r : batch) {
+        {
+            std::lock_guard lock(mutex_);
+            // An earlier handler in this batch may have removed this one
+            if (r.id != 0 && !handlers_.contains(r.id)) continue;
+            auto latency = std::chrono::duration_cast<std::chrono::microseconds>(backend_->now() - r.since);
+            auto& s = stats_.priorities[static_cast<size_t>(r.priority)];
+            ++s.dispatched;
+            s.total_latency += latency;
+            s.max_latency = std::max(s.max_latency, latency);
+        }
+        r.task();
+        ++dispatched;
+        if (r.id != 0) {
+            // A one-shot timer is done once it has run
+            std::lock_guard lock(mutex_);
+            auto it = handlers_.find(r.id);
+            if (it != handlers_.end() && it->second.kind == Kind::Timer && !it->second.due) {
+                handlers_.erase(it);
+            }
+        }
+    }
+    return dispatched;
+}
+
+ReactorStats Reactor::stats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,186 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hdrfixer::fixes {
+
+enum class ReactorPriority : uint8_t { High, Normal, Low };
+inline constexpr size_t kReactorPriorities = 3;
+
+// Opaque waitable OS object: a HANDLE on Windows
+using ReactorHandle = void*;
+// Names a registered handle, timer or signal; 0 is never used
+using ReactorId = uint64_t;
+
+struct ReactorConfig {
+    // Handlers dispatched per turn before the reactor polls its handles and
+    // timers again, so a flood of ready work cannot hide new events
+    size_t max_batch = 16;
+    // Ready work waiting longer than this runs as High, so Low work is
+    // delayed by higher priorities but never starved
+    std::chrono::milliseconds max_delay{100};
+};
+
+struct ReactorStats {
+    struct Priority {
+        uint64_t dispatched = 0;
+        uint64_t promoted = 0;                  // ran as High after max_delay
+        std::chrono::microseconds total_latency{0};   // ready -> dispatch
+        std::chrono::microseconds max_latency{0};
+    };
+    std::array<Priority, kReactorPriorities> priorities;   // by original priority
+    uint64_t turns = 0;
+};
+
+// The wait primitive under a Reactor.  wait() comes only from the reactor's
+// thread; wake() from any thread.
+class IReactorBackend {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    virtual ~IReactorBackend() = default;
+
+    virtual Clock::time_point now() const = 0;
+    // Most handles one wait() can multiplex
+    virtual size_t max_handles() const = 0;
+    // Block until a handle signals, wake() is called, or `deadline` passes
+    // (nullopt: no deadline).  Appends the indices of signaled handles.
+    virtual void wait(const std::vector<ReactorHandle>& handles,
+                      std::optional<Clock::time_point> deadline,
+                      std::vector<size_t>& signaled) = 0;
+    virtual void wake() = 0;
+};
+
+// Backend without OS handles, for tests, benchmarks and non-Windows builds:
+// a "handle" is any pointer, signaled with signal().  With a virtual clock,
+// wait() never blocks; it jumps to the deadline instead, so timer-heavy
+// tests and trace replays run instantly.
+class PortableReactorBackend : public IReactorBackend {
+public:
+    explicit PortableReactorBackend(bool virtual_clock = false);
+
+    // Thread-safe; a handle signaled twice before a wait() reports once
+    void signal(ReactorHandle handle);
+
+    Clock::time_point now() const override;
+    size_t max_handles() const override { return 1024; }
+    void wait(const std::vector<ReactorHandle>& handles,
+              std::optional<Clock::time_point> deadline,
+              std::vector<size_t>& signaled) override;
+    void wake() override;
+
+private:
+    const bool virtual_clock_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::set<ReactorHandle> signaled_;
+    bool woken_ = false;
+    Clock::time_point virtual_now_{};
+};
+
+// One thread multiplexing every background change source: OS handles,
+// timers, user-level signals and posted tasks.  Ready work is dispatched
+// in priority order, at most max_batch handlers per turn; work waiting
+// longer than max_delay is promoted to High.
+//
+// Everything but run_once() is thread-safe.  Handlers run on the reactor
+// thread, outside its lock, so they may register and remove freely.
+// Removing an id also drops its dispatches that are queued but not yet
+// running; a handler already running finishes.
+class Reactor {
+public:
+    using Clock = IReactorBackend::Clock;
+    using Task = std::function<void()>;
+
+    explicit Reactor(std::unique_ptr<IReactorBackend> backend, ReactorConfig config = {});
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    // Start/stop the reactor thread.  stop() runs still-queued posted tasks
+    // on the calling thread, so call() never waits forever.
+    void start();
+    void stop();
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // Run `task` once on the reactor thread
+    void post(Task task, ReactorPriority priority = ReactorPriority::Normal);
+    // Run `task` on the reactor thread and wait for it; runs inline when
+    // called from the reactor thread or while the reactor is stopped
+    void call(Task task);
+
+    // Run `on_signaled` each time `handle` signals
+    std::expected<ReactorId, std::string> add_handle(ReactorHandle handle, Task on_signaled,
+                                                     ReactorPriority priority = ReactorPriority::Normal);
+    // Run `task` after `delay`, then every `period` if non-zero
+    ReactorId add_timer(Clock::duration delay, Task task,
+                        ReactorPriority priority = ReactorPriority::Normal,
+                        Clock::duration period = Clock::duration::zero());
+    // Run `task` after each signal(); signals before it runs coalesce
+    ReactorId add_signal(Task task, ReactorPriority priority = ReactorPriority::Normal);
+    void signal(ReactorId id);
+    // No-op for unknown ids
+    void remove(ReactorId id);
+
+    // One turn on the calling thread: wait for events (not past `until`,
+    // if given), then dispatch up to max_batch ready handlers.  Returns
+    // how many ran.  For tests and owners that drive the reactor
+    // themselves; never concurrently with start().
+    size_t run_once(std::optional<Clock::time_point> until = std::nullopt);
+
+    Clock::time_point now() const { return backend_->now(); }
+    bool on_reactor_thread() const { return std::this_thread::get_id() == thread_id_.load(); }
+    ReactorStats stats() const;
+
+private:
+    enum class Kind { Handle, Timer, Signal };
+    struct Handler {
+        Kind kind = Kind::Signal;
+        ReactorHandle handle = nullptr;   // handles only
+        Task task;
+        ReactorPriority priority = ReactorPriority::Normal;
+        std::optional<Clock::time_point> due;   // timers only
+        Clock::duration period{};
+        bool queued = false;              // a dispatch is waiting in ready_
+    };
+    struct Ready {
+        ReactorId id = 0;                 // 0 for posted tasks
+        Task task;
+        ReactorPriority priority = ReactorPriority::Normal;
+        Clock::time_point since;
+        uint64_t seq = 0;
+    };
+
+    void enqueue(ReactorId id, Handler& h, Clock::time_point now);
+    void thread_func();
+
+    std::unique_ptr<IReactorBackend> backend_;
+    const ReactorConfig config_;
+
+    mutable std::mutex mutex_;
+    std::map<ReactorId, Handler> handlers_;
+    std::vector<Ready> ready_;
+    ReactorId next_id_ = 1;
+    uint64_t next_seq_ = 0;
+    ReactorStats stats_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<std::thread::id> thread_id_{};
+    std::thread thread_;
+};
+
+} // namespace hdrfixer::fixes
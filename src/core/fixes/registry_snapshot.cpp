@@ -0,0 +1,114 @@
+#include "registry_snapshot.h"
+#include <algorithm>
+
+namespace hdrfixer::fixes {
+
+namespace {
+
+// 64-bit FNV-1a over the value type, then its data
+uint64_t value_hash(const RegistryValue& v) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto mix = [&h](uint8_t byte) {
+        h ^= byte;
+        h *= 0x100000001b3ULL;
+    };
+    for (int shift = 0; shift < 32; shift += 8) mix(static_cast<uint8_t>(v.type >> shift));
+    for (uint8_t byte : v.data) mix(byte);
+    return h;
+}
+
+std::map<std::wstring, uint64_t> hash_values(const std::vector<RegistryValue>& values) {
+    std::map<std::wstring, uint64_t> out;
+    for (const auto& v : values) out[v.name] = value_hash(v);
+    return out;
+}
+
+std::wstring child_path(const std::wstring& parent, const std::wstring& name) {
+    return parent.empty() ? name : parent + L"\\" + name;
+}
+
+} // namespace
+
+std::vector<std::wstring> RegistryDiff::changed_keys() const {
+    std::vector<std::wstring> keys = added_keys;
+    keys.insert(keys.end(), removed_keys.begin(), removed_keys.end());
+    for (const auto& v : values) keys.push_back(v.key);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+void RegistrySnapshot::walk(IRegistryTree& tree, std::map<std::wstring, KeyState>& out, RegistryDiff* diff) {
+    std::vector<std::wstring> pending{L""};
+    while (!pending.empty()) {
+        std::wstring path = std::move(pending.back());
+        pending.pop_back();
+
+        // A key deleted mid-walk is simply absent from the new state
+        auto info = tree.query(path);
+        if (!info) continue;
+        ++stats_.keys_walked;
+        for (const auto& name : info->subkeys) pending.push_back(child_path(path, name));
+
+        KeyState state;
+        state.last_write = info->last_write;
+        auto old = diff ? keys_.find(path) : keys_.end();
+        if (old != keys_.end() && old->second.last_write == info->last_write) {
+            // Untouched since the last walk: keep the hashes, skip the read
+            state.values = std::move(old->second.values);
+            out.emplace(std::move(path), std::move(state));
+            continue;
+        }
+
+        ++stats_.keys_reread;
+        state.values = hash_values(tree.values(path));
+        if (diff && old == keys_.end()) {
+            diff->added_keys.push_back(path);
+        } else if (diff) {
+            const auto& before = old->second.values;
+            for (const auto& [name, hash] : state.values) {
+                auto it = before.find(name);
+                if (it == before.end()) {
+                    diff->values.push_back({path, name, ValueChange::Added});
+                } else if (it->second != hash) {
+                    diff->values.push_back({path, name, ValueChange::Modified});
+                }
+            }
+            for (const auto& [name, hash] : before) {
+                if (!state.values.contains(name)) {
+                    diff->values.push_back({path, name, ValueChange::Removed});
+                }
+            }
+        }
+        out.emplace(std::move(path), std::move(state));
+    }
+}
+
+bool RegistrySnapshot::capture(IRegistryTree& tree) {
+    std::map<std::wstring, KeyState> fresh;
+    walk(tree, fresh, nullptr);
+    keys_ = std::move(fresh);
+    captured_ = !keys_.empty();
+    return captured_;
+}
+
+RegistryDiff RegistrySnapshot::refresh(IRegistryTree& tree) {
+    ++stats_.refreshes;
+    RegistryDiff diff;
+    std::map<std::wstring, KeyState> fresh;
+    walk(tree, fresh, &diff);
+
+    // Old keys the walk no longer reached were deleted
+    for (const auto& [path, state] : keys_) {
+        if (!fresh.contains(path)) diff.removed_keys.push_back(path);
+    }
+    std::sort(diff.added_keys.begin(), diff.added_keys.end());
+    std::sort(diff.removed_keys.begin(), diff.removed_keys.end());
+
+    keys_ = std::move(fresh);
+    captured_ = !keys_.empty();
+    if (diff.empty()) ++stats_.noop_refreshes;
+    return diff;
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace hdrfixer::fixes {
+
+struct RegistryValue {
+    std::wstring name;
+    uint32_t type = 0;            // REG_DWORD, REG_SZ, ...
+    std::vector<uint8_t> data;
+};
+
+// Read access to one registry subtree.  Paths are relative to the subtree
+// root ("" is the root itself) with backslash separators.
+class IRegistryTree {
+public:
+    struct KeyInfo {
+        uint64_t last_write = 0;            // bumped by any write to the key's own values
+        std::vector<std::wstring> subkeys;  // direct children only
+    };
+
+    virtual ~IRegistryTree() = default;
+
+    // nullopt if the key no longer exists
+    virtual std::optional<KeyInfo> query(const std::wstring& path) = 0;
+    virtual std::vector<RegistryValue> values(const std::wstring& path) = 0;
+};
+
+enum class ValueChange { Added, Removed, Modified };
+
+struct RegistryValueDiff {
+    std::wstring key;
+    std::wstring value;
+    ValueChange change = ValueChange::Modified;
+
+    bool operator==(const RegistryValueDiff&) const = default;
+};
+
+struct RegistryDiff {
+    std::vector<std::wstring> added_keys;
+    std::vector<std::wstring> removed_keys;
+    std::vector<RegistryValueDiff> values;
+
+    bool empty() const { return added_keys.empty() && removed_keys.empty() && values.empty(); }
+    // Every key with an added, removed or changed value, or itself added
+    // or removed; sorted and unique
+    std::vector<std::wstring> changed_keys() const;
+};
+
+// Hash of every value (name, type, data) under a registry subtree, so a
+// change notification can be turned into a precise diff, and rewrites
+// with identical data into no diff at all.
+//
+// refresh() still walks every key, but reads values only where the key's
+// last-write stamp moved; with a typical notification that is one or two
+// keys of the subtree.
+class RegistrySnapshot {
+public:
+    struct Stats {
+        uint64_t refreshes = 0;
+        uint64_t noop_refreshes = 0;   // refreshes that found no change
+        uint64_t keys_walked = 0;
+        uint64_t keys_reread = 0;      // keys whose values were read again
+    };
+
+    // Replaces any previous state; false if the root does not exist
+    bool capture(IRegistryTree& tree);
+    // Diff since the last capture()/refresh(), which it then replaces
+    RegistryDiff refresh(IRegistryTree& tree);
+
+    bool captured() const { return captured_; }
+    size_t key_count() const { return keys_.size(); }
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct KeyState {
+        uint64_t last_write = 0;
+        std::map<std::wstring, uint64_t> values;   // name -> hash of type and data
+    };
+
+    void walk(IRegistryTree& tree, std::map<std::wstring, KeyState>& out, RegistryDiff* diff);
+
+    std::map<std::wstring, KeyState> keys_;
+    bool captured_ = false;
+    Stats stats_;
+};
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,114 @@
+#include "watch_loop.h"
+#include <algorithm>
+
+namespace hdrfixer::fixes {
+
+WatchLoop::WatchLoop(size_t keys, DebounceConfig debounce, AdaptivePollConfig poll) : poll_(poll) {
+    for (size_t i = 0; i < keys; ++i) {
+        debouncers_.push_back(std::make_unique<Debouncer>(debounce));
+    }
+}
+
+void WatchLoop::report_check(bool drift) {
+    poll_.record_check(drift);
+    wake();
+}
+
+bool WatchLoop::set_paused(bool paused) {
+    if (poll_.paused() == paused) return false;
+    poll_.set_paused(paused);
+    if (!paused) resume_check_.store(true, std::memory_order_release);
+    wake();
+    return true;
+}
+
+DebounceStats WatchLoop::debounce_stats() const {
+    DebounceStats total;
+    for (const auto& d : debouncers_) {
+        auto s = d->stats();
+        total.events += s.events;
+        total.fired += s.fired;
+        total.suppressed += s.suppressed;
+    }
+    return total;
+}
+
+void WatchLoop::attach(Reactor& reactor, Callback on_fire) {
+    reactor_ = &reactor;
+    on_fire_ = std::move(on_fire);
+    last_check_ = reactor.now();
+    wake_id_.store(reactor.add_signal([this] { on_deadline(); }, ReactorPriority::High),
+                   std::memory_order_release);
+    reschedule();
+}
+
+void WatchLoop::detach() {
+    if (!reactor_) return;
+    reactor_->remove(wake_id_.exchange(0, std::memory_order_acq_rel));
+    reactor_->remove(timer_id_);
+    timer_id_ = 0;
+    on_fire_ = {};
+}
+
+void WatchLoop::wake() {
+    // A stale id after detach() is harmless: the reactor ignores it
+    if (ReactorId id = wake_id_.load(std::memory_order_acquire)) reactor_->signal(id);
+}
+
+void WatchLoop::fire(WatchdogTrigger trigger, size_t key, Clock::time_point now) {
+    last_check_ = now;
+    if (on_fire_) on_fire_(trigger, key);
+}
+
+void WatchLoop::notify(size_t key) {
+    if (key >= debouncers_.size() || !reactor_) return;
+    // The debouncer decides whether this fires now or joins the key's
+    // current burst
+    auto now = reactor_->now();
+    if (debouncers_[key]->on_event(now)) fire(WatchdogTrigger::RegistryChange, key, now);
+    reschedule();
+}
+
+void WatchLoop::on_deadline() {
+    auto now = reactor_->now();
+    if (resume_check_.exchange(false, std::memory_order_acq_rel)) {
+        fire(WatchdogTrigger::Timeout, 0, now);
+    }
+    for (size_t key = 0; key < debouncers_.size(); ++key) {
+        auto due = debouncers_[key]->deadline();
+        if (due && now >= *due && debouncers_[key]->poll(now)) {
+            fire(WatchdogTrigger::RegistryChange, key, now);
+        }
+    }
+    auto due = poll_.next_poll(last_check_);
+    if (due && now >= *due) fire(WatchdogTrigger::Timeout, 0, now);
+    reschedule();
+}
+
+std::optional<WatchLoop::Clock::time_point> WatchLoop::next_deadline() const {
+    // Sleep until the fallback poll, or earlier if a coalesced fire is due;
+    // with polling paused and no burst pending, until an event
+    std::optional<Clock::time_point> wake = poll_.next_poll(last_check_);
+    if (resume_check_.load(std::memory_order_acquire)) wake = last_check_;
+    for (const auto& d : debouncers_) {
+        if (auto due = d->deadline()) {
+            wake = wake ? std::min(*wake, *due) : *due;
+        }
+    }
+    return wake;
+}
+
+void WatchLoop::reschedule() {
+    // Detached from within the callback
+    if (wake_id_.load(std::memory_order_acquire) == 0) return;
+    reactor_->remove(timer_id_);
+    timer_id_ = 0;
+    if (auto due = next_deadline()) {
+        timer_id_ = reactor_->add_timer(std::max(*due - reactor_->now(), Clock::duration::zero()), [this] {
+            timer_id_ = 0;
+            on_deadline();
+        });
+    }
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,75 @@
+#pragma once
+#include "adaptive_poll.h"
+#include "debouncer.h"
+#include "reactor.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace hdrfixer::fixes {
+
+// Why the watchdog fired.
+enum class WatchdogTrigger {
+    RegistryChange,   // something under one watched key changed
+    Timeout           // periodic fallback; anything may have changed
+};
+
+// The watchdog's scheduling, independent of where notifications come from:
+// per-key debouncing, the adaptive fallback poll, and the immediate re-check
+// after a pause.  It runs on a Reactor: one timer tracks the earliest
+// deadline, and a High signal re-plans it when report_check() or
+// set_paused() change the schedule.  Whoever owns a key's OS notification
+// feeds it in with notify().  attach(), detach(), notify() and the
+// callback run on the reactor thread; report_check(), set_paused() and the
+// stats are safe from any thread.
+class WatchLoop {
+public:
+    // Arguments: the trigger and, for RegistryChange, the key that fired
+    // (0 for Timeout)
+    using Callback = std::function<void(WatchdogTrigger, size_t key)>;
+    using Clock = Reactor::Clock;
+
+    WatchLoop(size_t keys, DebounceConfig debounce = {}, AdaptivePollConfig poll = {});
+
+    // Start the fallback schedule at reactor.now() and keep it on
+    // `reactor` until detach(); `reactor` must outlive the loop
+    void attach(Reactor& reactor, Callback on_fire);
+    void detach();
+    // `key`'s notification arrived
+    void notify(size_t key);
+
+    void report_check(bool drift);
+    // True if the state changed; resuming fires a Timeout right away
+    bool set_paused(bool paused);
+
+    const AdaptivePoll& poll() const { return poll_; }
+    size_t key_count() const { return debouncers_.size(); }
+    DebounceStats debounce_stats(size_t key) const { return debouncers_[key]->stats(); }
+    // Summed over all keys
+    DebounceStats debounce_stats() const;
+
+private:
+    void fire(WatchdogTrigger trigger, size_t key, Clock::time_point now);
+    void on_deadline();
+    // nullopt while paused with no burst pending
+    std::optional<Clock::time_point> next_deadline() const;
+    void reschedule();
+    void wake();
+
+    // One per key; Debouncer holds atomics, so it is not movable
+    std::vector<std::unique_ptr<Debouncer>> debouncers_;
+    AdaptivePoll poll_;
+    std::atomic<bool> resume_check_{false};
+
+    // Set by attach(), before wake_id_ publishes it to other threads
+    Reactor* reactor_ = nullptr;
+    std::atomic<ReactorId> wake_id_{0};
+    // Reactor thread only
+    Callback on_fire_;
+    ReactorId timer_id_ = 0;
+    Clock::time_point last_check_{};
+};
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,81 @@
+#include "worker_pool.h"
+
+namespace hdrfixer::fixes {
+
+WorkerPool::WorkerPool(size_t threads) {
+    if (threads == 0) threads = 1;
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this] { run(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : threads_) {
+        t.join();
+    }
+}
+
+void WorkerPool::grow(size_t threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (threads_.size() < threads) {
+        threads_.emplace_back([this] { run(); });
+    }
+}
+
+size_t WorkerPool::thread_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return threads_.size();
+}
+
+void WorkerPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cancelled_) return;   // `task` is destroyed outside the lock
+        queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+size_t WorkerPool::cancel() {
+    std::deque<std::function<void()>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        dropped.swap(queue_);
+    }
+    return dropped.size();
+}
+
+bool WorkerPool::wait_idle(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return idle_cv_.wait_for(lock, timeout, [this] { return running_ == 0; });
+}
+
+void WorkerPool::run() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            task = std::move(queue_.front());
+            queue_.pop_front();
+            ++running_;
+        }
+        task();
+        task = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --running_;
+        }
+        idle_cv_.notify_all();
+    }
+}
+
+} // namespace hdrfixer::fixes
@@ -0,0 +1,51 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+namespace hdrfixer::fixes {
+
+// Pool of threads draining a FIFO task queue; it only ever grows.  The
+// destructor finishes queued tasks (unless cancel() dropped them) and
+// joins, so a task that never returns blocks shutdown -- callers that time
+// out on a task still own its cleanup.  Such a task also keeps its worker
+// until it returns, so a pool sized to its callers' concurrency runs short
+// while one is stuck.
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void submit(std::function<void()> task);
+    // Start workers until there are at least `threads`
+    void grow(size_t threads);
+    size_t thread_count() const;
+
+    // Drop the queued tasks, and every task submitted from now on, without
+    // running them; running tasks finish.  Returns how many were dropped.
+    size_t cancel();
+    // Wait until no task is running; false on timeout
+    bool wait_idle(std::chrono::milliseconds timeout);
+
+private:
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_cv_;
+    std::deque<std::function<void()>> queue_;
+    size_t running_ = 0;
+    bool stopping_ = false;
+    bool cancelled_ = false;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace hdrfixer::fixes
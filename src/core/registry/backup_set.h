@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace hdrfixer::registry {
+
+// One value as it was before HDRFixer changed it.  `value_kind` holds the
+// REG_* type of registry values.
+struct BackupEntry {
+    std::wstring key_path;
+    std::wstring value_name;
+    uint32_t value_kind = 0;
+    std::wstring original_value;
+};
+
+struct BackupSet {
+    std::string name;
+    std::chrono::system_clock::time_point created_at;
+    std::vector<BackupEntry> entries;
+};
+
+} // namespace hdrfixer::registry
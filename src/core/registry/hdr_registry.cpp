@@ -169,6 +169,43 @@ std::expected<std::wstring, std::string> read_string(HKEY root, const wchar_t* s
     return data;
 }
 
+std::expected<std::vector<uint8_t>, std::string> read_binary(HKEY root, const wchar_t* subkey,
+                                                            const wchar_t* value_name) {
+    HKEY hkey = nullptr;
+    LSTATUS status = RegOpenKeyExW(root, subkey, 0, KEY_READ, &hkey);
+    if (status != ERROR_SUCCESS) {
+        return std::unexpected(
+            std::format("Failed to open registry key: {}", format_win_error(status)));
+    }
+
+    // First query to get the required buffer size
+    DWORD size = 0;
+    DWORD type = 0;
+    status = RegQueryValueExW(hkey, value_name, nullptr, &type, nullptr, &size);
+    if (status != ERROR_SUCCESS) {
+        RegCloseKey(hkey);
+        return std::unexpected(
+            std::format("Failed to query registry value size: {}", format_win_error(status)));
+    }
+
+    if (type != REG_BINARY) {
+        RegCloseKey(hkey);
+        return std::unexpected("Registry value is not a binary type");
+    }
+
+    std::vector<uint8_t> data(size);
+    status = RegQueryValueExW(hkey, value_name, nullptr, &type, data.data(), &size);
+    RegCloseKey(hkey);
+
+    if (status != ERROR_SUCCESS) {
+        return std::unexpected(
+            std::format("Failed to read registry binary value: {}", format_win_error(status)));
+    }
+
+    data.resize(size);
+    return data;
+}
+
 // ---------------------------------------------------------------------------
 // HDR state accessors
 // ---------------------------------------------------------------------------
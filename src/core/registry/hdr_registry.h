@@ -2,6 +2,8 @@
 #include <string>
 #include <map>
 #include <optional>
+#include <vector>
+#include <cstdint>
 #include <expected>
 #include <windows.h>
 
@@ -37,4 +39,7 @@ std::expected<void, std::string> write_dword(HKEY root, const wchar_t* subkey, c
 // Read a string value from registry
 std::expected<std::wstring, std::string> read_string(HKEY root, const wchar_t* subkey, const wchar_t* value_name);
 
+// Read a REG_BINARY value from registry
+std::expected<std::vector<uint8_t>, std::string> read_binary(HKEY root, const wchar_t* subkey, const wchar_t* value_name);
+
 } // namespace hdrfixer::registry
@@ -1,4 +1,5 @@
 #pragma once
+#include "core/registry/backup_set.h"
 #include <string>
 #include <vector>
 #include <filesystem>
@@ -8,19 +9,6 @@
 
 namespace hdrfixer::registry {
 
-struct BackupEntry {
-    std::wstring key_path;
-    std::wstring value_name;
-    DWORD value_kind = 0;
-    std::wstring original_value;
-};
-
-struct BackupSet {
-    std::string name;
-    std::chrono::system_clock::time_point created_at;
-    std::vector<BackupEntry> entries;
-};
-
 class RegistryBackupManager {
 public:
     RegistryBackupManager();
@@ -0,0 +1,43 @@
+// Compiles the panel quirks text source into the binary database that
+// HDRFixer memory-maps at startup.
+//
+//   hdrfixer_quirkc <input.txt> <output.bin>
+
+#include "core/display/panel_quirks.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: hdrfixer_quirkc <input.txt> <output.bin>\n";
+        return 2;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "hdrfixer_quirkc: cannot open " << argv[1] << "\n";
+        return 1;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+
+    auto compiled = hdrfixer::display::compile_quirks(ss.str());
+    if (!compiled) {
+        std::cerr << argv[1] << ": " << compiled.error() << "\n";
+        return 1;
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(compiled->data()),
+              static_cast<std::streamsize>(compiled->size()));
+    if (!out.good()) {
+        std::cerr << "hdrfixer_quirkc: failed to write " << argv[2] << "\n";
+        return 1;
+    }
+
+    size_t count = (compiled->size() - hdrfixer::display::kQuirksHeaderSize) /
+                   hdrfixer::display::kQuirksRecordSize;
+    std::cout << "hdrfixer_quirkc: " << count << " panel quirk(s) -> " << argv[2] << "\n";
+    return 0;
+}
@@ -0,0 +1,216 @@
+// EDID parsing throughput over a corpus of raw dumps.
+//
+//   hdrfixer_edid_bench [corpus-dir] [--seconds N]
+//
+// Every regular file in corpus-dir is treated as one EDID dump (e.g. copied
+// from /sys/class/drm/*/edid or the registry EDID value).  Without a
+// directory a small built-in corpus is used: base-only, CTA-861 with HDR
+// metadata, and CTA-861 + DisplayID multi-extension layouts.
+//
+// Reports parses per second and heap allocations per parse, which is the
+// cost paid on every hotplug event.
+
+#include "core/display/edid_reader.h"
+#include "core/display/edid_validator.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+
+} // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+using hdrfixer::display::parse_edid;
+using hdrfixer::display::validate_edid;
+
+void fix_checksum(uint8_t* block) {
+    uint8_t sum = 0;
+    for (int i = 0; i < 127; ++i) sum = static_cast<uint8_t>(sum + block[i]);
+    block[127] = static_cast<uint8_t>(0x100 - sum);
+}
+
+std::vector<uint8_t> make_base(uint8_t extensions) {
+    std::vector<uint8_t> edid(128 * (1 + extensions), 0);
+    const uint8_t header[8] = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+    std::copy(header, header + 8, edid.begin());
+    edid[8] = 0x10; edid[9] = 0xAC;
+    edid[10] = 0x21; edid[11] = 0x43;
+    edid[18] = 1; edid[19] = 4;
+    edid[20] = 0xB5;
+    const uint8_t chroma[10] = {0xEE, 0x91, 0xA3, 0x54, 0x4C, 0x99, 0x26, 0x0F, 0x50, 0x54};
+    std::copy(chroma, chroma + 10, edid.begin() + 25);
+    const uint8_t name[] = {0, 0, 0, 0xFC, 0, 'D', 'E', 'L', 'L', ' ', 'U', '2', '7', '2', '3', '\n', ' ', ' '};
+    std::copy(std::begin(name), std::end(name), edid.begin() + 72);
+    edid[126] = extensions;
+    fix_checksum(edid.data());
+    return edid;
+}
+
+void add_cta(std::vector<uint8_t>& edid, size_t index) {
+    uint8_t* ext = edid.data() + 128 * index;
+    const uint8_t blocks[] = {
+        0xE6, 0x06, 0x0D, 0x01, 0x78, 0x5C, 0x10,        // HDR static metadata
+        0xE3, 0x05, 0xC0, 0x00,                          // colorimetry
+        0x67, 0x03, 0x0C, 0x00, 0x10, 0x00, 0x38, 0x3C,  // HDMI VSDB
+        0xEB, 0x01, 0x46, 0xD0, 0x00, 0x48, 0x03, 0x76, 0x82, 0x5E, 0x6D, 0x95,  // Dolby Vision
+    };
+    ext[0] = 0x02; ext[1] = 0x03;
+    ext[2] = static_cast<uint8_t>(4 + sizeof(blocks));
+    std::copy(std::begin(blocks), std::end(blocks), ext + 4);
+    fix_checksum(ext);
+}
+
+void add_displayid(std::vector<uint8_t>& edid, size_t index) {
+    uint8_t* ext = edid.data() + 128 * index;
+    ext[0] = 0x70;
+    uint8_t* section = ext + 1;
+    const uint8_t params[] = {
+        0x21, 0x00, 29,
+        0x58, 0x02, 0x52, 0x01, 0x00, 0x0F, 0x70, 0x08,  // size, pixels
+        0x00,                                            // features
+        0xA4, 0x52, 0x54, 0x99, 0xE6, 0x99, 0x26, 0x60, 0x0F, 0x01, 0x45, 0x54,  // primaries
+        0xD0, 0x63, 0x00, 0x5A, 0x00, 0x04,              // luminance (half floats)
+        0x02, 0x78,                                      // 10 bpc, gamma 2.2
+    };
+    section[0] = 0x20;
+    section[1] = static_cast<uint8_t>(sizeof(params));
+    section[2] = 0x00;
+    section[3] = 0x00;
+    std::copy(std::begin(params), std::end(params), section + 4);
+    uint8_t sum = 0;
+    for (size_t i = 0; i < 4 + sizeof(params); ++i) sum = static_cast<uint8_t>(sum + section[i]);
+    section[4 + sizeof(params)] = static_cast<uint8_t>(0x100 - sum);
+    fix_checksum(ext);
+}
+
+std::vector<std::vector<uint8_t>> builtin_corpus() {
+    std::vector<std::vector<uint8_t>> corpus;
+    corpus.push_back(make_base(0));
+
+    auto cta = make_base(1);
+    add_cta(cta, 1);
+    corpus.push_back(std::move(cta));
+
+    auto multi = make_base(3);
+    add_cta(multi, 1);
+    add_displayid(multi, 2);
+    add_cta(multi, 3);
+    corpus.push_back(std::move(multi));
+    return corpus;
+}
+
+std::vector<std::vector<uint8_t>> load_corpus(const std::filesystem::path& dir) {
+    std::vector<std::vector<uint8_t>> corpus;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (!entry.is_regular_file()) continue;
+        std::ifstream in(entry.path(), std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)),
+                                   std::istreambuf_iterator<char>());
+        if (!bytes.empty()) corpus.push_back(std::move(bytes));
+    }
+    if (ec) {
+        std::fprintf(stderr, "hdrfixer_edid_bench: cannot read %s: %s\n",
+                     dir.string().c_str(), ec.message().c_str());
+    }
+    return corpus;
+}
+
+struct Result {
+    size_t parses = 0;
+    size_t allocations = 0;
+    double seconds = 0.0;
+};
+
+template <typename Fn>
+Result run(const std::vector<std::vector<uint8_t>>& corpus, double budget_seconds, Fn&& fn) {
+    using clock = std::chrono::steady_clock;
+    Result r;
+    size_t alloc_start = g_allocations.load(std::memory_order_relaxed);
+    auto start = clock::now();
+    auto deadline = start + std::chrono::duration<double>(budget_seconds);
+    while (clock::now() < deadline) {
+        // Check the clock once per 64 corpus passes: a pass over a small
+        // corpus takes little longer than reading the clock
+        for (int rep = 0; rep < 64; ++rep) {
+            for (const auto& edid : corpus) {
+                fn(edid);
+                ++r.parses;
+            }
+        }
+    }
+    r.seconds = std::chrono::duration<double>(clock::now() - start).count();
+    r.allocations = g_allocations.load(std::memory_order_relaxed) - alloc_start;
+    return r;
+}
+
+void report(const char* label, const Result& r) {
+    std::printf("%-16s %12.0f parses/s  %8.1f ns/parse  %6.2f allocs/parse\n",
+                label,
+                static_cast<double>(r.parses) / r.seconds,
+                r.seconds * 1e9 / static_cast<double>(r.parses),
+                static_cast<double>(r.allocations) / static_cast<double>(r.parses));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::filesystem::path dir;
+    double seconds = 1.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else {
+            dir = arg;
+        }
+    }
+
+    auto corpus = dir.empty() ? builtin_corpus() : load_corpus(dir);
+    if (corpus.empty()) {
+        std::fprintf(stderr, "hdrfixer_edid_bench: no EDID dumps found\n");
+        return 1;
+    }
+
+    size_t bytes = 0, parsed = 0, extensions = 0;
+    for (const auto& edid : corpus) {
+        bytes += edid.size();
+        if (auto info = parse_edid(edid)) {
+            ++parsed;
+            extensions += info->extension_count;
+        }
+    }
+    std::printf("corpus: %zu dump(s), %zu bytes, %zu parse ok, %zu extension block(s)\n",
+                corpus.size(), bytes, parsed, extensions);
+
+    volatile size_t sink = 0;
+    report("parse_edid", run(corpus, seconds, [&](const std::vector<uint8_t>& edid) {
+        auto info = parse_edid(edid);
+        sink = sink + (info ? info->extension_count : 0);
+    }));
+    report("validate_edid", run(corpus, seconds, [&](const std::vector<uint8_t>& edid) {
+        auto r = validate_edid(edid);
+        sink = sink + r.issues.size();
+    }));
+    return 0;
+}
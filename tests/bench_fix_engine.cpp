@@ -0,0 +1,231 @@
+// FixEngine scalability over thousands of synthetic fixes.
+//
+//   hdrfixer_engine_bench [--fixes N] [--owners N] [--chain N]
+//                         [--latency-us N] [--fail-rate P] [--threads N]
+//                         [--rounds N] [--seed N]
+//
+// Fixes are spread over `owners` (simulated displays) in dependency chains
+// of `chain` fixes each: every fix but the first in a chain depends on its
+// predecessor, so --chain 1 means fully independent fixes.  Each diagnose,
+// apply and revert sleeps for --latency-us (0 means no work at all, which
+// isolates engine cost) and each apply fails with probability --fail-rate.
+//
+// Reports registration, lookup, diagnose_all and apply_all cost, serial and
+// on a WorkerPool.  "overhead" is wall time beyond the ideal
+// fixes * latency / parallelism, per fix: the price of the scheduler and
+// the engine's bookkeeping.
+
+#include "core/fixes/fix_engine.h"
+#include "core/fixes/worker_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace hdrfixer::fixes;
+using clock_type = std::chrono::steady_clock;
+
+struct Config {
+    size_t fixes = 2000;
+    size_t owners = 4;
+    size_t chain = 1;
+    unsigned latency_us = 0;
+    double fail_rate = 0.0;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t rounds = 5;
+    unsigned seed = 1;
+};
+
+class SyntheticFix : public IFix {
+public:
+    SyntheticFix(size_t index, const Config& config, std::vector<FixId> deps)
+        : name_("Synthetic" + std::to_string(index)),
+          latency_(config.latency_us),
+          fail_(config.fail_rate),
+          rng_(config.seed + static_cast<unsigned>(index)),
+          deps_(std::move(deps)) {}
+
+    std::string name() const override { return name_; }
+    std::string description() const override { return "Benchmark fix"; }
+    FixCategory category() const override { return FixCategory::ToneCurve; }
+    std::vector<FixId> dependencies() const override { return deps_; }
+
+    FixStatus diagnose() override {
+        work();
+        if (failed_) return {FixState::Error, "synthetic failure"};
+        return {applied_ ? FixState::Applied : FixState::NotApplied, ""};
+    }
+    FixResult apply() override {
+        work();
+        // The engine never runs one fix on two threads at once
+        failed_ = fail_(rng_);
+        applied_ = !failed_;
+        return {applied_, failed_ ? "synthetic failure" : ""};
+    }
+    FixResult revert() override {
+        work();
+        applied_ = false;
+        failed_ = false;
+        return {true, ""};
+    }
+
+private:
+    void work() const {
+        if (latency_.count() > 0) std::this_thread::sleep_for(latency_);
+    }
+
+    std::string name_;
+    std::chrono::microseconds latency_;
+    std::bernoulli_distribution fail_;
+    std::mt19937 rng_;
+    std::vector<FixId> deps_;
+    bool applied_ = false;
+    bool failed_ = false;
+};
+
+struct Registered {
+    FixEngine engine;
+    std::vector<std::pair<FixId, uint64_t>> keys;   // (id, owner) per fix
+};
+
+uint64_t owner_of(size_t index, const Config& config) {
+    return 1 + (index / config.chain) % config.owners;
+}
+
+void populate(Registered& r, const Config& config) {
+    for (size_t i = 0; i < config.fixes; ++i) {
+        std::vector<FixId> deps;
+        if (i % config.chain != 0) deps.push_back(fix_id("Synthetic" + std::to_string(i - 1)));
+        auto fix = std::make_unique<SyntheticFix>(i, config, std::move(deps));
+        FixId id = fix_id(fix->name());
+        uint64_t owner = owner_of(i, config);
+        if (auto ok = r.engine.register_fix(std::move(fix), owner); !ok) {
+            std::fprintf(stderr, "hdrfixer_engine_bench: %s\n", ok.error().c_str());
+            std::exit(1);
+        }
+        r.keys.emplace_back(id, owner);
+    }
+}
+
+double seconds_since(clock_type::time_point start) {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// Best of `rounds`: `setup` runs untimed before each timed `fn`
+template <typename Setup, typename Fn>
+double best_of(size_t rounds, Setup&& setup, Fn&& fn) {
+    double best = 0.0;
+    for (size_t round = 0; round < rounds; ++round) {
+        setup();
+        auto start = clock_type::now();
+        fn();
+        double s = seconds_since(start);
+        if (round == 0 || s < best) best = s;
+    }
+    return best;
+}
+
+void report(const char* label, double seconds, const Config& config, size_t parallelism) {
+    double per_fix_us = seconds * 1e6 / static_cast<double>(config.fixes);
+    double ideal_s = static_cast<double>(config.fixes) * config.latency_us * 1e-6 /
+                     static_cast<double>(parallelism);
+    double overhead_us = std::max(0.0, seconds - ideal_s) * 1e6 / static_cast<double>(config.fixes);
+    std::printf("%-18s %10.2f ms  %10.2f us/fix  %10.2f us/fix overhead  %12.0f fixes/s\n",
+                label, seconds * 1e3, per_fix_us, overhead_us,
+                static_cast<double>(config.fixes) / seconds);
+}
+
+bool parse_args(int argc, char** argv, Config& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (arg == "--fixes") config.fixes = std::strtoull(value, nullptr, 10);
+        else if (arg == "--owners") config.owners = std::strtoull(value, nullptr, 10);
+        else if (arg == "--chain") config.chain = std::strtoull(value, nullptr, 10);
+        else if (arg == "--latency-us") config.latency_us = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--fail-rate") config.fail_rate = std::atof(value);
+        else if (arg == "--threads") config.threads = std::strtoull(value, nullptr, 10);
+        else if (arg == "--rounds") config.rounds = std::strtoull(value, nullptr, 10);
+        else if (arg == "--seed") config.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else return false;
+    }
+    return config.fixes > 0 && config.owners > 0 && config.chain > 0 && config.threads > 0 &&
+           config.rounds > 0 && config.fail_rate >= 0.0 && config.fail_rate <= 1.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    if (!parse_args(argc, argv, config)) {
+        std::fprintf(stderr,
+            "usage: hdrfixer_engine_bench [--fixes N] [--owners N] [--chain N] [--latency-us N]\n"
+            "                             [--fail-rate P] [--threads N] [--rounds N] [--seed N]\n");
+        return 2;
+    }
+    std::printf("config: %zu fix(es), %zu owner(s), chains of %zu, %uus latency, "
+                "%.2f fail rate, %zu thread(s), best of %zu\n",
+                config.fixes, config.owners, config.chain, config.latency_us,
+                config.fail_rate, config.threads, config.rounds);
+
+    // Registration re-checks the dependency graph for cycles each time
+    std::unique_ptr<Registered> r;
+    double register_s = best_of(config.rounds, [&] { r = std::make_unique<Registered>(); },
+                                [&] { populate(*r, config); });
+    Config no_work = config;   // registration never calls into the fixes
+    no_work.latency_us = 0;
+    report("register_fix", register_s, no_work, 1);
+
+    volatile size_t sink = 0;
+    constexpr size_t kLookupPasses = 64;
+    double lookup_s = best_of(config.rounds, [] {}, [&] {
+        for (size_t pass = 0; pass < kLookupPasses; ++pass) {
+            for (const auto& [id, owner] : r->keys) {
+                sink = sink + (r->engine.get_fix(id, owner) != nullptr);
+            }
+        }
+    });
+    size_t lookups = kLookupPasses * r->keys.size();
+    std::printf("%-18s %10.2f ns/lookup  %12.0f lookups/s\n", "get_fix",
+                lookup_s * 1e9 / static_cast<double>(lookups),
+                static_cast<double>(lookups) / lookup_s);
+
+    FixEngine& engine = r->engine;
+    WorkerPool pool(config.threads);
+    // Chains serialize their members, so fewer than `threads` may be useful
+    size_t chains = (config.fixes + config.chain - 1) / config.chain;
+    size_t parallel = std::min(config.threads, chains);
+    const auto no_timeout = std::chrono::hours(1);
+
+    auto dirty = [&] { engine.mark_all_dirty(); };
+    report("diagnose serial", best_of(config.rounds, dirty, [&] { engine.diagnose_all(); }),
+           config, 1);
+    report("diagnose parallel",
+           best_of(config.rounds, dirty, [&] { engine.diagnose_all(pool, no_timeout); }),
+           config, std::min(config.threads, config.fixes));
+
+    // Each apply round starts from everything reverted; apply_all also
+    // diagnoses every fix first, so it costs two calls per fix
+    auto reverted = [&] { engine.mark_all_dirty(); engine.revert_all(); engine.mark_all_dirty(); };
+    Config apply_config = config;
+    apply_config.latency_us *= 2;
+    report("apply serial", best_of(config.rounds, reverted, [&] { engine.apply_all(); }),
+           apply_config, 1);
+    report("apply parallel", best_of(config.rounds, reverted, [&] { engine.apply_all(pool); }),
+           apply_config, parallel);
+
+    size_t failures = 0;
+    for (const auto& s : engine.stats()) {
+        failures += s.ops[static_cast<size_t>(FixOp::Apply)].failure;
+    }
+    std::printf("apply failures: %zu\n", failures);
+    return 0;
+}
@@ -0,0 +1,238 @@
+// Watchdog trigger latency, coalescing and CPU cost under synthetic storms.
+//
+//   hdrfixer_watchdog_bench [--keys N] [--storms N] [--events N]
+//                           [--storm-ms N] [--gap-ms N] [--window-ms N]
+//                           [--max-latency-ms N] [--rounds N] [--seed N]
+//                           [--trace FILE] [--save-trace FILE]
+//
+// Each storm hits one random key with --events notifications spread at
+// random over --storm-ms, storms starting --gap-ms apart, like a driver
+// install rewriting a subtree.  --trace replays a recorded trace instead
+// (see core/fixes/event_source.h for the format); --save-trace writes the
+// generated one.
+//
+// The trace runs through the real WatchLoop attached to a Reactor, as in
+// the watchdog, with one reactor handle per key signaled at each event.
+// The reactor's PortableReactorBackend runs on a virtual clock, so
+// latencies are exact virtual-clock times, independent of the machine:
+// for each event, the time until the next RegistryChange fire for its key.
+// CPU cost is the reactor's and loop's own processing, the only part that
+// is real time.
+
+#include "core/fixes/event_source.h"
+#include "core/fixes/watch_loop.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace hdrfixer::fixes;
+using namespace std::chrono_literals;
+
+struct Config {
+    size_t keys = 5;
+    size_t storms = 200;
+    size_t events = 500;
+    unsigned storm_ms = 3000;
+    unsigned gap_ms = 10000;
+    unsigned window_ms = 250;
+    unsigned max_latency_ms = 2000;
+    size_t rounds = 5;
+    unsigned seed = 1;
+    std::string trace;
+    std::string save_trace;
+};
+
+std::vector<TraceEvent> synthesize(const Config& config) {
+    std::mt19937 rng(config.seed);
+    std::uniform_int_distribution<size_t> key(0, config.keys - 1);
+    std::uniform_int_distribution<int64_t> offset(0, int64_t{config.storm_ms} * 1000);
+    std::vector<TraceEvent> trace;
+    for (size_t s = 0; s < config.storms; ++s) {
+        auto start = std::chrono::microseconds(int64_t{config.gap_ms} * 1000 * static_cast<int64_t>(s));
+        size_t k = key(rng);
+        for (size_t e = 0; e < config.events; ++e) {
+            trace.push_back({start + std::chrono::microseconds(offset(rng)), k});
+        }
+    }
+    std::stable_sort(trace.begin(), trace.end(),
+                     [](const TraceEvent& a, const TraceEvent& b) { return a.at < b.at; });
+    return trace;
+}
+
+struct Run {
+    std::vector<std::vector<std::chrono::microseconds>> fires;   // per key
+    size_t timeouts = 0;
+    size_t delivered = 0;
+    size_t coalesced = 0;
+    size_t wakes = 0;
+    DebounceStats debounce;
+    double cpu_s = 0.0;
+    double wall_s = 0.0;
+};
+
+Run replay(const std::vector<TraceEvent>& trace, const Config& config) {
+    DebounceConfig debounce;
+    debounce.window = std::chrono::milliseconds(config.window_ms);
+    debounce.max_latency = std::chrono::milliseconds(config.max_latency_ms);
+    WatchLoop loop(config.keys, debounce);
+    auto owned = std::make_unique<PortableReactorBackend>(true);
+    auto* backend = owned.get();
+    Reactor reactor(std::move(owned));
+    auto until = Reactor::Clock::time_point{} + (trace.empty() ? 0us : trace.back().at) +
+                 2 * debounce.max_latency;
+
+    Run run;
+    run.fires.resize(config.keys);
+    // Like registry notification events: signals before the handler runs
+    // coalesce
+    std::vector<char> events(config.keys);
+    for (size_t k = 0; k < config.keys; ++k) {
+        (void)reactor.add_handle(&events[k], [&, k] {
+            ++run.delivered;
+            loop.notify(k);
+        });
+    }
+    loop.attach(reactor, [&](WatchdogTrigger trigger, size_t key) {
+        if (trigger == WatchdogTrigger::Timeout) {
+            ++run.timeouts;
+            loop.report_check(false);
+        } else {
+            run.fires[key].push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                reactor.now().time_since_epoch()));
+        }
+    });
+    auto advance = [&](Reactor::Clock::time_point t) {
+        while (reactor.now() < t) reactor.run_once(t);
+        while (reactor.run_once(t) > 0) {}
+    };
+
+    std::clock_t cpu_start = std::clock();
+    auto wall_start = std::chrono::steady_clock::now();
+    for (const auto& e : trace) {
+        advance(Reactor::Clock::time_point{} + e.at);
+        backend->signal(&events[e.key]);
+    }
+    advance(until);
+    run.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    run.cpu_s = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    loop.detach();
+
+    run.coalesced = trace.size() - run.delivered;
+    run.wakes = static_cast<size_t>(reactor.stats().turns);
+    run.debounce = loop.debounce_stats();
+    return run;
+}
+
+double percentile(std::vector<double>& v, double p) {
+    if (v.empty()) return 0.0;
+    size_t i = static_cast<size_t>(p * static_cast<double>(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(i), v.end());
+    return v[i];
+}
+
+bool parse_args(int argc, char** argv, Config& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (arg == "--keys") config.keys = std::strtoull(value, nullptr, 10);
+        else if (arg == "--storms") config.storms = std::strtoull(value, nullptr, 10);
+        else if (arg == "--events") config.events = std::strtoull(value, nullptr, 10);
+        else if (arg == "--storm-ms") config.storm_ms = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--gap-ms") config.gap_ms = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--window-ms") config.window_ms = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--max-latency-ms") config.max_latency_ms = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--rounds") config.rounds = std::strtoull(value, nullptr, 10);
+        else if (arg == "--seed") config.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--trace") config.trace = value;
+        else if (arg == "--save-trace") config.save_trace = value;
+        else return false;
+    }
+    return config.keys > 0 && config.rounds > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    if (!parse_args(argc, argv, config)) {
+        std::fprintf(stderr,
+            "usage: hdrfixer_watchdog_bench [--keys N] [--storms N] [--events N] [--storm-ms N]\n"
+            "                               [--gap-ms N] [--window-ms N] [--max-latency-ms N]\n"
+            "                               [--rounds N] [--seed N] [--trace FILE] [--save-trace FILE]\n");
+        return 2;
+    }
+
+    std::vector<TraceEvent> trace;
+    if (!config.trace.empty()) {
+        std::ifstream in(config.trace, std::ios::binary);
+        std::stringstream text;
+        text << in.rdbuf();
+        auto parsed = parse_event_trace(text.str());
+        if (!parsed) {
+            std::fprintf(stderr, "hdrfixer_watchdog_bench: %s\n", parsed.error().c_str());
+            return 1;
+        }
+        trace = std::move(*parsed);
+        for (const auto& e : trace) config.keys = std::max(config.keys, e.key + 1);
+        std::printf("config: %zu event(s) from %s, %zu key(s)", trace.size(), config.trace.c_str(), config.keys);
+    } else {
+        trace = synthesize(config);
+        std::printf("config: %zu storm(s) of %zu event(s) over %ums every %ums, %zu key(s)",
+                    config.storms, config.events, config.storm_ms, config.gap_ms, config.keys);
+    }
+    std::printf(", %ums window, %ums max latency, best of %zu\n",
+                config.window_ms, config.max_latency_ms, config.rounds);
+    if (!config.save_trace.empty()) {
+        std::ofstream(config.save_trace, std::ios::binary) << serialize_event_trace(trace);
+    }
+
+    // Virtual time makes every round identical except for the CPU cost
+    Run run;
+    double best_cpu = 0.0, best_wall = 0.0;
+    for (size_t round = 0; round < config.rounds; ++round) {
+        run = replay(trace, config);
+        if (round == 0 || run.cpu_s < best_cpu) best_cpu = run.cpu_s;
+        if (round == 0 || run.wall_s < best_wall) best_wall = run.wall_s;
+    }
+
+    std::vector<double> latency_ms;
+    size_t unserved = 0;
+    for (const auto& e : trace) {
+        if (e.key >= run.fires.size()) continue;
+        const auto& fires = run.fires[e.key];
+        auto it = std::lower_bound(fires.begin(), fires.end(), e.at);
+        if (it == fires.end()) {
+            ++unserved;
+        } else {
+            latency_ms.push_back(std::chrono::duration<double, std::milli>(*it - e.at).count());
+        }
+    }
+    size_t fired = 0;
+    for (const auto& f : run.fires) fired += f.size();
+
+    std::printf("events             %10zu raw, %zu delivered, %zu coalesced by the reactor\n",
+                trace.size(), run.delivered, run.coalesced);
+    std::printf("triggers           %10zu registry (%.1f events/trigger), %zu fallback polls\n",
+                fired, fired ? static_cast<double>(trace.size()) / static_cast<double>(fired) : 0.0,
+                run.timeouts);
+    std::printf("latency            %10.2f ms p50  %10.2f ms p99  %10.2f ms max  %zu unserved\n",
+                percentile(latency_ms, 0.5), percentile(latency_ms, 0.99),
+                latency_ms.empty() ? 0.0 : *std::max_element(latency_ms.begin(), latency_ms.end()),
+                unserved);
+    double events = static_cast<double>(std::max<size_t>(trace.size(), 1));
+    std::printf("cpu                %10.2f ms total  %10.2f ns/event  %10.2f ns/wake  (%.2f ms wall)\n",
+                best_cpu * 1e3, best_cpu * 1e9 / events,
+                best_cpu * 1e9 / static_cast<double>(std::max<size_t>(run.wakes, 1)), best_wall * 1e3);
+    return 0;
+}
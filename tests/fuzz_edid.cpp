@@ -0,0 +1,37 @@
+// libFuzzer entry point for the EDID / CTA-861 / DisplayID parsers.
+// Built only with -DHDRFIXER_BUILD_FUZZERS=ON under clang, with ASan and
+// UBSan, e.g.:
+//
+//   hdrfixer_fuzz_edid -max_len=1024 -timeout=1 corpus-dir
+//
+// Any crash, sanitizer report or timeout here is a hotplug-time crash or
+// hang in the tray app.
+
+#include "core/display/edid_reader.h"
+#include "core/display/edid_validator.h"
+#include "core/display/displayid_reader.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    using namespace hdrfixer::display;
+    std::span<const uint8_t> bytes(data, size);
+
+    if (auto info = parse_edid(bytes)) {
+        (void)panel_luminance(*info);
+    }
+
+    auto report = validate_edid(bytes);
+    (void)report.summary();
+
+    // Exercise the DisplayID parser on any 128-byte window directly, since
+    // parse_edid only reaches it behind valid EDID block checksums
+    if (size >= kEdidBlockSize) {
+        DisplayIdInfo displayid{};
+        (void)parse_displayid_extension(bytes.first(kEdidBlockSize), displayid);
+    }
+    DisplayIdInfo section{};
+    (void)parse_displayid_section(bytes, section);
+    return 0;
+}
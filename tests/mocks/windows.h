@@ -90,6 +90,7 @@ struct LUID {
 #define KEY_NOTIFY 0x0010
 #define REG_SZ 1
 #define REG_EXPAND_SZ 2
+#define REG_BINARY 3
 #define REG_DWORD 4
 #define REG_OPTION_NON_VOLATILE 0
 
@@ -101,6 +102,12 @@ inline LSTATUS RegCreateKeyExW(HKEY, const wchar_t*, DWORD, void*, DWORD, DWORD,
 inline LSTATUS RegSetValueExW(HKEY, const wchar_t*, DWORD, DWORD, const BYTE*, DWORD) { return ERROR_FILE_NOT_FOUND; }
 inline LSTATUS RegNotifyChangeKeyValue(HKEY, BOOL, DWORD, HANDLE, BOOL) { return ERROR_SUCCESS; }
 #define REG_NOTIFY_CHANGE_LAST_SET 0x00000004
+#define ERROR_MORE_DATA 234L
+#define ERROR_NO_MORE_ITEMS 259L
+struct FILETIME { DWORD dwLowDateTime; DWORD dwHighDateTime; };
+inline LSTATUS RegQueryInfoKeyW(HKEY, wchar_t*, DWORD*, DWORD*, DWORD*, DWORD*, DWORD*, DWORD*, DWORD*, DWORD*, DWORD*, FILETIME*) { return ERROR_FILE_NOT_FOUND; }
+inline LSTATUS RegEnumKeyExW(HKEY, DWORD, wchar_t*, DWORD*, DWORD*, wchar_t*, DWORD*, FILETIME*) { return ERROR_NO_MORE_ITEMS; }
+inline LSTATUS RegEnumValueW(HKEY, DWORD, wchar_t*, DWORD*, DWORD*, DWORD*, BYTE*, DWORD*) { return ERROR_NO_MORE_ITEMS; }
 #define REG_NOTIFY_CHANGE_NAME 0x00000001
 
 // WideChar/MultiByte conversion stubs
@@ -169,11 +176,20 @@ inline HANDLE CreateMutexW(void*, BOOL, const wchar_t*) { return (HANDLE)1; }
 inline DWORD GetLastError() { return 0; }
 inline BOOL CloseHandle(HANDLE) { return TRUE; }
 inline HANDLE CreateEventW(void*, BOOL, BOOL, const wchar_t*) { return (HANDLE)1; }
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+#define FILE_NOTIFY_CHANGE_FILE_NAME  0x00000001
+#define FILE_NOTIFY_CHANGE_LAST_WRITE 0x00000010
+inline HANDLE FindFirstChangeNotificationW(const wchar_t*, BOOL, DWORD) { return (HANDLE)1; }
+inline BOOL FindNextChangeNotification(HANDLE) { return TRUE; }
+inline BOOL FindCloseChangeNotification(HANDLE) { return TRUE; }
 inline BOOL SetEvent(HANDLE) { return TRUE; }
 inline BOOL ResetEvent(HANDLE) { return TRUE; }
 inline DWORD WaitForMultipleObjects(DWORD, const HANDLE*, BOOL, DWORD) { return 0; }
 #define WAIT_OBJECT_0 0
 #define WAIT_TIMEOUT 0x00000102L
+#define MAXIMUM_WAIT_OBJECTS 64
+#define INFINITE 0xFFFFFFFF
+inline DWORD WaitForSingleObject(HANDLE, DWORD) { return WAIT_TIMEOUT; }
 
 // COM stubs
 #define COINIT_APARTMENTTHREADED 0x2
@@ -191,10 +207,13 @@ inline void CoTaskMemFree(void*) {}
 #define WM_CONTEXTMENU 0x007B
 #define WM_DEVICECHANGE 0x0219
 #define WM_DISPLAYCHANGE 0x007E
+#define WM_POWERBROADCAST 0x0218
+#define WM_WTSSESSION_CHANGE 0x02B1
 
 // Window functions stubs
 #define GWLP_USERDATA (-21)
 #define WS_POPUP 0x80000000L
+#define WS_EX_TOOLWINDOW 0x00000080L
 #define HWND_MESSAGE ((HWND)-3)
 #define IDI_APPLICATION ((const wchar_t*)32512)
 #define MF_STRING 0x00000000
@@ -313,6 +332,17 @@ struct DEV_BROADCAST_DEVICEINTERFACE {
 inline HDEVNOTIFY RegisterDeviceNotificationW(HWND, void*, DWORD) { return (HDEVNOTIFY)1; }
 inline BOOL UnregisterDeviceNotification(HDEVNOTIFY) { return TRUE; }
 
+// Power setting notifications
+#define PBT_POWERSETTINGCHANGE 0x8013
+typedef void* HPOWERNOTIFY;
+struct POWERBROADCAST_SETTING {
+    GUID PowerSetting;
+    DWORD DataLength;
+    BYTE Data[1];
+};
+inline HPOWERNOTIFY RegisterPowerSettingNotification(HANDLE, const GUID*, DWORD) { return (HPOWERNOTIFY)1; }
+inline BOOL UnregisterPowerSettingNotification(HPOWERNOTIFY) { return TRUE; }
+
 // OutputDebugString
 inline void OutputDebugStringA(const char*) {}
 
@@ -342,6 +372,10 @@ typedef int WCS_PROFILE_MANAGEMENT_SCOPE;
 inline BOOL InstallColorProfileW(void*, const wchar_t*) { return FALSE; }
 inline BOOL UninstallColorProfileW(void*, const wchar_t*, BOOL) { return FALSE; }
 inline HMODULE GetModuleHandleW(const wchar_t*) { return nullptr; }
+inline DWORD GetModuleFileNameW(HMODULE, wchar_t* buf, DWORD size) {
+    if (buf && size > 0) buf[0] = L'\0';
+    return 0;
+}
 inline HMODULE LoadLibraryW(const wchar_t*) { return nullptr; }
 inline void* GetProcAddress(HMODULE, const char*) { return nullptr; }
 
@@ -357,6 +391,11 @@ typedef ULONG_PTR DWORD_PTR;
 // DisplayConfig stubs
 #define QDC_ONLY_ACTIVE_PATHS 2
 #define DISPLAYCONFIG_DEVICE_INFO_GET_SDR_WHITE_LEVEL 0xFFFFFFFF
+#define DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME 1
+#define DISPLAYCONFIG_DEVICE_INFO_GET_TARGET_NAME 2
+#define DISPLAYCONFIG_DEVICE_INFO_GET_ADVANCED_COLOR_INFO 9
+#define DISPLAYCONFIG_MODE_INFO_TYPE_SOURCE 1
+#define DISPLAYCONFIG_PATH_MODE_IDX_INVALID 0xffffffff
 
 struct DISPLAYCONFIG_DEVICE_INFO_HEADER {
     DWORD type;
@@ -370,14 +409,56 @@ struct DISPLAYCONFIG_SDR_WHITE_LEVEL {
     DWORD SDRWhiteLevel;
 };
 
+struct DISPLAYCONFIG_GET_ADVANCED_COLOR_INFO {
+    DISPLAYCONFIG_DEVICE_INFO_HEADER header;
+    union {
+        struct {
+            UINT32 advancedColorSupported : 1;
+            UINT32 advancedColorEnabled : 1;
+            UINT32 wideColorEnforced : 1;
+            UINT32 advancedColorForceDisabled : 1;
+            UINT32 reserved : 28;
+        };
+        UINT32 value;
+    };
+    DWORD colorEncoding;
+    UINT32 bitsPerColorChannel;
+};
+
+#define CCHDEVICENAME 32
+
+struct DISPLAYCONFIG_SOURCE_DEVICE_NAME {
+    DISPLAYCONFIG_DEVICE_INFO_HEADER header;
+    wchar_t viewGdiDeviceName[CCHDEVICENAME];
+};
+
+struct DISPLAYCONFIG_TARGET_DEVICE_NAME {
+    DISPLAYCONFIG_DEVICE_INFO_HEADER header;
+    DWORD flags;
+    DWORD outputTechnology;
+    WORD edidManufactureId;
+    WORD edidProductCodeId;
+    UINT32 connectorInstance;
+    wchar_t monitorFriendlyDeviceName[64];
+    wchar_t monitorDevicePath[128];
+};
+
+struct DISPLAYCONFIG_RATIONAL {
+    UINT32 Numerator;
+    UINT32 Denominator;
+};
+
 struct DISPLAYCONFIG_TARGET_INFO {
     LUID adapterId;
     DWORD id;
+    UINT32 modeInfoIdx;
+    DISPLAYCONFIG_RATIONAL refreshRate;
 };
 
 struct DISPLAYCONFIG_SOURCE_INFO {
     LUID adapterId;
     DWORD id;
+    UINT32 modeInfoIdx;
 };
 
 struct DISPLAYCONFIG_PATH_INFO {
@@ -385,7 +466,17 @@ struct DISPLAYCONFIG_PATH_INFO {
     DISPLAYCONFIG_TARGET_INFO targetInfo;
 };
 
-struct DISPLAYCONFIG_MODE_INFO {};
+struct DISPLAYCONFIG_SOURCE_MODE {
+    UINT32 width;
+    UINT32 height;
+};
+
+struct DISPLAYCONFIG_MODE_INFO {
+    DWORD infoType;
+    UINT32 id;
+    LUID adapterId;
+    DISPLAYCONFIG_SOURCE_MODE sourceMode;
+};
 
 inline LONG GetDisplayConfigBufferSizes(DWORD, UINT32*, UINT32*) { return ERROR_FILE_NOT_FOUND; }
 inline LONG QueryDisplayConfig(DWORD, UINT32*, DISPLAYCONFIG_PATH_INFO*, UINT32*, DISPLAYCONFIG_MODE_INFO*, void*) { return ERROR_FILE_NOT_FOUND; }
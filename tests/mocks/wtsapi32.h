@@ -0,0 +1,9 @@
+#pragma once
+#include "windows.h"
+
+#define WTS_SESSION_LOCK 0x7
+#define WTS_SESSION_UNLOCK 0x8
+#define NOTIFY_FOR_THIS_SESSION 0
+
+inline BOOL WTSRegisterSessionNotification(HWND, DWORD) { return TRUE; }
+inline BOOL WTSUnRegisterSessionNotification(HWND) { return TRUE; }
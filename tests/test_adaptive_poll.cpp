@@ -0,0 +1,47 @@
+#include "doctest.h"
+#include "core/fixes/adaptive_poll.h"
+
+using namespace hdrfixer::fixes;
+using namespace std::chrono_literals;
+
+TEST_CASE("AdaptivePoll backs off while checks find no drift") {
+    AdaptivePoll poll({60s, 10min, 2});
+    CHECK(poll.interval() == 60s);
+
+    poll.record_check(false);
+    CHECK(poll.interval() == 120s);
+    poll.record_check(false);
+    poll.record_check(false);
+    CHECK(poll.interval() == 480s);
+    poll.record_check(false);
+    CHECK(poll.interval() == 10min);   // capped, not 960 s
+    poll.record_check(false);
+    CHECK(poll.interval() == 10min);
+
+    poll.record_check(true);
+    CHECK(poll.interval() == 60s);
+}
+
+TEST_CASE("AdaptivePoll schedules nothing while paused") {
+    AdaptivePoll poll({30s, 1h, 3});
+    const AdaptivePoll::Clock::time_point t0{};
+    CHECK(poll.next_poll(t0) == t0 + 30s);
+
+    poll.set_paused(true);
+    CHECK(poll.paused());
+    CHECK(!poll.next_poll(t0));
+    // Results still count while paused
+    poll.record_check(false);
+
+    poll.set_paused(false);
+    CHECK(poll.next_poll(t0) == t0 + 90s);
+}
+
+TEST_CASE("AdaptivePoll sanitizes its configuration") {
+    AdaptivePoll poll({0ms, 0ms, 0});
+    CHECK(poll.config().min_interval == 1ms);
+    CHECK(poll.config().max_interval == 1ms);
+    CHECK(poll.config().backoff_factor == 1);
+    poll.record_check(false);
+    CHECK(poll.interval() == 1ms);
+}
@@ -0,0 +1,305 @@
+#include "doctest.h"
+#include "core/fixes/apply_journal.h"
+#include "core/fixes/fix_engine.h"
+#include "core/fixes/fix_executor.h"
+#include "core/fixes/worker_pool.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+
+using namespace hdrfixer::fixes;
+using hdrfixer::registry::BackupSet;
+
+namespace {
+
+struct TempJournal {
+    std::filesystem::path path;
+
+    TempJournal() {
+        static int counter = 0;
+        path = std::filesystem::temp_directory_path() /
+               ("hdrfixer_journal_test_" + std::to_string(++counter) + ".journal");
+        std::filesystem::remove(path);
+    }
+    ~TempJournal() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+// Records apply/restore order in a shared log and captures one registry
+// value as its pre-state.
+struct JournaledFix : public IFix {
+    JournaledFix(std::string n, std::vector<std::string>& log, bool fails = false)
+        : n(std::move(n)), log(log), fails(fails) {}
+    std::string name() const override { return n; }
+    std::string description() const override { return "Journal test fix"; }
+    FixCategory category() const override { return FixCategory::ToneCurve; }
+    FixStatus diagnose() override { return {applied ? FixState::Applied : FixState::NotApplied, ""}; }
+    FixResult apply() override {
+        log.push_back(n);
+        if (fails) return {false, "device busy"};
+        applied = true;
+        return {true, ""};
+    }
+    FixResult revert() override { applied = false; return {true, ""}; }
+    BackupSet capture_state() const override {
+        BackupSet set;
+        set.entries.push_back({L"HKCU\\Software\\HDRFixer", L"Value", 4, L"before-" +
+                               std::wstring(n.begin(), n.end())});
+        return set;
+    }
+    FixResult restore_state(const BackupSet& state) override {
+        REQUIRE(state.entries.size() == 1);
+        log.push_back("restore " + n);
+        restored_from = state.entries[0].original_value;
+        applied = false;
+        return {true, ""};
+    }
+
+    std::string n;
+    std::vector<std::string>& log;
+    bool fails;
+    bool applied = false;
+    std::wstring restored_from;
+};
+
+// Detect-and-warn fix: always finds a problem it cannot fix
+struct WarningFix : public IFix {
+    explicit WarningFix(std::vector<std::string>& log) : log(log) {}
+    std::string name() const override { return "Warn"; }
+    std::string description() const override { return "Warning test fix"; }
+    FixCategory category() const override { return FixCategory::EdidValidation; }
+    FixStatus diagnose() override { return {FixState::Warning, "EDID is invalid"}; }
+    FixResult apply() override {
+        log.push_back("Warn");
+        return {false, "cannot be fixed in software"};
+    }
+    FixResult revert() override { return {false, "nothing to revert"}; }
+
+    std::vector<std::string>& log;
+};
+
+JournalStep make_step(uint64_t id, uint64_t owner, std::wstring value) {
+    JournalStep step;
+    step.fix = FixId{id};
+    step.owner = owner;
+    step.pre_state.name = "Step";
+    step.pre_state.entries.push_back({L"HKLM\\SYSTEM\\Key|With|Pipes", L"", 1, std::move(value)});
+    return step;
+}
+
+} // namespace
+
+TEST_CASE("ApplyJournal round-trips pre-state and started steps") {
+    TempJournal tmp;
+    ApplyJournal journal(tmp.path);
+    CHECK(journal.load().value().empty());
+
+    REQUIRE(journal.begin({make_step(0xFFFFFFFFFFFFFFFFULL, 7, L"aé中"),
+                           make_step(2, 0, L"")}));
+    REQUIRE(journal.mark_started(0));
+
+    auto steps = journal.load();
+    REQUIRE(steps.has_value());
+    REQUIRE(steps->size() == 2);
+    CHECK((*steps)[0].fix == FixId{0xFFFFFFFFFFFFFFFFULL});
+    CHECK((*steps)[0].owner == 7);
+    CHECK((*steps)[0].started);
+    CHECK((*steps)[0].pre_state.name == "Step");
+    REQUIRE((*steps)[0].pre_state.entries.size() == 1);
+    CHECK((*steps)[0].pre_state.entries[0].key_path == L"HKLM\\SYSTEM\\Key|With|Pipes");
+    CHECK((*steps)[0].pre_state.entries[0].value_kind == 1);
+    CHECK((*steps)[0].pre_state.entries[0].original_value == L"aé中");
+    CHECK(!(*steps)[1].started);
+
+    REQUIRE(journal.commit());
+    CHECK(!std::filesystem::exists(tmp.path));
+    CHECK(journal.load().value().empty());
+}
+
+TEST_CASE("ApplyJournal ignores a torn trailing record") {
+    TempJournal tmp;
+    ApplyJournal journal(tmp.path);
+    REQUIRE(journal.begin({make_step(1, 0, L"x"), make_step(2, 0, L"y")}));
+    REQUIRE(journal.mark_started(0));
+    {
+        // Start record for step 300 cut off after its first varint byte
+        std::ofstream out(tmp.path, std::ios::binary | std::ios::app);
+        out << 'S' << static_cast<char>(0xAC);
+    }
+    auto steps = journal.load();
+    REQUIRE(steps.has_value());
+    REQUIRE(steps->size() == 2);
+    CHECK((*steps)[0].started);
+    CHECK(!(*steps)[1].started);
+
+    // A begin record that never fully landed means nothing was started
+    auto size = std::filesystem::file_size(tmp.path);
+    std::filesystem::resize_file(tmp.path, size / 2);
+    CHECK(journal.load().value().empty());
+
+    std::filesystem::resize_file(tmp.path, 0);
+    {
+        std::ofstream out(tmp.path, std::ios::binary);
+        out << "garbage";
+    }
+    CHECK(!journal.load().has_value());
+}
+
+TEST_CASE("Transactional apply rolls back started fixes in reverse") {
+    TempJournal tmp;
+    ApplyJournal journal(tmp.path);
+    std::vector<std::string> log;
+    FixEngine engine;
+    auto first = std::make_unique<JournaledFix>("First", log);
+    auto second = std::make_unique<JournaledFix>("Second", log);
+    auto* first_ptr = first.get();
+    engine.register_fix(std::move(first));
+    engine.register_fix(std::move(second));
+    engine.register_fix(std::make_unique<JournaledFix>("Broken", log, true));
+    engine.register_fix(std::make_unique<JournaledFix>("Never", log));
+
+    auto result = engine.apply_all(journal);
+    REQUIRE(!result.has_value());
+    CHECK(result.error() == "Broken failed: device busy; rolled back 3 fix(es)");
+    CHECK(log == std::vector<std::string>{"First", "Second", "Broken",
+                                          "restore Broken", "restore Second", "restore First"});
+    CHECK(first_ptr->restored_from == L"before-First");
+    CHECK(!first_ptr->applied);
+    CHECK(!std::filesystem::exists(tmp.path));
+}
+
+TEST_CASE("Transactional apply rolls back after a non-standard exception") {
+    struct ThrowingFix : public JournaledFix {
+        using JournaledFix::JournaledFix;
+        FixResult apply() override {
+            log.push_back(n);
+            throw 42;
+        }
+    };
+    TempJournal tmp;
+    ApplyJournal journal(tmp.path);
+    std::vector<std::string> log;
+    FixEngine engine;
+    engine.register_fix(std::make_unique<JournaledFix>("First", log));
+    engine.register_fix(std::make_unique<ThrowingFix>("Thrower", log));
+
+    auto result = engine.apply_all(journal);
+    REQUIRE(!result.has_value());
+    CHECK(result.error() == "Thrower failed: unknown exception; rolled back 2 fix(es)");
+    CHECK(log == std::vector<std::string>{"First", "Thrower", "restore Thrower", "restore First"});
+    CHECK(!std::filesystem::exists(tmp.path));
+}
+
+TEST_CASE("Transactional apply commits and skips fixes already applied") {
+    TempJournal tmp;
+    ApplyJournal journal(tmp.path);
+    std::vector<std::string> log;
+    FixEngine engine;
+    engine.register_fix(std::make_unique<JournaledFix>("A", log));
+    engine.register_fix(std::make_unique<JournaledFix>("B", log));
+
+    CHECK(engine.apply_all(journal).has_value());
+    CHECK(log == std::vector<std::string>{"A", "B"});
+    CHECK(!std::filesystem::exists(tmp.path));
+
+    log.clear();
+    CHECK(engine.apply_all(journal).has_value());
+    CHECK(log.empty());
+}
+
+TEST_CASE("Async transactional apply runs off the calling thread and rolls back") {
+    // The transaction posts exactly one completion back
+    std::promise<std::function<void()>> posted;
+    WorkerPool pool(1);
+    FixExecutor executor(pool, [&posted](std::function<void()> task) { posted.set_value(std::move(task)); });
+
+    TempJournal tmp;
+    ApplyJournal journal(tmp.path);
+    std::vector<std::string> log;
+    FixEngine engine;
+    engine.register_fix(std::make_unique<JournaledFix>("First", log));
+    engine.register_fix(std::make_unique<JournaledFix>("Broken", log, true));
+
+    std::optional<std::expected<void, std::string>> result;
+    engine.apply_all_async(executor, journal, [&](const std::expected<void, std::string>& r) { result = r; });
+
+    // While it is in flight a second transaction is refused
+    auto second = engine.apply_all(journal);
+    REQUIRE(!second.has_value());
+    CHECK(second.error() == "Apply aborted: another apply is in progress");
+
+    auto completion = posted.get_future();
+    REQUIRE(completion.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    CHECK(!result);
+    completion.get()();
+    REQUIRE(result);
+    REQUIRE(!result->has_value());
+    CHECK(result->error() == "Broken failed: device busy; rolled back 2 fix(es)");
+    CHECK(log == std::vector<std::string>{"First", "Broken", "restore Broken", "restore First"});
+    CHECK(!std::filesystem::exists(tmp.path));
+    CHECK(engine.dirty_count() == 2);
+}
+
+TEST_CASE("Transactional apply leaves warnings alone instead of rolling back") {
+    TempJournal tmp;
+    ApplyJournal journal(tmp.path);
+    std::vector<std::string> log;
+    FixEngine engine;
+    auto first = std::make_unique<JournaledFix>("First", log);
+    auto* first_ptr = first.get();
+    engine.register_fix(std::move(first));
+    engine.register_fix(std::make_unique<WarningFix>(log));
+    engine.register_fix(std::make_unique<JournaledFix>("Second", log));
+
+    CHECK(engine.apply_all(journal).has_value());
+    CHECK(log == std::vector<std::string>{"First", "Second"});
+    CHECK(first_ptr->applied);
+    CHECK(first_ptr->restored_from.empty());
+
+    auto stats = engine.stats();
+    auto warn = std::find_if(stats.begin(), stats.end(), [](const auto& s) { return s.name == "Warn"; });
+    REQUIRE(warn != stats.end());
+    CHECK(warn->ops[static_cast<size_t>(FixOp::Apply)].failure == 0);
+}
+
+TEST_CASE("FixEngine recovers an interrupted apply from the journal") {
+    TempJournal tmp;
+    std::vector<std::string> log;
+    {
+        // What a crash after the second fix started leaves on disk
+        ApplyJournal crashed(tmp.path);
+        JournaledFix a("A", log), b("B", log), c("C", log);
+        std::vector<JournalStep> steps(3);
+        const IFix* fixes[] = {&a, &b, &c};
+        for (size_t i = 0; i < 3; ++i) {
+            steps[i].fix = fix_id(fixes[i]->name());
+            steps[i].owner = 0x42;
+            steps[i].pre_state = fixes[i]->capture_state();
+        }
+        steps[1].owner = 0x99;   // its display is gone by the next start
+        REQUIRE(crashed.begin(steps));
+        REQUIRE(crashed.mark_started(0));
+        REQUIRE(crashed.mark_started(1));
+    }
+
+    FixEngine engine;
+    auto a = std::make_unique<JournaledFix>("A", log);
+    auto* a_ptr = a.get();
+    engine.register_fix(std::move(a), 0x42);
+    engine.register_fix(std::make_unique<JournaledFix>("B", log), 0x42);
+    engine.register_fix(std::make_unique<JournaledFix>("C", log), 0x42);
+
+    ApplyJournal journal(tmp.path);
+    auto restored = engine.recover(journal);
+    REQUIRE(restored.has_value());
+    CHECK(restored.value() == 1);
+    CHECK(log == std::vector<std::string>{"restore A"});
+    CHECK(a_ptr->restored_from == L"before-A");
+    CHECK(!std::filesystem::exists(tmp.path));
+
+    CHECK(engine.recover(journal).value() == 0);
+}
@@ -0,0 +1,78 @@
+#include "doctest.h"
+#include "core/fixes/debouncer.h"
+
+using namespace hdrfixer::fixes;
+using namespace std::chrono_literals;
+
+namespace {
+
+const Debouncer::Clock::time_point t0{};
+
+} // namespace
+
+TEST_CASE("Debouncer collapses a burst into a leading and a trailing fire") {
+    Debouncer d({250ms, 2000ms, true, true});
+    CHECK(!d.deadline());
+
+    CHECK(d.on_event(t0));
+    for (int i = 1; i <= 9; ++i) {
+        CHECK(!d.on_event(t0 + i * 10ms));
+    }
+    REQUIRE(d.deadline());
+    CHECK(*d.deadline() == t0 + 90ms + 250ms);
+    CHECK(!d.poll(t0 + 300ms));
+    CHECK(d.poll(t0 + 340ms));
+    CHECK(!d.deadline());
+    CHECK(!d.poll(t0 + 1s));
+
+    auto s = d.stats();
+    CHECK(s.events == 10);
+    CHECK(s.fired == 2);
+    CHECK(s.suppressed == 8);
+
+    // A lone event only fires once
+    CHECK(d.on_event(t0 + 5s));
+    CHECK(!d.poll(t0 + 5s + 250ms));
+    CHECK(!d.deadline());
+    CHECK(d.stats().fired == 3);
+}
+
+TEST_CASE("Debouncer trailing-only fires once the burst is quiet") {
+    Debouncer d({100ms, 2000ms, false, true});
+    CHECK(!d.on_event(t0));
+    CHECK(!d.on_event(t0 + 50ms));
+    CHECK(*d.deadline() == t0 + 150ms);
+    CHECK(d.poll(t0 + 150ms));
+    CHECK(d.stats().fired == 1);
+    CHECK(d.stats().suppressed == 1);
+}
+
+TEST_CASE("Debouncer caps latency during an endless burst") {
+    Debouncer d({100ms, 500ms, true, true});
+    CHECK(d.on_event(t0));
+    int fires = 1;
+    // An event every 50 ms never lets the window close
+    for (auto t = t0 + 50ms; t <= t0 + 2s; t += 50ms) {
+        if (d.deadline() && *d.deadline() <= t && d.poll(t)) ++fires;
+        CHECK(!d.on_event(t));
+    }
+    // Leading at 0, then one fire per 500 ms of pending events
+    CHECK(fires == 4);
+    CHECK(d.poll(t0 + 2s + 100ms));
+    CHECK(d.stats().fired == 5);
+    CHECK(d.stats().events == 41);
+}
+
+TEST_CASE("Debouncer leading-only drops the tail of a short burst") {
+    Debouncer d({100ms, 1000ms, true, false});
+    CHECK(d.on_event(t0));
+    CHECK(!d.on_event(t0 + 20ms));
+    CHECK(!d.poll(t0 + 120ms));
+    CHECK(!d.deadline());
+    CHECK(d.on_event(t0 + 200ms));   // new burst
+    CHECK(d.stats().suppressed == 1);
+
+    // Neither edge is treated as trailing-only
+    Debouncer none({100ms, 1000ms, false, false});
+    CHECK(none.config().trailing);
+}
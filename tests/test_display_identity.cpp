@@ -0,0 +1,110 @@
+#include "doctest.h"
+#include "core/display/display_identity.h"
+
+using namespace hdrfixer::display;
+
+namespace {
+
+DisplayInfo make_display(const wchar_t* path, uint8_t edid_tag) {
+    DisplayInfo info{};
+    info.monitor_device_path = path;
+    info.edid_data.assign(128, 0);
+    info.edid_data[10] = edid_tag;
+    return info;
+}
+
+} // namespace
+
+TEST_CASE("Display fingerprint depends on EDID and path") {
+    auto a = make_display(L"\\\\?\\DISPLAY#DEL40F5#5&1&0&UID1#{guid}", 1);
+    auto same = a;
+    same.max_luminance = 1000.0f;     // live state is not part of identity
+    auto other_port = make_display(L"\\\\?\\DISPLAY#DEL40F5#5&1&0&UID2#{guid}", 1);
+    auto other_panel = make_display(L"\\\\?\\DISPLAY#DEL40F5#5&1&0&UID1#{guid}", 2);
+
+    CHECK(display_fingerprint(a) == display_fingerprint(same));
+    CHECK(display_fingerprint(a) != display_fingerprint(other_port));
+    CHECK(display_fingerprint(a) != display_fingerprint(other_panel));
+}
+
+TEST_CASE("Display path key ignores the EDID") {
+    auto a = make_display(L"\\\\?\\DISPLAY#DEL40F5#5&1&0&UID1#{guid}", 1);
+    auto unread = a;
+    unread.edid_data.clear();
+    auto other_port = make_display(L"\\\\?\\DISPLAY#DEL40F5#5&1&0&UID2#{guid}", 1);
+    CHECK(display_path_key(a) == display_path_key(unread));
+    CHECK(display_path_key(a) != display_path_key(other_port));
+
+    // Without a device path the GDI name stands in
+    DisplayInfo gdi_only{};
+    gdi_only.device_name = L"\\\\.\\DISPLAY1";
+    auto gdi_other = gdi_only;
+    gdi_other.device_name = L"\\\\.\\DISPLAY2";
+    CHECK(display_path_key(gdi_only) != display_path_key(gdi_other));
+}
+
+TEST_CASE("DisplayIdentityCache reports added and removed displays") {
+    DisplayIdentityCache cache;
+    auto a = make_display(L"A", 1);
+    auto b = make_display(L"B", 2);
+    auto c = make_display(L"C", 3);
+    uint64_t fa = display_fingerprint(a), fb = display_fingerprint(b), fc = display_fingerprint(c);
+
+    auto changes = cache.update({a, b});
+    CHECK(changes.added == std::vector<uint64_t>{fa, fb});
+    CHECK(changes.removed.empty());
+    REQUIRE(cache.find(fa) != nullptr);
+    const DisplayInfo* a_ptr = cache.find(fa);
+
+    a.sdr_white_level_nits = 240.0f;
+    changes = cache.update({a, c});
+    CHECK(changes.added == std::vector<uint64_t>{fc});
+    CHECK(changes.removed == std::vector<uint64_t>{fb});
+    // Retained display is updated in place, so existing pointers stay valid
+    CHECK(cache.find(fa) == a_ptr);
+    CHECK(a_ptr->sdr_white_level_nits == 240.0f);
+    CHECK(cache.find(fb) == nullptr);
+    CHECK(cache.fingerprints() == std::vector<uint64_t>{fa, fc});
+
+    CHECK(cache.update({a, c}).empty());
+}
+
+TEST_CASE("DisplayIdentityCache diff and retain against a probe") {
+    DisplayIdentityCache cache;
+    auto a = make_display(L"A", 1);
+    auto b = make_display(L"B", 2);
+    uint64_t fa = display_fingerprint(a), fb = display_fingerprint(b);
+    cache.update({a, b});
+
+    // Probe order does not matter
+    CHECK(cache.diff({fb, fa}).empty());
+
+    auto changes = cache.diff({fa, 0x1234});
+    CHECK(changes.added == std::vector<uint64_t>{0x1234});
+    CHECK(changes.removed == std::vector<uint64_t>{fb});
+
+    const DisplayInfo* a_ptr = cache.find(fa);
+    CHECK(cache.retain({fa}) == std::vector<uint64_t>{fb});
+    CHECK(cache.size() == 1);
+    CHECK(cache.find(fa) == a_ptr);
+}
+
+TEST_CASE("DisplayIdentityCache keeps identical fingerprints distinct") {
+    // Two outputs that could not be told apart (no path, no EDID)
+    DisplayIdentityCache cache;
+    DisplayInfo x{}, y{};
+    auto changes = cache.update({x, y});
+    CHECK(changes.added.size() == 2);
+    CHECK(cache.size() == 2);
+
+    changes = cache.update({x});
+    CHECK(changes.added.empty());
+    CHECK(changes.removed.size() == 1);
+    CHECK(cache.size() == 1);
+}
+
+TEST_CASE("Probe fails cleanly without display config") {
+    // The Windows mocks report no display configuration
+    auto probe = probe_display_fingerprints();
+    CHECK(!probe.has_value());
+}
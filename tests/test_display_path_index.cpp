@@ -0,0 +1,52 @@
+#include "doctest.h"
+#include "core/display/display_config.h"
+
+using namespace hdrfixer::display;
+
+namespace {
+
+DisplayPath make_path(LUID adapter, uint32_t source, uint32_t target, const wchar_t* gdi) {
+    DisplayPath p{};
+    p.adapter_id = adapter;
+    p.source_adapter_id = adapter;
+    p.source_id = source;
+    p.target_id = target;
+    p.gdi_device_name = gdi;
+    return p;
+}
+
+} // namespace
+
+TEST_CASE("Display path index matches each output on a shared adapter") {
+    const LUID gpu{0x100, 0}, igpu{0x200, 0}, other{0x300, 0};
+    std::vector<DisplayPath> paths = {
+        make_path(gpu, 0, 10, L"\\\\.\\DISPLAY1"),
+        make_path(gpu, 1, 11, L"\\\\.\\DISPLAY2"),
+        make_path(gpu, 1, 12, L"\\\\.\\DISPLAY2"),     // clone of DISPLAY2
+        make_path(igpu, 0, 20, L""),                   // GDI name unavailable
+    };
+    DisplayPathIndex index(paths);
+
+    REQUIRE(index.find(gpu, L"\\\\.\\DISPLAY1") != nullptr);
+    CHECK(index.find(gpu, L"\\\\.\\DISPLAY1")->target_id == 10);
+    CHECK(index.find(gpu, L"\\\\.\\DISPLAY2")->target_id == 11);
+    CHECK(index.find(gpu, L"\\\\.\\DISPLAY3") == nullptr);
+    CHECK(index.find(other, L"\\\\.\\DISPLAY1") == nullptr);
+    // Unnamed path: only the sole path on its adapter can match
+    REQUIRE(index.find(igpu, L"\\\\.\\DISPLAY4") != nullptr);
+    CHECK(index.find(igpu, L"\\\\.\\DISPLAY4")->target_id == 20);
+}
+
+TEST_CASE("Display path index matches outputs by their source adapter") {
+    // Hybrid GPU: the iGPU owns the source, the dGPU drives the target
+    const LUID igpu{0x200, 0}, dgpu{0x100, 0};
+    auto path = make_path(dgpu, 0, 30, L"\\\\.\\DISPLAY1");
+    path.source_adapter_id = igpu;
+    std::vector<DisplayPath> paths = {path};
+    DisplayPathIndex index(paths);
+
+    const auto* found = index.find(igpu, L"\\\\.\\DISPLAY1");
+    REQUIRE(found != nullptr);
+    CHECK(luid_key(found->adapter_id) == luid_key(dgpu));
+    CHECK(index.find(dgpu, L"\\\\.\\DISPLAY1") == nullptr);
+}
@@ -0,0 +1,98 @@
+#include "doctest.h"
+#include "core/display/display_topology.h"
+#include "core/display/display_identity.h"
+
+using namespace hdrfixer::display;
+
+namespace {
+
+TopologyTarget make_target(uint64_t fingerprint, uint32_t target_id) {
+    TopologyTarget t;
+    t.fingerprint = fingerprint;
+    t.adapter_id = {1, 0};
+    t.source_id = target_id;
+    t.target_id = target_id;
+    t.width = 3840;
+    t.height = 2160;
+    t.refresh_mhz = 60000;
+    t.hdr_enabled = true;
+    t.bits_per_color = 10;
+    t.sdr_white_level_nits = 200.0f;
+    return t;
+}
+
+} // namespace
+
+TEST_CASE("Topology diff reports added, removed and changed targets") {
+    TopologySnapshot before({make_target(1, 0), make_target(2, 1), make_target(3, 2)});
+
+    auto hdr_off = make_target(1, 0);
+    hdr_off.hdr_enabled = false;
+    auto moved = make_target(3, 5);         // same monitor, other dock port
+    moved.refresh_mhz = 144000;
+    moved.sdr_white_level_nits = 240.0f;
+    TopologySnapshot after({moved, make_target(4, 3), hdr_off});
+
+    auto diff = before.diff(after);
+    CHECK(diff.added == std::vector<uint64_t>{4});
+    CHECK(diff.removed == std::vector<uint64_t>{2});
+    REQUIRE(diff.changed.size() == 2);
+    CHECK(diff.changed[0].fingerprint == 1);
+    CHECK(diff.changed[0].changes == kTargetHdrChanged);
+    CHECK(diff.changed[1].fingerprint == 3);
+    CHECK(diff.changed[1].changes ==
+          (kTargetPathChanged | kTargetModeChanged | kTargetWhiteLevelChanged));
+
+    // Order alone is not a change
+    TopologySnapshot reordered({make_target(3, 2), make_target(1, 0), make_target(2, 1)});
+    CHECK(before.diff(reordered).empty());
+    CHECK(TopologySnapshot{}.diff(before).added.size() == 3);
+}
+
+TEST_CASE("Topology diff pairs identical fingerprints in order") {
+    // Two outputs that could not be told apart (no path, no EDID)
+    auto second = make_target(7, 1);
+    TopologySnapshot before({make_target(7, 0), second});
+    second.sdr_white_level_nits = 80.0f;
+    TopologySnapshot after({make_target(7, 0), second, make_target(7, 2)});
+
+    auto diff = before.diff(after);
+    CHECK(diff.added == std::vector<uint64_t>{7});
+    CHECK(diff.removed.empty());
+    REQUIRE(diff.changed.size() == 1);
+    CHECK(diff.changed[0].changes == kTargetWhiteLevelChanged);
+    CHECK(after.find(7)->target_id == 0);
+    CHECK(after.fingerprints() == std::vector<uint64_t>{7, 7, 7});
+
+    auto back = after.diff(before);
+    CHECK(back.removed == std::vector<uint64_t>{7});
+    CHECK(back.added.empty());
+}
+
+TEST_CASE("DisplayIdentityCache takes live state from a topology target") {
+    DisplayInfo info{};
+    info.monitor_device_path = L"A";
+    info.bits_per_color = 8;
+    info.max_luminance = 1000.0f;
+    DisplayIdentityCache cache;
+    cache.update({info});
+    uint64_t fp = display_fingerprint(info);
+
+    auto target = make_target(fp, 4);
+    target.bits_per_color = 0;              // unknown: keep the detected depth
+    CHECK(cache.update_state(target));
+    const DisplayInfo* cached = cache.find(fp);
+    CHECK(cached->is_hdr_enabled);
+    CHECK(cached->target_id == 4);
+    CHECK(cached->sdr_white_level_nits == 200.0f);
+    CHECK(cached->bits_per_color == 8);
+    CHECK(cached->max_luminance == 1000.0f);
+
+    CHECK(!cache.update_state(make_target(fp + 1, 0)));
+}
+
+TEST_CASE("Topology probe fails cleanly without display config") {
+    // The Windows mocks report no display configuration
+    auto probe = probe_topology();
+    CHECK(!probe.has_value());
+}
@@ -0,0 +1,176 @@
+#include "doctest.h"
+#include "core/display/displayid_reader.h"
+#include "core/display/edid_reader.h"
+#include <vector>
+
+using namespace hdrfixer::display;
+
+namespace {
+
+uint8_t checksum_byte(const uint8_t* begin, const uint8_t* end) {
+    uint8_t sum = 0;
+    for (auto* p = begin; p != end; ++p) sum = static_cast<uint8_t>(sum + *p);
+    return static_cast<uint8_t>(0x100 - sum);
+}
+
+// Base block + one DisplayID 2.0 extension carrying the given data blocks.
+std::vector<uint8_t> make_displayid_edid(const std::vector<uint8_t>& data_blocks) {
+    std::vector<uint8_t> edid(256, 0);
+    edid[8] = 0x10; edid[9] = 0xAC;
+    edid[126] = 1;
+    edid[127] = checksum_byte(edid.data(), edid.data() + 127);
+
+    uint8_t* ext = edid.data() + 128;
+    ext[0] = 0x70;
+    ext[1] = 0x20;                                     // DisplayID 2.0
+    ext[2] = static_cast<uint8_t>(data_blocks.size());
+    ext[3] = 0x04;                                     // primary use: HDR desktop
+    ext[4] = 0;
+    std::copy(data_blocks.begin(), data_blocks.end(), ext + 5);
+    size_t section_end = 5 + data_blocks.size();
+    ext[section_end] = checksum_byte(ext + 1, ext + section_end);
+    ext[127] = checksum_byte(ext, ext + 127);
+    return edid;
+}
+
+void push_xy12(std::vector<uint8_t>& out, uint16_t x, uint16_t y) {
+    out.push_back(static_cast<uint8_t>(x & 0xFF));
+    out.push_back(static_cast<uint8_t>(((y & 0x0F) << 4) | ((x >> 8) & 0x0F)));
+    out.push_back(static_cast<uint8_t>(y >> 4));
+}
+
+void push_le16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v & 0xFF));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+std::vector<uint8_t> display_parameters_block() {
+    std::vector<uint8_t> b = {0x21, 0x00, 29};
+    push_le16(b, 6970); push_le16(b, 3920);   // 697.0 x 392.0 mm
+    push_le16(b, 3840); push_le16(b, 2160);
+    b.push_back(0x00);
+    push_xy12(b, 2785, 1310);                 // red   (0.680, 0.320)
+    push_xy12(b, 1081, 2834);                 // green (0.264, 0.692)
+    push_xy12(b, 614, 205);                   // blue  (0.150, 0.050)
+    push_xy12(b, 1281, 1348);                 // white (0.3127, 0.329)
+    push_le16(b, 0x5E40);                     // full coverage: 400 nits
+    push_le16(b, 0x63D0);                     // 10% coverage: 1000 nits
+    push_le16(b, 0x2C00);                     // min: 0.0625 nits
+    b.push_back(0x03);                        // 10 bpc
+    b.push_back(120);                         // gamma 2.2
+    return b;
+}
+
+} // namespace
+
+TEST_CASE("DisplayID half float decode") {
+    CHECK(half_to_float(0x3C00) == doctest::Approx(1.0f));
+    CHECK(half_to_float(0x5E40) == doctest::Approx(400.0f));
+    CHECK(half_to_float(0x63D0) == doctest::Approx(1000.0f));
+    CHECK(half_to_float(0x2C00) == doctest::Approx(0.0625f));
+    CHECK(half_to_float(0x0000) == 0.0f);
+    CHECK(half_to_float(0xC000) == doctest::Approx(-2.0f));
+}
+
+TEST_CASE("DisplayID 2.0 display parameters via parse_edid") {
+    auto edid = make_displayid_edid(display_parameters_block());
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    CHECK(info->checksums_valid);
+    REQUIRE(info->has_displayid);
+    CHECK(info->displayid.version == 0x20);
+    CHECK(info->displayid.checksum_valid);
+    REQUIRE(info->displayid.has_display_parameters);
+
+    const auto& p = info->displayid.params;
+    CHECK(p.h_pixels == 3840);
+    CHECK(p.v_pixels == 2160);
+    CHECK(p.red.x == doctest::Approx(0.680).epsilon(0.001));
+    CHECK(p.green.y == doctest::Approx(0.692).epsilon(0.001));
+    CHECK(p.white.x == doctest::Approx(0.3127).epsilon(0.001));
+    CHECK(p.max_luminance == doctest::Approx(1000.0f));
+    CHECK(p.max_full_frame_luminance == doctest::Approx(400.0f));
+    CHECK(p.min_luminance == doctest::Approx(0.0625f));
+    CHECK(p.bits_per_color == 10);
+    CHECK(p.native_gamma == doctest::Approx(2.2f));
+
+    auto lum = panel_luminance(*info);
+    REQUIRE(lum.has_value());
+    CHECK(lum->max_luminance == doctest::Approx(1000.0f));
+    CHECK(lum->max_full_frame_luminance == doctest::Approx(400.0f));
+}
+
+TEST_CASE("DisplayID color characteristics") {
+    std::vector<uint8_t> block = {0x0E, 0x00, 13, 0x13};  // 3 primaries, 1 white point
+    push_xy12(block, 2785, 1310);
+    push_xy12(block, 1081, 2834);
+    push_xy12(block, 614, 205);
+    push_xy12(block, 1281, 1348);
+    auto edid = make_displayid_edid(block);
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    REQUIRE(info->displayid.has_color_characteristics);
+    const auto& c = info->displayid.color;
+    CHECK(c.primary_count == 3);
+    CHECK(c.white_point_count == 1);
+    CHECK(!c.cie1976_uv);
+    CHECK(c.primaries[0].x == doctest::Approx(0.680).epsilon(0.001));
+    CHECK(c.primaries[2].y == doctest::Approx(0.050).epsilon(0.01));
+    CHECK(c.white.y == doctest::Approx(0.329).epsilon(0.001));
+}
+
+TEST_CASE("DisplayID tiled display topology") {
+    std::vector<uint8_t> block = {0x28, 0x00, 22};
+    block.push_back(0x82);          // capabilities
+    block.push_back(0x10);          // 2 horizontal tiles, 1 vertical
+    block.push_back(0x10);          // this tile at (1, 0)
+    block.push_back(0x00);
+    push_le16(block, 2559);
+    push_le16(block, 2879);
+    for (int i = 0; i < 5; ++i) block.push_back(0);   // bezel
+    block.push_back('D'); block.push_back('E'); block.push_back('L');
+    push_le16(block, 0x4321);
+    push_le16(block, 0x5678); push_le16(block, 0x1234);
+    auto edid = make_displayid_edid(block);
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    REQUIRE(info->displayid.has_tiled_topology);
+    const auto& t = info->displayid.tile;
+    CHECK(t.h_tiles == 2);
+    CHECK(t.v_tiles == 1);
+    CHECK(t.h_location == 1);
+    CHECK(t.v_location == 0);
+    CHECK(t.tile_width == 2560);
+    CHECK(t.tile_height == 2880);
+    CHECK(t.topology_product == 0x4321);
+    CHECK(t.topology_serial == 0x12345678);
+}
+
+TEST_CASE("DisplayID bad section checksum is rejected") {
+    auto edid = make_displayid_edid(display_parameters_block());
+    edid[128 + 10] ^= 0x01;
+    // Keep the EDID block checksum valid so only the section check fails
+    edid[255] = checksum_byte(edid.data() + 128, edid.data() + 255);
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    CHECK(info->checksums_valid);
+    CHECK(!info->has_displayid);
+    CHECK(!panel_luminance(*info).has_value());
+}
+
+TEST_CASE("DisplayID overrunning data block marks section truncated") {
+    std::vector<uint8_t> section = {0x20, 6, 0x00, 0x00,
+                                    0x21, 0x00, 29, 0x00, 0x00, 0x00};
+    section.push_back(checksum_byte(section.data(), section.data() + section.size()));
+    DisplayIdInfo info{};
+    CHECK(parse_displayid_section(section, info));
+    CHECK(info.truncated);
+    CHECK(!info.has_display_parameters);
+}
+
+TEST_CASE("DisplayID section shorter than declared length") {
+    std::vector<uint8_t> section = {0x20, 50, 0x00, 0x00, 0x21};
+    DisplayIdInfo info{};
+    CHECK(!parse_displayid_section(section, info));
+    CHECK(info.truncated);
+}
@@ -1,6 +1,8 @@
 #include "doctest.h"
 #include "core/display/edid_reader.h"
 #include <cstring>
+#include <vector>
+#include <algorithm>
 
 using namespace hdrfixer::display;
 
@@ -38,3 +40,172 @@ TEST_CASE("EDID rejects short data") {
     auto info = parse_edid(edid, 64);
     CHECK(!info.has_value());
 }
+
+namespace {
+
+void fix_checksum(uint8_t* block) {
+    uint8_t sum = 0;
+    for (int i = 0; i < 127; ++i) sum = static_cast<uint8_t>(sum + block[i]);
+    block[127] = static_cast<uint8_t>(0x100 - sum);
+}
+
+// Base block + one CTA-861 extension carrying the given data blocks.
+std::vector<uint8_t> make_cta_edid(std::initializer_list<uint8_t> data_blocks) {
+    std::vector<uint8_t> edid(256, 0);
+    edid[8] = 0x10; edid[9] = 0xAC;
+    edid[126] = 1;
+    fix_checksum(edid.data());
+
+    uint8_t* ext = edid.data() + 128;
+    ext[0] = 0x02;
+    ext[1] = 0x03;
+    ext[2] = static_cast<uint8_t>(4 + data_blocks.size());
+    std::copy(data_blocks.begin(), data_blocks.end(), ext + 4);
+    fix_checksum(ext);
+    return edid;
+}
+
+} // namespace
+
+TEST_CASE("EDID span overload matches pointer overload") {
+    uint8_t edid[128] = {};
+    edid[8] = 0x10; edid[9] = 0xAC;
+    auto info = parse_edid(std::span<const uint8_t>(edid));
+    CHECK(info.has_value());
+    CHECK(info->manufacturer == "DEL");
+    CHECK(info->manufacturer_id == 0x10AC);
+    CHECK(info->extension_count == 0);
+}
+
+TEST_CASE("EDID manufacturer id encode/decode round trip") {
+    CHECK(encode_manufacturer_id("DEL") == 0x10AC);
+    CHECK(decode_manufacturer_id(0x10AC) == "DEL");
+    CHECK(decode_manufacturer_id(encode_manufacturer_id("SAM")) == "SAM");
+    CHECK(encode_manufacturer_id("TOOLONG") == 0);
+}
+
+TEST_CASE("EDID base block chromaticity") {
+    uint8_t edid[128] = {};
+    // sRGB primaries: R(0.640,0.330) G(0.300,0.600) B(0.150,0.060) W(0.3127,0.3290)
+    // 10-bit values: R 655/338, G 307/614, B 154/61, W 320/337
+    edid[27] = 655 >> 2; edid[28] = 338 >> 2;
+    edid[29] = 307 >> 2; edid[30] = 614 >> 2;
+    edid[31] = 154 >> 2; edid[32] = 61 >> 2;
+    edid[33] = 320 >> 2; edid[34] = 337 >> 2;
+    edid[25] = static_cast<uint8_t>(((655 & 3) << 6) | ((338 & 3) << 4) | ((307 & 3) << 2) | (614 & 3));
+    edid[26] = static_cast<uint8_t>(((154 & 3) << 6) | ((61 & 3) << 4) | ((320 & 3) << 2) | (337 & 3));
+    auto info = parse_edid(edid, 128);
+    REQUIRE(info.has_value());
+    CHECK(info->red.x == doctest::Approx(0.640).epsilon(0.002));
+    CHECK(info->red.y == doctest::Approx(0.330).epsilon(0.005));
+    CHECK(info->green.y == doctest::Approx(0.600).epsilon(0.002));
+    CHECK(info->blue.x == doctest::Approx(0.150).epsilon(0.005));
+    CHECK(info->white.x == doctest::Approx(0.3127).epsilon(0.005));
+    CHECK(info->white.y == doctest::Approx(0.3290).epsilon(0.005));
+}
+
+TEST_CASE("EDID CTA HDR static metadata") {
+    // Extended tag 0x06: EOTF SDR|PQ|HLG, SM type 1, max CV 96, maxFALL CV 64, min CV 16
+    auto edid = make_cta_edid({0xE6, 0x06, 0x0D, 0x01, 96, 64, 16});
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    CHECK(info->checksums_valid);
+    CHECK(info->extension_count == 1);
+    CHECK(info->has_cta_extension);
+    REQUIRE(info->has_hdr_static_metadata);
+    CHECK(info->hdr.supports_pq());
+    CHECK(info->hdr.supports_hlg());
+    CHECK(info->hdr.max_luminance == doctest::Approx(400.0f));
+    CHECK(info->hdr.max_frame_avg_luminance == doctest::Approx(200.0f));
+    float expected_min = 400.0f * (16.0f / 255.0f) * (16.0f / 255.0f) / 100.0f;
+    CHECK(info->hdr.min_luminance == doctest::Approx(expected_min));
+}
+
+TEST_CASE("EDID CTA colorimetry and vendor blocks") {
+    auto edid = make_cta_edid({
+        0xE3, 0x05, 0xC0, 0x80,                   // colorimetry: BT2020 YCC+RGB, DCI-P3
+        0x67, 0x03, 0x0C, 0x00, 0x10, 0x00, 0x38, 0x3C, // HDMI VSDB 1.0.0.0, DC30/36, 300 MHz
+        0x66, 0xD8, 0x5D, 0xC4, 0x01, 0x78, 0x00, // HDMI Forum VSDB, 600 MHz
+        0xE5, 0x01, 0x8B, 0x84, 0x90, 0x01,       // HDR10+ vendor-specific video
+    });
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    CHECK((info->colorimetry & kColorimetryBt2020Rgb) != 0);
+    CHECK((info->colorimetry & kColorimetryBt2020Ycc) != 0);
+    CHECK((info->colorimetry & kColorimetryDciP3) != 0);
+    CHECK(info->vendor.has_hdmi);
+    CHECK(info->vendor.hdmi_physical_address == 0x1000);
+    CHECK(info->vendor.hdmi_deep_color_30);
+    CHECK(info->vendor.hdmi_max_tmds_mhz == 300);
+    CHECK(info->vendor.has_hdmi_forum);
+    CHECK(info->vendor.hdmi_forum_max_tmds_mhz == 600);
+    CHECK(info->vendor.has_hdr10_plus);
+    CHECK(!info->has_hdr_static_metadata);
+}
+
+TEST_CASE("EDID extension with bad checksum is skipped") {
+    auto edid = make_cta_edid({0xE6, 0x06, 0x0D, 0x01, 96, 64, 16});
+    edid[200] ^= 0xFF;
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    CHECK(!info->checksums_valid);
+    CHECK(info->extension_count == 1);
+    CHECK(!info->has_hdr_static_metadata);
+}
+
+TEST_CASE("EDID extension count clamped to available data") {
+    auto edid = make_cta_edid({0xE6, 0x06, 0x0D, 0x01, 96, 64, 16});
+    edid[126] = 3; // declares more extensions than present
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    CHECK(info->extension_count == 1);
+
+    edid.resize(200); // truncated extension is ignored
+    info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    CHECK(info->extension_count == 0);
+    CHECK(!info->has_cta_extension);
+}
+
+TEST_CASE("EDID CTA truncated data block collection") {
+    // Block header claims 20 payload bytes but the collection ends first
+    auto edid = make_cta_edid({0xF4, 0x06, 0x0D});
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+    CHECK(info->has_cta_extension);
+    CHECK(!info->has_hdr_static_metadata);
+}
+
+TEST_CASE("EDID parser survives mutated and truncated input") {
+    // Deterministic smoke version of the fuzz target: flip every byte of a
+    // CTA EDID, re-sign the block so the parser walks past the checksum,
+    // and parse every truncation length.  Must not crash or trip sanitizers.
+    auto seed = make_cta_edid({
+        0xE6, 0x06, 0x0D, 0x01, 96, 64, 16,
+        0xE3, 0x05, 0xC0, 0x00,
+        0x67, 0x03, 0x0C, 0x00, 0x10, 0x00, 0x38,
+    });
+
+    uint32_t state = 0x12345678;
+    auto next = [&] {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        return state;
+    };
+
+    for (size_t i = 0; i < seed.size(); ++i) {
+        if (i == 127 || i == 255) continue;
+        for (int trial = 0; trial < 8; ++trial) {
+            auto edid = seed;
+            edid[i] = static_cast<uint8_t>(next());
+            fix_checksum(edid.data() + (i / 128) * 128);
+            auto info = parse_edid(edid);
+            REQUIRE(info.has_value());
+            CHECK(info->extension_count <= 1);
+        }
+    }
+
+    for (size_t len = 0; len <= seed.size(); ++len) {
+        auto info = parse_edid(std::span<const uint8_t>(seed.data(), len));
+        CHECK(info.has_value() == (len >= 128));
+    }
+}
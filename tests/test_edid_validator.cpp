@@ -0,0 +1,174 @@
+#include "doctest.h"
+#include "core/display/edid_validator.h"
+#include <vector>
+
+using namespace hdrfixer::display;
+
+namespace {
+
+void fix_checksum(uint8_t* block) {
+    uint8_t sum = 0;
+    for (int i = 0; i < 127; ++i) sum = static_cast<uint8_t>(sum + block[i]);
+    block[127] = static_cast<uint8_t>(0x100 - sum);
+}
+
+void set_chroma(uint8_t* edid, int rx, int ry, int gx, int gy, int bx, int by, int wx, int wy) {
+    edid[25] = static_cast<uint8_t>(((rx & 3) << 6) | ((ry & 3) << 4) | ((gx & 3) << 2) | (gy & 3));
+    edid[26] = static_cast<uint8_t>(((bx & 3) << 6) | ((by & 3) << 4) | ((wx & 3) << 2) | (wy & 3));
+    edid[27] = static_cast<uint8_t>(rx >> 2); edid[28] = static_cast<uint8_t>(ry >> 2);
+    edid[29] = static_cast<uint8_t>(gx >> 2); edid[30] = static_cast<uint8_t>(gy >> 2);
+    edid[31] = static_cast<uint8_t>(bx >> 2); edid[32] = static_cast<uint8_t>(by >> 2);
+    edid[33] = static_cast<uint8_t>(wx >> 2); edid[34] = static_cast<uint8_t>(wy >> 2);
+}
+
+// Well-formed EDID 1.4 with sRGB primaries and a CTA extension that reports
+// 400 nits peak / 200 nits frame-average.
+std::vector<uint8_t> make_valid_edid() {
+    std::vector<uint8_t> edid(256, 0);
+    const uint8_t header[8] = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+    std::copy(header, header + 8, edid.begin());
+    edid[8] = 0x10; edid[9] = 0xAC;   // DEL
+    edid[18] = 1; edid[19] = 4;
+    edid[20] = 0xB5;                  // digital, 10 bpc, DisplayPort
+    set_chroma(edid.data(), 655, 338, 307, 614, 154, 61, 320, 337);
+    edid[126] = 1;
+    fix_checksum(edid.data());
+
+    uint8_t* ext = edid.data() + 128;
+    ext[0] = 0x02; ext[1] = 0x03; ext[2] = 11;
+    const uint8_t hdr_block[] = {0xE6, 0x06, 0x0D, 0x01, 96, 64, 16};
+    std::copy(std::begin(hdr_block), std::end(hdr_block), ext + 4);
+    fix_checksum(ext);
+    return edid;
+}
+
+ReportedCapabilities srgb_caps(float max_nits) {
+    ReportedCapabilities caps{};
+    caps.max_luminance = max_nits;
+    caps.red = {0.640f, 0.330f};
+    caps.green = {0.300f, 0.600f};
+    caps.blue = {0.150f, 0.060f};
+    caps.white = {0.3127f, 0.3290f};
+    return caps;
+}
+
+bool has_issue(const EdidReport& report, const std::string& needle) {
+    for (const auto& issue : report.issues) {
+        if (issue.message.find(needle) != std::string::npos) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("EDID validator accepts well-formed EDID") {
+    auto edid = make_valid_edid();
+    auto report = validate_edid(edid);
+    CHECK(report.issues.empty());
+    CHECK(!report.has_errors());
+    CHECK(report.summary() == "0 error(s), 0 warning(s)");
+}
+
+TEST_CASE("EDID validator flags checksum and header errors") {
+    auto edid = make_valid_edid();
+    edid[0] = 0x12;
+    edid[130] ^= 0x01;
+    auto report = validate_edid(edid);
+    CHECK(report.has_errors());
+    CHECK(has_issue(report, "header pattern"));
+    CHECK(has_issue(report, "Block 0 checksum"));
+    CHECK(has_issue(report, "Block 1 checksum"));
+}
+
+TEST_CASE("EDID validator flags reserved bits and versions") {
+    auto edid = make_valid_edid();
+    edid[8] |= 0x80;      // reserved manufacturer bit
+    edid[20] = 0xF7;      // reserved bit depth and interface
+    fix_checksum(edid.data());
+    auto report = validate_edid(edid);
+    CHECK(has_issue(report, "reserved bit"));
+    CHECK(has_issue(report, "bit depth"));
+    CHECK(has_issue(report, "interface"));
+
+    edid = make_valid_edid();
+    edid[18] = 2;
+    fix_checksum(edid.data());
+    CHECK(has_issue(validate_edid(edid), "Unsupported EDID version 2.4"));
+}
+
+TEST_CASE("EDID validator flags truncated and short dumps") {
+    auto edid = make_valid_edid();
+    edid.resize(128);
+    auto report = validate_edid(edid);
+    CHECK(has_issue(report, "declares 1 extension"));
+
+    std::vector<uint8_t> tiny(40, 0);
+    report = validate_edid(tiny);
+    CHECK(report.error_count() == 1);
+}
+
+TEST_CASE("EDID validator flags implausible chromaticity") {
+    auto edid = make_valid_edid();
+    // Swap red and blue so the gamut triangle winds the wrong way
+    set_chroma(edid.data(), 154, 61, 307, 614, 655, 338, 320, 337);
+    fix_checksum(edid.data());
+    auto report = validate_edid(edid);
+    CHECK(has_issue(report, "gamut triangle"));
+
+    set_chroma(edid.data(), 655, 338, 307, 614, 154, 61, 700, 200);
+    fix_checksum(edid.data());
+    CHECK(has_issue(validate_edid(edid), "daylight locus"));
+}
+
+TEST_CASE("EDID validator flags implausible luminance") {
+    auto edid = make_valid_edid();
+    uint8_t* ext = edid.data() + 128;
+    ext[8] = 0x01;   // max CV 1 -> ~51 nits
+    ext[9] = 200;    // frame average far above peak
+    fix_checksum(ext);
+    auto report = validate_edid(edid);
+    CHECK(has_issue(report, "max luminance"));
+    CHECK(has_issue(report, "exceeds peak"));
+}
+
+TEST_CASE("EDID cross-check against reported capabilities") {
+    auto edid = make_valid_edid();
+    auto info = parse_edid(edid);
+    REQUIRE(info.has_value());
+
+    EdidReport agree;
+    cross_check_edid(*info, srgb_caps(420.0f), agree);
+    CHECK(agree.issues.empty());
+
+    auto caps = srgb_caps(1000.0f);
+    caps.green = {0.265f, 0.690f};
+    EdidReport disagree;
+    cross_check_edid(*info, caps, disagree);
+    CHECK(has_issue(disagree, "max luminance"));
+    CHECK(has_issue(disagree, "green chromaticity"));
+    CHECK(!disagree.has_errors());
+}
+
+TEST_CASE("EDID validation cache keyed by content") {
+    EdidValidationCache cache;
+    auto edid = make_valid_edid();
+    auto caps = srgb_caps(400.0f);
+
+    auto first = cache.validate(edid, caps);
+    auto second = cache.validate(edid, caps);
+    CHECK(first.issues.size() == second.issues.size());
+    CHECK(cache.misses() == 1);
+    CHECK(cache.hits() == 1);
+    CHECK(cache.size() == 1);
+
+    // Different reported capabilities or EDID bytes are distinct entries
+    cache.validate(edid, srgb_caps(1000.0f));
+    edid[200] = 0x55;
+    auto changed = cache.validate(edid, caps);
+    CHECK(changed.has_errors());
+    CHECK(cache.size() == 3);
+
+    cache.clear();
+    CHECK(cache.size() == 0);
+    CHECK(cache.hits() == 0);
+}
@@ -1,5 +1,16 @@
 #include "doctest.h"
 #include "core/fixes/fix_engine.h"
+#include "core/fixes/worker_pool.h"
+#include "core/fixes/fix_executor.h"
+#include <atomic>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <stdexcept>
 
 using namespace hdrfixer::fixes;
 
@@ -14,7 +25,10 @@ struct MockFix : public IFix {
 };
 
 struct FailingFix : public IFix {
-    std::string name() const override { return "FailingFix"; }
+    static constexpr std::string_view kName = "FailingFix";
+    static constexpr FixId kId = fix_id(kName);
+
+    std::string name() const override { return std::string(kName); }
     std::string description() const override { return "Always fails"; }
     FixCategory category() const override { return FixCategory::SdrBrightness; }
     FixResult apply() override { return {false, "Failed to apply"}; }
@@ -69,7 +83,7 @@ TEST_CASE("FixEngine diagnose all") {
 TEST_CASE("FixEngine get_fix by name") {
     FixEngine engine;
     engine.register_fix(std::make_unique<MockFix>());
-    auto* fix = engine.get_fix("MockFix");
+    auto* fix = engine.get_fix(fix_id("MockFix"));
     CHECK(fix != nullptr);
     CHECK(fix->name() == "MockFix");
 }
@@ -77,7 +91,7 @@ TEST_CASE("FixEngine get_fix by name") {
 TEST_CASE("FixEngine get_fix returns nullptr for unknown") {
     FixEngine engine;
     engine.register_fix(std::make_unique<MockFix>());
-    auto* fix = engine.get_fix("NonExistent");
+    auto* fix = engine.get_fix(fix_id("NonExistent"));
     CHECK(fix == nullptr);
 }
 
@@ -109,3 +123,892 @@ TEST_CASE("FixEngine apply_all applies error-state fixes") {
     auto results = engine.diagnose_all();
     CHECK(results[0].state == FixState::Error);
 }
+
+TEST_CASE("FixEngine looks fixes up by id and owner") {
+    FixEngine engine;
+    CHECK(engine.register_fix(std::make_unique<FailingFix>()));
+    CHECK(engine.register_fix(std::make_unique<FailingFix>(), 0x11));
+    CHECK(engine.register_fix(std::make_unique<MockFix>(), 0x11));
+
+    auto* global = engine.get<FailingFix>();
+    auto* display = engine.get<FailingFix>(0x11);
+    // A second registration under the same key does not shadow the first
+    CHECK(engine.register_fix(std::make_unique<FailingFix>(), 0x11));
+    CHECK(engine.get<FailingFix>(0x11) == display);
+    REQUIRE(global != nullptr);
+    REQUIRE(display != nullptr);
+    CHECK(global != display);
+    CHECK(engine.get<FailingFix>(0x22) == nullptr);
+    CHECK(engine.get_fix(fix_id("MockFix"), 0x11) != nullptr);
+    CHECK(engine.get_fix(fix_id("MockFix")) == nullptr);
+
+    // Indices shift on removal; lookups must follow
+    CHECK(engine.remove_fixes(0) == 1);
+    CHECK(engine.fix_count() == 3);
+    CHECK(engine.get<FailingFix>() == nullptr);
+    CHECK(engine.get<FailingFix>(0x11) == display);
+    static_assert(fix_id("FailingFix") == FailingFix::kId);
+}
+
+TEST_CASE("FixEngine removes fixes by owner") {
+    FixEngine engine;
+    engine.register_fix(std::make_unique<MockFix>(), 0x11);
+    engine.register_fix(std::make_unique<FailingFix>(), 0x22);
+    engine.register_fix(std::make_unique<MockFix>());
+    CHECK(engine.has_fixes(0x11));
+    CHECK(engine.has_fixes(0x22));
+
+    CHECK(engine.remove_fixes(0x11) == 1);
+    CHECK(!engine.has_fixes(0x11));
+    CHECK(engine.fix_count() == 2);
+    CHECK(engine.get_fix(fix_id("FailingFix"), 0x22) != nullptr);
+
+    CHECK(engine.remove_fixes(0x11) == 0);
+    CHECK(engine.remove_fixes(0) == 1);
+    CHECK(engine.fix_count() == 1);
+}
+
+TEST_CASE("FixEngine reports cached statuses per owner") {
+    FixEngine engine;
+    engine.register_fix(std::make_unique<MockFix>(), 0x22);
+    engine.register_fix(std::make_unique<MockFix>());
+    engine.register_fix(std::make_unique<FailingFix>(), 0x22);
+    engine.register_fix(std::make_unique<MockFix>(), 0x11);
+    CHECK(engine.owners() == std::vector<uint64_t>{0x22, 0, 0x11});
+
+    auto report = engine.report(0x22);
+    REQUIRE(report.size() == 2);
+    CHECK(report[0].name == "MockFix");
+    CHECK(report[1].id == FailingFix::kId);
+    CHECK(report[1].owner == 0x22);
+    CHECK(!report[0].status);   // report() never diagnoses
+
+    engine.diagnose_all();
+    report = engine.report(0x22);
+    REQUIRE(report[1].status);
+    CHECK(report[1].status->state == FixState::Error);
+
+    engine.apply_all();
+    CHECK(!engine.report(0x22)[0].status);   // applying made it stale
+
+    engine.diagnose_dirty();
+    report = engine.report(0x11);
+    REQUIRE(report.size() == 1);
+    REQUIRE(report[0].status);
+    CHECK(report[0].status->state == FixState::Applied);
+    CHECK(engine.report(0x33).empty());
+}
+
+namespace {
+
+// Blocks in diagnose() until released, so timeouts are deterministic
+struct BlockingFix : public IFix {
+    explicit BlockingFix(std::shared_future<void> release) : release(std::move(release)) {}
+    std::string name() const override { return "BlockingFix"; }
+    std::string description() const override { return "Blocks in diagnose"; }
+    FixCategory category() const override { return FixCategory::PixelFormat; }
+    FixResult apply() override { return {true, ""}; }
+    FixResult revert() override { return {true, ""}; }
+    FixStatus diagnose() override {
+        release.wait();
+        ++calls;
+        return {FixState::Applied, "done"};
+    }
+    std::shared_future<void> release;
+    std::atomic<int> calls{0};
+};
+
+struct ThrowingFix : public MockFix {
+    FixStatus diagnose() override { throw std::runtime_error("boom"); }
+};
+
+} // namespace
+
+TEST_CASE("FixEngine parallel diagnose keeps registration order") {
+    FixEngine engine;
+    engine.register_fix(std::make_unique<MockFix>());
+    engine.register_fix(std::make_unique<FailingFix>());
+    engine.register_fix(std::make_unique<ThrowingFix>());
+    WorkerPool pool(2);
+
+    auto results = engine.diagnose_all(pool, std::chrono::seconds(5));
+    REQUIRE(results.size() == 3);
+    CHECK(results[0].state == FixState::NotApplied);
+    CHECK(results[1].state == FixState::Error);
+    CHECK(results[1].message == "Error state");
+    CHECK(results[2].state == FixState::Error);
+    CHECK(results[2].message == "Diagnosis failed: boom");
+}
+
+TEST_CASE("FixEngine parallel diagnose times out slow fixes") {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    FixEngine engine;
+    auto slow = std::make_unique<BlockingFix>(gate);
+    auto* slow_ptr = slow.get();
+    engine.register_fix(std::move(slow));
+    engine.register_fix(std::make_unique<MockFix>());
+    WorkerPool pool(2);
+
+    auto results = engine.diagnose_all(pool, std::chrono::milliseconds(50));
+    REQUIRE(results.size() == 2);
+    CHECK(results[0].state == FixState::Error);
+    CHECK(results[0].message == "BlockingFix: diagnosis timed out after 50 ms");
+    CHECK(results[1].state == FixState::NotApplied);
+
+    // Still running from the first call: not diagnosed twice concurrently
+    results = engine.diagnose_all(pool, std::chrono::milliseconds(50));
+    CHECK(results[0].message == "BlockingFix: previous diagnosis still running");
+
+    release.set_value();
+    for (int i = 0; i < 200 && slow_ptr->calls.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    CHECK(slow_ptr->calls.load() == 1);
+    // Busy flag clears just after the call count; retry briefly
+    for (int i = 0; i < 200; ++i) {
+        results = engine.diagnose_all(pool, std::chrono::seconds(5));
+        if (results[0].state == FixState::Applied) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    CHECK(results[0].state == FixState::Applied);
+}
+
+TEST_CASE("FixEngine parallel diagnose reports fixes that never got a worker") {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    FixEngine engine;
+    engine.register_fix(std::make_unique<BlockingFix>(gate));
+    engine.register_fix(std::make_unique<MockFix>());
+    WorkerPool pool(1);
+
+    auto results = engine.diagnose_all(pool, std::chrono::milliseconds(30));
+    CHECK(results[0].message == "BlockingFix: diagnosis timed out after 30 ms");
+    CHECK(results[1].message == "MockFix: no worker available within 30 ms");
+
+    // Removing a fix mid-diagnosis is safe; the task keeps it alive
+    engine.remove_fixes(0);
+    release.set_value();
+}
+
+TEST_CASE("WorkerPool grows to make room beside a stuck task") {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    FixEngine engine;
+    engine.register_fix(std::make_unique<BlockingFix>(gate));
+    WorkerPool pool(1);
+    engine.diagnose_all(pool, std::chrono::milliseconds(30));   // leaves its worker stuck
+
+    engine.register_fix(std::make_unique<MockFix>());
+    pool.grow(engine.fix_count());
+    pool.grow(1);   // never shrinks
+    CHECK(pool.thread_count() == 2);
+    auto results = engine.diagnose_all(pool, std::chrono::seconds(5));
+    CHECK(results[0].message == "BlockingFix: previous diagnosis still running");
+    CHECK(results[1].state == FixState::NotApplied);
+    release.set_value();
+}
+
+TEST_CASE("FixEngine serial diagnoses skip a fix whose diagnosis timed out") {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    FixEngine engine;
+    auto blocking = std::make_unique<BlockingFix>(gate);
+    auto* fix = blocking.get();
+    engine.register_fix(std::move(blocking));
+    WorkerPool pool(1);
+    engine.diagnose_all(pool, std::chrono::milliseconds(30));   // leaves it running
+
+    // Neither serial path may call diagnose() a second time concurrently
+    CHECK(engine.diagnose_all()[0].message == "BlockingFix: previous diagnosis still running");
+    CHECK(engine.diagnose_dirty()[0].state == FixState::Error);
+    release.set_value();
+    REQUIRE(pool.wait_idle(std::chrono::seconds(5)));
+    CHECK(fix->calls == 1);
+}
+
+TEST_CASE("WorkerPool cancel drops queued work but lets running tasks finish") {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    std::atomic<int> ran{0};
+
+    WorkerPool pool(1);
+    std::promise<void> started;
+    pool.submit([&] { started.set_value(); gate.wait(); ++ran; });
+    started.get_future().wait();
+    pool.submit([&] { ++ran; });
+    pool.submit([&] { ++ran; });
+
+    CHECK(pool.cancel() == 2);
+    pool.submit([&] { ++ran; });   // dropped too
+    CHECK(!pool.wait_idle(std::chrono::milliseconds(20)));
+    release.set_value();
+    CHECK(pool.wait_idle(std::chrono::seconds(5)));
+    CHECK(ran == 1);
+}
+
+TEST_CASE("FixEngine abandon_async frees fixes held by cancelled work") {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    FixEngine engine;
+    engine.register_fix(std::make_unique<BlockingFix>(gate));
+    WorkerPool pool(1);
+    engine.diagnose_all(pool, std::chrono::milliseconds(30));   // leaves it busy
+
+    pool.cancel();
+    release.set_value();
+    REQUIRE(pool.wait_idle(std::chrono::seconds(5)));
+    engine.abandon_async();
+    WorkerPool fresh(1);
+    auto results = engine.diagnose_all(fresh, std::chrono::seconds(5));
+    CHECK(results[0].state == FixState::Applied);
+}
+
+namespace {
+
+struct OrderLog {
+    std::mutex mutex;
+    std::vector<std::string> applied;
+};
+
+struct DepFix : public IFix {
+    DepFix(std::string n, std::vector<std::string> deps, OrderLog& log)
+        : n(std::move(n)), deps(std::move(deps)), log(log) {}
+    std::string name() const override { return n; }
+    std::string description() const override { return "Dependency test fix"; }
+    FixCategory category() const override { return FixCategory::ToneCurve; }
+    FixResult apply() override {
+        std::lock_guard<std::mutex> lock(log.mutex);
+        log.applied.push_back(n);
+        applied = true;
+        return {true, ""};
+    }
+    FixResult revert() override {
+        std::lock_guard<std::mutex> lock(log.mutex);
+        log.applied.push_back("-" + n);
+        applied = false;
+        return {true, ""};
+    }
+    FixStatus diagnose() override { return {applied ? FixState::Applied : FixState::NotApplied, ""}; }
+    std::vector<FixId> dependencies() const override {
+        std::vector<FixId> ids;
+        for (const auto& d : deps) ids.push_back(fix_id(d));
+        return ids;
+    }
+
+    std::string n;
+    std::vector<std::string> deps;
+    OrderLog& log;
+    std::atomic<bool> applied{false};
+};
+
+size_t position(const std::vector<std::string>& v, const std::string& s) {
+    return static_cast<size_t>(std::find(v.begin(), v.end(), s) - v.begin());
+}
+
+} // namespace
+
+TEST_CASE("FixEngine applies in dependency order") {
+    OrderLog log;
+    FixEngine engine;
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Gamma", std::vector<std::string>{"SDR"}, log)));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Pixel", std::vector<std::string>{}, log)));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("SDR", std::vector<std::string>{}, log)));
+    // Unknown dependencies are ignored
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Share", std::vector<std::string>{"Missing"}, log)));
+
+    engine.apply_all();
+    CHECK(log.applied == std::vector<std::string>{"Pixel", "SDR", "Gamma", "Share"});
+
+    log.applied.clear();
+    engine.revert_all();
+    CHECK(log.applied == std::vector<std::string>{"-Share", "-Gamma", "-SDR", "-Pixel"});
+}
+
+TEST_CASE("FixEngine rejects dependency cycles at registration") {
+    OrderLog log;
+    FixEngine engine;
+    CHECK(engine.register_fix(std::make_unique<DepFix>("A", std::vector<std::string>{"C"}, log)));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("B", std::vector<std::string>{"A"}, log)));
+    auto result = engine.register_fix(std::make_unique<DepFix>("C", std::vector<std::string>{"B"}, log));
+    REQUIRE(!result.has_value());
+    CHECK(result.error() == "Dependency cycle through fix 'C'");
+    CHECK(engine.fix_count() == 2);
+
+    auto self = engine.register_fix(std::make_unique<DepFix>("D", std::vector<std::string>{"D"}, log));
+    CHECK(self.has_value());   // a fix never depends on itself
+}
+
+TEST_CASE("FixEngine rejects a cycle closed by a per-owner instance") {
+    OrderLog log;
+    FixEngine engine;
+    CHECK(engine.register_fix(std::make_unique<DepFix>("B", std::vector<std::string>{}, log)));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("A", std::vector<std::string>{"B"}, log), 5));
+    // Owner 5's A now resolves B to this instance, which depends on A
+    auto result = engine.register_fix(std::make_unique<DepFix>("B", std::vector<std::string>{"A"}, log), 5);
+    REQUIRE(!result.has_value());
+    CHECK(result.error() == "Dependency cycle through fix 'B'");
+    CHECK(engine.fix_count() == 2);
+
+    engine.apply_all();
+    CHECK(log.applied == std::vector<std::string>{"B", "A"});
+}
+
+TEST_CASE("FixEngine dependencies resolve within the same owner") {
+    OrderLog log;
+    FixEngine engine;
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Gamma", std::vector<std::string>{"SDR"}, log), 1));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("SDR", std::vector<std::string>{"Gamma"}, log), 2));
+    engine.apply_all();
+    CHECK(log.applied == std::vector<std::string>{"Gamma", "SDR"});
+}
+
+TEST_CASE("FixEngine parallel apply honours dependencies") {
+    for (int round = 0; round < 20; ++round) {
+        OrderLog log;
+        FixEngine engine;
+        CHECK(engine.register_fix(std::make_unique<DepFix>("Gamma", std::vector<std::string>{"SDR"}, log)));
+        CHECK(engine.register_fix(std::make_unique<DepFix>("Profile", std::vector<std::string>{"Gamma", "Pixel"}, log)));
+        CHECK(engine.register_fix(std::make_unique<DepFix>("SDR", std::vector<std::string>{}, log)));
+        CHECK(engine.register_fix(std::make_unique<DepFix>("Pixel", std::vector<std::string>{}, log)));
+        WorkerPool pool(4);
+
+        engine.apply_all(pool);
+        REQUIRE(log.applied.size() == 4);
+        CHECK(position(log.applied, "SDR") < position(log.applied, "Gamma"));
+        CHECK(position(log.applied, "Gamma") < position(log.applied, "Profile"));
+        CHECK(position(log.applied, "Pixel") < position(log.applied, "Profile"));
+    }
+}
+
+TEST_CASE("FixEngine parallel apply runs independent fixes concurrently") {
+    // Each fix waits until the other has started; serial execution would
+    // only see one arrival
+    std::atomic<int> arrived{0};
+    std::atomic<int> overlapped{0};
+    struct RendezvousFix : public MockFix {
+        RendezvousFix(std::atomic<int>& arrived, std::atomic<int>& overlapped)
+            : arrived(arrived), overlapped(overlapped) {}
+        FixResult apply() override {
+            ++arrived;
+            for (int i = 0; i < 400 && arrived.load() < 2; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            if (arrived.load() == 2) ++overlapped;
+            return MockFix::apply();
+        }
+        std::atomic<int>& arrived;
+        std::atomic<int>& overlapped;
+    };
+
+    FixEngine engine;
+    CHECK(engine.register_fix(std::make_unique<RendezvousFix>(arrived, overlapped)));
+    CHECK(engine.register_fix(std::make_unique<RendezvousFix>(arrived, overlapped)));
+    WorkerPool pool(2);
+    engine.apply_all(pool);
+    CHECK(overlapped.load() == 2);
+}
+
+namespace {
+
+struct ObservingFix : public MockFix {
+    ObservingFix(std::string n, std::vector<ObservedResource> resources)
+        : n(std::move(n)), resources(std::move(resources)) {}
+    std::string name() const override { return n; }
+    FixStatus diagnose() override { ++diagnoses; return MockFix::diagnose(); }
+    std::vector<ObservedResource> observed_resources() const override { return resources; }
+    std::string n;
+    std::vector<ObservedResource> resources;
+    int diagnoses = 0;
+};
+
+} // namespace
+
+TEST_CASE("Observed resource matching") {
+    auto drivers = ObservedResource::registry_key(L"HKLM", L"SYSTEM\\CurrentControlSet\\Control\\GraphicsDrivers");
+    auto store = ObservedResource::registry_key(L"HKLM", L"SYSTEM\\CurrentControlSet\\Control\\GraphicsDrivers\\MonitorDataStore");
+    auto sibling = ObservedResource::registry_key(L"HKLM", L"SYSTEM\\CurrentControlSet\\Control\\GraphicsDriversExtra");
+    auto lower = ObservedResource::registry_key(L"hklm", L"system\\currentcontrolset\\control\\graphicsdrivers");
+
+    CHECK(drivers.key == "HKLM\\SYSTEM\\CurrentControlSet\\Control\\GraphicsDrivers");
+    CHECK(resource_affected(store, drivers));     // subtree change covers children
+    CHECK(resource_affected(drivers, store));     // child change alters parent reads
+    CHECK(resource_affected(store, lower));
+    CHECK(!resource_affected(sibling, drivers));
+
+    auto target = ObservedResource::display_target(0x0000000100002a3bull, 4);
+    CHECK(target.key == "0000000100002a3b:4");
+    CHECK(resource_affected(target, ObservedResource::display_target(0x0000000100002a3bull, 4)));
+    CHECK(!resource_affected(target, ObservedResource::display_target(0x0000000100002a3bull, 5)));
+    CHECK(!resource_affected(target, drivers));
+
+    auto profile = ObservedResource::file(L"C:\\Windows\\System32\\spool\\drivers\\color\\Caf\u00e9.icm");
+    CHECK(profile.key == "C:\\Windows\\System32\\spool\\drivers\\color\\Caf\xc3\xa9.icm");
+    CHECK(resource_affected(profile, ObservedResource::file(L"c:\\windows\\system32\\spool\\drivers\\color\\Caf\u00e9.icm")));
+    // A directory change covers the files in it, not the other way round
+    auto color_dir = ObservedResource::file(L"C:\\Windows\\System32\\spool\\drivers\\color\\");
+    CHECK(resource_affected(profile, color_dir));
+    CHECK(!resource_affected(color_dir, profile));
+    CHECK(!resource_affected(profile, ObservedResource::file(L"C:\\Windows\\System32\\spool\\drivers\\colo")));
+    CHECK(!resource_affected(profile, ObservedResource::file(L"C:\\Windows\\System32\\spool\\drivers\\color\\Other.icm")));
+}
+
+TEST_CASE("FixEngine re-diagnoses only dirty fixes") {
+    auto drivers = ObservedResource::registry_key(L"HKLM", L"SYSTEM\\CurrentControlSet\\Control\\GraphicsDrivers");
+    auto store = ObservedResource::registry_key(L"HKLM", L"SYSTEM\\CurrentControlSet\\Control\\GraphicsDrivers\\MonitorDataStore");
+    auto target = ObservedResource::display_target(1, 2);
+
+    FixEngine engine;
+    auto sdr = std::make_unique<ObservingFix>("SDR", std::vector<ObservedResource>{target, store});
+    auto pixel = std::make_unique<ObservingFix>("Pixel", std::vector<ObservedResource>{target});
+    auto unknown = std::make_unique<ObservingFix>("Unknown", std::vector<ObservedResource>{});
+    auto* sdr_ptr = sdr.get();
+    auto* pixel_ptr = pixel.get();
+    auto* unknown_ptr = unknown.get();
+    CHECK(engine.register_fix(std::move(sdr)));
+    CHECK(engine.register_fix(std::move(pixel)));
+    CHECK(engine.register_fix(std::move(unknown)));
+
+    CHECK(engine.dirty_count() == 3);
+    auto first = engine.diagnose_dirty();
+    CHECK(first.size() == 3);
+    CHECK(engine.dirty_count() == 0);
+
+    // Fixes that declare no resources go stale on any change event
+    engine.notify_changed(drivers);
+    CHECK(engine.dirty_count() == 2);
+    sdr_ptr->applied = true;            // state changed behind the engine's back
+    auto second = engine.diagnose_dirty();
+    CHECK(second[0].state == FixState::Applied);
+    CHECK(second[1].state == FixState::NotApplied);   // cached
+    CHECK(sdr_ptr->diagnoses == 2);
+    CHECK(pixel_ptr->diagnoses == 1);
+    CHECK(unknown_ptr->diagnoses == 2);
+
+    engine.mark_all_dirty();
+    engine.diagnose_dirty();
+    CHECK(pixel_ptr->diagnoses == 2);
+}
+
+TEST_CASE("FixEngine apply dirties applied fixes") {
+    auto target = ObservedResource::display_target(1, 2);
+    FixEngine engine;
+    auto fix = std::make_unique<ObservingFix>("SDR", std::vector<ObservedResource>{target});
+    auto* ptr = fix.get();
+    CHECK(engine.register_fix(std::move(fix)));
+
+    engine.diagnose_dirty();
+    CHECK(engine.dirty_count() == 0);
+    engine.apply_all();
+    CHECK(engine.dirty_count() == 1);
+    auto statuses = engine.diagnose_dirty();
+    CHECK(statuses[0].state == FixState::Applied);
+
+    // Already applied: apply_all's own diagnosis refreshes the cache
+    engine.apply_all();
+    CHECK(engine.dirty_count() == 0);
+    CHECK(ptr->applied);
+}
+
+TEST_CASE("FixEngine drift ignores fixes an apply cannot change") {
+    // Succeeds but changes nothing, like a fix that only recommends
+    struct AdvisoryFix : public MockFix {
+        std::string name() const override { return "Advisory"; }
+        FixResult apply() override { return {true, "Recommended"}; }
+    };
+    FixEngine engine;
+    auto fix = std::make_unique<MockFix>();
+    auto* ptr = fix.get();
+    CHECK(engine.register_fix(std::move(fix)));
+    CHECK(engine.register_fix(std::make_unique<AdvisoryFix>()));
+
+    engine.diagnose_dirty();
+    CHECK(engine.drift_count() == 2);   // nothing applied yet
+    engine.apply_all();
+    CHECK(engine.drift_count() == 0);   // stale statuses do not count
+    engine.diagnose_dirty();
+    CHECK(engine.drift_count() == 0);
+
+    // A later check still finds the advisory fix NotApplied: not drift
+    engine.mark_all_dirty();
+    engine.diagnose_dirty();
+    CHECK(engine.drift_count() == 0);
+
+    // The applied fix is undone behind the engine's back: drift
+    ptr->applied = false;
+    engine.mark_all_dirty();
+    engine.diagnose_dirty();
+    CHECK(engine.drift_count() == 1);
+
+    // A revert is not an apply: the reverted fix counts again
+    engine.apply_all();
+    engine.revert_all();
+    engine.diagnose_dirty();
+    CHECK(engine.drift_count() == 1);
+}
+
+TEST_CASE("FixEngine parallel diagnose_dirty keeps timed-out fixes dirty") {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    struct SlowObservingFix : public BlockingFix {
+        using BlockingFix::BlockingFix;
+        std::vector<ObservedResource> observed_resources() const override {
+            return {ObservedResource::display_target(1, 2)};
+        }
+    };
+
+    FixEngine engine;
+    CHECK(engine.register_fix(std::make_unique<SlowObservingFix>(gate)));
+    CHECK(engine.register_fix(std::make_unique<ObservingFix>("Pixel",
+        std::vector<ObservedResource>{ObservedResource::display_target(1, 2)})));
+    WorkerPool pool(2);
+
+    auto statuses = engine.diagnose_dirty(pool, std::chrono::milliseconds(30));
+    CHECK(statuses[0].state == FixState::Error);
+    CHECK(statuses[1].state == FixState::NotApplied);
+    CHECK(engine.dirty_count() == 1);
+
+    release.set_value();
+    for (int i = 0; i < 200 && engine.dirty_count() > 0; ++i) {
+        statuses = engine.diagnose_dirty(pool, std::chrono::seconds(5));
+        if (statuses[0].state != FixState::Error) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    CHECK(statuses[0].state == FixState::Applied);
+    CHECK(engine.dirty_count() == 0);
+}
+
+namespace {
+
+// Counts diagnose() calls; "applied" flips on apply like a real fix
+struct CountingFix : public IFix {
+    CountingFix(std::string n, std::vector<ObservedResource> resources)
+        : n(std::move(n)), resources(std::move(resources)) {}
+    std::string name() const override { return n; }
+    std::string description() const override { return "Counts diagnoses"; }
+    FixCategory category() const override { return FixCategory::SdrBrightness; }
+    FixResult apply() override { applied = true; ++applies; return {true, ""}; }
+    FixResult revert() override { applied = false; ++reverts; return {true, ""}; }
+    FixStatus diagnose() override {
+        ++diagnoses;
+        return {applied ? FixState::Applied : FixState::NotApplied, ""};
+    }
+    std::vector<ObservedResource> observed_resources() const override { return resources; }
+    std::string n;
+    std::vector<ObservedResource> resources;
+    std::atomic<int> diagnoses{0};
+    std::atomic<int> applies{0};
+    std::atomic<int> reverts{0};
+    std::atomic<bool> applied{false};
+};
+
+} // namespace
+
+TEST_CASE("FixEngine watchdog trigger costs one diagnose pass") {
+    auto drivers = ObservedResource::registry_key(L"HKLM", L"SYSTEM\\CurrentControlSet\\Control\\GraphicsDrivers");
+    auto store = ObservedResource::registry_key(L"HKLM", L"SYSTEM\\CurrentControlSet\\Control\\GraphicsDrivers\\MonitorDataStore");
+    auto target = ObservedResource::display_target(1, 2);
+
+    FixEngine engine;
+    auto sdr = std::make_unique<CountingFix>("SDR", std::vector<ObservedResource>{target, store});
+    auto pixel = std::make_unique<CountingFix>("Pixel", std::vector<ObservedResource>{target});
+    auto share = std::make_unique<CountingFix>("Share", std::vector<ObservedResource>{});
+    auto* sdr_ptr = sdr.get();
+    auto* pixel_ptr = pixel.get();
+    auto* share_ptr = share.get();
+    CHECK(engine.register_fix(std::move(sdr)));
+    CHECK(engine.register_fix(std::move(pixel)));
+    CHECK(engine.register_fix(std::move(share)));
+    auto total = [&] { return sdr_ptr->diagnoses + pixel_ptr->diagnoses + share_ptr->diagnoses; };
+
+    // Startup: one diagnosis per fix, then everything is applied
+    engine.apply_all();
+    CHECK(total() == 3);
+    CHECK(sdr_ptr->applies == 1);
+
+    // Trigger shape used by the app: diagnose_dirty, then apply_all only
+    // if something is NotApplied.  The first pass after applying has to
+    // confirm the new state once.
+    auto trigger = [&](const ObservedResource& changed) {
+        engine.notify_changed(changed);
+        auto statuses = engine.diagnose_dirty();
+        for (const auto& s : statuses) {
+            if (s.state == FixState::NotApplied) {
+                engine.apply_all();
+                break;
+            }
+        }
+    };
+
+    trigger(drivers);
+    CHECK(total() == 6);
+
+    // Steady state: only SDR (observes MonitorDataStore) and Share (no
+    // declared resources) are stale; nothing needs re-applying
+    trigger(drivers);
+    CHECK(total() == 8);
+    CHECK(pixel_ptr->diagnoses == 2);
+
+    // External revert: the trigger diagnoses each stale fix once and
+    // apply_all reuses those statuses instead of diagnosing again
+    sdr_ptr->applied = false;
+    trigger(drivers);
+    CHECK(sdr_ptr->diagnoses == 4);
+    CHECK(share_ptr->diagnoses == 4);
+    CHECK(pixel_ptr->diagnoses == 2);
+    CHECK(sdr_ptr->applies == 2);
+
+    // Parallel variants share the same cache
+    WorkerPool pool(2);
+    sdr_ptr->applied = false;
+    engine.notify_changed(drivers);
+    engine.diagnose_dirty(pool, std::chrono::seconds(5));
+    int before = total();
+    engine.apply_all(pool);
+    CHECK(total() == before);
+    CHECK(sdr_ptr->applies == 3);
+}
+
+TEST_CASE("FixEngine revert_all reuses cached statuses") {
+    FixEngine engine;
+    auto fix = std::make_unique<CountingFix>("SDR",
+        std::vector<ObservedResource>{ObservedResource::display_target(1, 2)});
+    auto* ptr = fix.get();
+    CHECK(engine.register_fix(std::move(fix)));
+
+    engine.apply_all();              // diagnose + apply
+    engine.diagnose_dirty();         // confirm Applied
+    CHECK(ptr->diagnoses == 2);
+    engine.revert_all();             // uses the cached Applied status
+    CHECK(ptr->diagnoses == 2);
+    CHECK(ptr->reverts == 1);
+
+    // A direct change outside the engine is reported via invalidate()
+    engine.diagnose_dirty();
+    CHECK(ptr->diagnoses == 3);
+    ptr->applied = true;
+    engine.invalidate(ptr);
+    engine.revert_all();
+    CHECK(ptr->diagnoses == 4);
+    CHECK(ptr->reverts == 2);
+}
+
+TEST_CASE("FixEngine generation snapshot rejects stale diagnoses") {
+    FixEngine engine;
+    auto fix = std::make_unique<CountingFix>("SDR",
+        std::vector<ObservedResource>{ObservedResource::display_target(1, 2)});
+    auto* ptr = fix.get();
+    CHECK(engine.register_fix(std::move(fix)));
+
+    uint64_t g0 = engine.generation();
+    engine.diagnose_dirty();
+    CHECK(engine.generation() == g0);     // diagnosing does not bump it
+    engine.notify_changed(ObservedResource::display_target(1, 2));
+    CHECK(engine.generation() == g0 + 1);
+    engine.notify_changed(ObservedResource::display_target(9, 9));
+    CHECK(engine.generation() == g0 + 1); // unrelated change
+    engine.diagnose_dirty();
+    CHECK(ptr->diagnoses == 2);
+    CHECK(engine.dirty_count() == 0);
+}
+
+namespace {
+
+// Stands in for the tray's message loop: completions posted from workers
+// run only when the test thread pumps.
+struct UiQueue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        cv.notify_all();
+    }
+
+    // Run posted tasks until `done` holds; false on timeout
+    bool pump_until(const std::function<bool()>& done,
+                    std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!done()) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (!cv.wait_until(lock, deadline, [&] { return !tasks.empty(); })) return done();
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Synchronous fixes are adapted to the async interface") {
+    UiQueue ui;
+    WorkerPool pool(1);
+    FixExecutor executor(pool, [&ui](std::function<void()> task) { ui.post(std::move(task)); });
+
+    MockFix fix;
+    std::thread::id completed_on;
+    auto result = fix.apply_async(executor, [&](const FixResult& r) {
+        CHECK(r.success);
+        completed_on = std::this_thread::get_id();
+    });
+    CHECK(result.get().success);
+    CHECK(ui.pump_until([&] { return completed_on != std::thread::id{}; }));
+    CHECK(completed_on == std::this_thread::get_id());
+    CHECK(fix.diagnose_async(executor).get().state == FixState::Applied);
+
+    ThrowingFix throwing;
+    auto status = throwing.diagnose_async(executor).get();
+    CHECK(status.state == FixState::Error);
+    CHECK(status.message == "Diagnosis failed: boom");
+}
+
+TEST_CASE("FixEngine async apply leaves the UI thread free") {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    UiQueue ui;
+    WorkerPool pool(2);
+    FixExecutor executor(pool, [&ui](std::function<void()> task) { ui.post(std::move(task)); });
+    OrderLog log;
+    FixEngine engine;
+    auto blocking = std::make_unique<BlockingFix>(gate);
+    auto* blocking_ptr = blocking.get();
+    engine.register_fix(std::move(blocking));
+    auto quick = std::make_unique<DepFix>("Quick", std::vector<std::string>{}, log);
+    auto* quick_ptr = quick.get();
+    engine.register_fix(std::move(quick));
+
+    bool done = false;
+    engine.apply_all_async(executor, [&] { done = true; });
+    CHECK(!done);
+
+    // The independent fix completes while the blocking one is in flight,
+    // and the in-flight fix counts as busy
+    CHECK(ui.pump_until([&] { return quick_ptr->applied.load(); }));
+    auto results = engine.diagnose_all(pool, std::chrono::milliseconds(50));
+    CHECK(results[0].message == "BlockingFix: previous diagnosis still running");
+    CHECK(!done);
+
+    release.set_value();
+    CHECK(ui.pump_until([&] { return done; }));
+    CHECK(blocking_ptr->calls.load() == 1);
+}
+
+TEST_CASE("FixEngine async apply and revert honour dependencies") {
+    UiQueue ui;
+    WorkerPool pool(4);
+    FixExecutor executor(pool, [&ui](std::function<void()> task) { ui.post(std::move(task)); });
+    OrderLog log;
+    FixEngine engine;
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Gamma", std::vector<std::string>{"SDR"}, log)));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Profile", std::vector<std::string>{"Gamma", "Pixel"}, log)));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("SDR", std::vector<std::string>{}, log)));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Pixel", std::vector<std::string>{}, log)));
+
+    bool done = false;
+    engine.apply_all_async(executor, [&] { done = true; });
+    REQUIRE(ui.pump_until([&] { return done; }));
+    REQUIRE(log.applied.size() == 4);
+    CHECK(position(log.applied, "SDR") < position(log.applied, "Gamma"));
+    CHECK(position(log.applied, "Gamma") < position(log.applied, "Profile"));
+    CHECK(position(log.applied, "Pixel") < position(log.applied, "Profile"));
+
+    log.applied.clear();
+    done = false;
+    engine.revert_all_async(executor, [&] { done = true; });
+    REQUIRE(ui.pump_until([&] { return done; }));
+    REQUIRE(log.applied.size() == 4);
+    CHECK(position(log.applied, "-Profile") < position(log.applied, "-Gamma"));
+    CHECK(position(log.applied, "-Profile") < position(log.applied, "-Pixel"));
+    CHECK(position(log.applied, "-Gamma") < position(log.applied, "-SDR"));
+}
+
+TEST_CASE("FixEngine async apply can be limited to some owners") {
+    UiQueue ui;
+    WorkerPool pool(4);
+    FixExecutor executor(pool, [&ui](std::function<void()> task) { ui.post(std::move(task)); });
+    OrderLog log;
+    FixEngine engine;
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Share", std::vector<std::string>{}, log)));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Gamma", std::vector<std::string>{"SDR"}, log), 1));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("SDR", std::vector<std::string>{}, log), 1));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("Gamma", std::vector<std::string>{"SDR"}, log), 2));
+    CHECK(engine.register_fix(std::make_unique<DepFix>("SDR", std::vector<std::string>{}, log), 2));
+
+    bool done = false;
+    engine.apply_async(executor, {2}, [&] { done = true; });
+    REQUIRE(ui.pump_until([&] { return done; }));
+    CHECK(log.applied == std::vector<std::string>{"SDR", "Gamma"});
+    CHECK(static_cast<DepFix*>(engine.get_fix(fix_id("Gamma"), 2))->applied);
+    CHECK(!static_cast<DepFix*>(engine.get_fix(fix_id("Gamma"), 1))->applied);
+    CHECK(!static_cast<DepFix*>(engine.get_fix(fix_id("Share")))->applied);
+
+    // Skipped fixes were never claimed, so a full run still reaches them
+    done = false;
+    engine.apply_all_async(executor, [&] { done = true; });
+    REQUIRE(ui.pump_until([&] { return done; }));
+    CHECK(log.applied.size() == 5);
+}
+
+TEST_CASE("FixEngine toggles one fix asynchronously") {
+    UiQueue ui;
+    WorkerPool pool(1);
+    FixExecutor executor(pool, [&ui](std::function<void()> task) { ui.post(std::move(task)); });
+    FixEngine engine;
+    auto fix = std::make_unique<MockFix>();
+    auto* ptr = fix.get();
+    CHECK(engine.register_fix(std::move(fix)));
+    auto id = fix_id("MockFix");
+
+    std::optional<FixEngine::ToggleResult> toggled;
+    bool done = false;
+    auto record = [&](const std::optional<FixEngine::ToggleResult>& r) {
+        toggled = r;
+        done = true;
+    };
+    engine.toggle_async(executor, id, 0, record);
+    REQUIRE(ui.pump_until([&] { return done; }));
+    REQUIRE(toggled);
+    CHECK(toggled->op == PlanOp::Apply);
+    CHECK(toggled->result.success);
+    CHECK(ptr->applied);
+    CHECK(engine.dirty_count() == 1);
+
+    done = false;
+    engine.toggle_async(executor, id, 0, record);
+    REQUIRE(ui.pump_until([&] { return done; }));
+    REQUIRE(toggled);
+    CHECK(toggled->op == PlanOp::Revert);
+    CHECK(!ptr->applied);
+
+    // A second toggle while the first is in flight is refused
+    done = false;
+    bool refused = false;
+    engine.toggle_async(executor, id, 0, record);
+    engine.toggle_async(executor, id, 0, [&](const std::optional<FixEngine::ToggleResult>& r) {
+        refused = !r;
+    });
+    CHECK(refused);
+    REQUIRE(ui.pump_until([&] { return done; }));
+    CHECK(ptr->applied);
+
+    refused = false;
+    engine.toggle_async(executor, fix_id("Unknown"), 0, [&](const std::optional<FixEngine::ToggleResult>& r) {
+        refused = !r;
+    });
+    CHECK(refused);
+}
@@ -0,0 +1,146 @@
+#include "doctest.h"
+#include "core/fixes/fix_plan.h"
+#include "core/fixes/worker_pool.h"
+#include <atomic>
+
+using namespace hdrfixer::fixes;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Counts every call so tests can prove a plan touched nothing it did not list
+struct PlannedFix : public IFix {
+    PlannedFix(std::string n, FixState initial) : n(std::move(n)), state(initial) {}
+    std::string name() const override { return n; }
+    std::string description() const override { return "Plan test fix"; }
+    FixCategory category() const override { return FixCategory::SdrBrightness; }
+    FixStatus diagnose() override {
+        ++diagnoses;
+        return {state, n + " is " + (state == FixState::Applied ? "on" : "off")};
+    }
+    FixResult apply() override { ++applies; state = FixState::Applied; return {true, ""}; }
+    FixResult revert() override { ++reverts; state = FixState::NotApplied; return {true, ""}; }
+    std::vector<PlannedEffect> planned_effects(PlanOp op) const override {
+        if (op == PlanOp::Revert) return {{ObservedResource::file(L"C:\\color\\" + std::wstring(n.begin(), n.end()) + L".icm"), "delete"}};
+        return {
+            {ObservedResource::display_target(0x10, 4), "SDR white level 160 -> 240 nits"},
+            {ObservedResource::registry_key(L"HKCU", L"Software\\HDRFixer"), "set\tValue=1"},
+        };
+    }
+
+    std::string n;
+    FixState state;
+    std::atomic<int> diagnoses{0};
+    int applies = 0;
+    int reverts = 0;
+};
+
+} // namespace
+
+TEST_CASE("FixEngine plan lists only the fixes a real run would touch") {
+    FixEngine engine;
+    auto off = std::make_unique<PlannedFix>("Off", FixState::NotApplied);
+    auto on = std::make_unique<PlannedFix>("On", FixState::Applied);
+    auto broken = std::make_unique<PlannedFix>("Broken", FixState::Error);
+    auto fine = std::make_unique<PlannedFix>("Fine", FixState::NotNeeded);
+    auto* off_ptr = off.get();
+    auto* on_ptr = on.get();
+    engine.register_fix(std::move(off), 0x22);
+    engine.register_fix(std::move(on));
+    engine.register_fix(std::move(broken));
+    engine.register_fix(std::move(fine));
+
+    WorkerPool pool(2);
+    auto plan = engine.plan(pool, 5s);
+    REQUIRE(plan.actions.size() == 2);
+    CHECK(plan.goal == PlanOp::Apply);
+    CHECK(plan.actions[0].name == "Off");
+    CHECK(plan.actions[0].owner == 0x22);
+    CHECK(plan.actions[0].status.state == FixState::NotApplied);
+    CHECK(plan.actions[0].effects.size() == 2);
+    CHECK(plan.actions[1].name == "Broken");
+    CHECK(plan.undiagnosed.empty());
+    CHECK(off_ptr->applies == 0);
+
+    // A second plan reuses the cached statuses
+    auto again = engine.plan(pool, 5s);
+    CHECK(again.actions.size() == 2);
+    CHECK(off_ptr->diagnoses == 1);
+
+    auto revert = engine.plan(pool, 5s, PlanOp::Revert);
+    REQUIRE(revert.actions.size() == 1);
+    CHECK(revert.actions[0].name == "On");
+    CHECK(revert.actions[0].op == PlanOp::Revert);
+
+    // Executing the apply plan calls apply() on the listed fixes only, without re-diagnosing
+    FixPlan partial = plan;
+    partial.actions.pop_back();
+    auto results = engine.execute(partial);
+    REQUIRE(results.size() == 1);
+    CHECK(results[0].success);
+    CHECK(off_ptr->applies == 1);
+    CHECK(off_ptr->diagnoses == 1);
+    CHECK(on_ptr->applies == 0);
+    CHECK(on_ptr->reverts == 0);
+    CHECK(engine.dirty_count() == 1);
+}
+
+TEST_CASE("FixEngine execute fails actions whose fix is gone") {
+    FixEngine engine;
+    engine.register_fix(std::make_unique<PlannedFix>("Display", FixState::NotApplied), 7);
+    WorkerPool pool(1);
+    auto plan = engine.plan(pool, 5s);
+    REQUIRE(plan.actions.size() == 1);
+
+    engine.remove_fixes(7);
+    auto results = engine.execute(plan);
+    REQUIRE(results.size() == 1);
+    CHECK(!results[0].success);
+    CHECK(results[0].message == "Display is no longer registered");
+}
+
+TEST_CASE("Fix plans round-trip through their text form") {
+    FixEngine engine;
+    engine.register_fix(std::make_unique<PlannedFix>("Tab\tand\\slash", FixState::NotApplied), 0xABCDEF);
+    engine.register_fix(std::make_unique<PlannedFix>("Second", FixState::Error));
+    WorkerPool pool(1);
+    auto plan = engine.plan(pool, 5s);
+    plan.undiagnosed.push_back({"Slow", fix_id("Slow"), 3, std::nullopt});
+
+    auto text = serialize_plan(plan);
+    CHECK(text.rfind("hdrfixer-plan\t1\tapply\naction\tapply\t", 0) == 0);
+    CHECK(text.find("\tabcdef\tnot_applied\tTab\\tand\\\\slash\tTab\\tand\\\\slash is off\n") != std::string::npos);
+    CHECK(text.find("effect\tregistry_key\tHKCU\\\\Software\\\\HDRFixer\tset\\tValue=1\n") != std::string::npos);
+
+    auto parsed = parse_plan(text);
+    REQUIRE(parsed.has_value());
+    CHECK(parsed->goal == PlanOp::Apply);
+    REQUIRE(parsed->actions.size() == 2);
+    CHECK(parsed->actions[0].name == "Tab\tand\\slash");
+    CHECK(parsed->actions[0].fix == plan.actions[0].fix);
+    CHECK(parsed->actions[0].owner == 0xABCDEF);
+    CHECK(parsed->actions[0].status.message == plan.actions[0].status.message);
+    CHECK(parsed->actions[0].effects == plan.actions[0].effects);
+    CHECK(parsed->actions[1].status.state == FixState::Error);
+    REQUIRE(parsed->undiagnosed.size() == 1);
+    CHECK(parsed->undiagnosed[0].id == fix_id("Slow"));
+    CHECK(parsed->undiagnosed[0].owner == 3);
+    CHECK(serialize_plan(*parsed) == text);
+
+    // A parsed plan executes like the original
+    auto results = engine.execute(*parsed);
+    REQUIRE(results.size() == 2);
+    CHECK(results[0].success);
+}
+
+TEST_CASE("Fix plan parser rejects malformed input") {
+    CHECK(parse_plan("").error() == "Plan is empty");
+    CHECK(parse_plan("hdrfixer-plan\t2\tapply\n").error() == "Plan line 1: unsupported plan version 2");
+    CHECK(parse_plan("hdrfixer-plan\t1\tapply\neffect\tfile\tx\ty\n").error() ==
+          "Plan line 2: effect before any action");
+    CHECK(parse_plan("hdrfixer-plan\t1\tapply\naction\tapply\tzz\t0\terror\tA\t\n").error() ==
+          "Plan line 2: malformed action");
+    CHECK(parse_plan("hdrfixer-plan\t1\trevert\nundiagnosed\t1\t2\tbad\\q\n").error() ==
+          "Plan line 2: bad escape sequence");
+    CHECK(parse_plan("hdrfixer-plan\t1\trevert\r\n\r\n").value().goal == PlanOp::Revert);
+}
@@ -0,0 +1,132 @@
+#include "doctest.h"
+#include "core/fixes/fix_stats.h"
+#include "core/fixes/fix_engine.h"
+#include <thread>
+#include <vector>
+
+using namespace hdrfixer::fixes;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct ToggleFix : public IFix {
+    explicit ToggleFix(std::string n, bool broken = false) : n(std::move(n)), broken(broken) {}
+    std::string name() const override { return n; }
+    std::string description() const override { return "Stats test fix"; }
+    FixCategory category() const override { return FixCategory::ToneCurve; }
+    FixStatus diagnose() override {
+        if (broken) return {FixState::Error, "broken"};
+        return {applied ? FixState::Applied : FixState::NotApplied, ""};
+    }
+    FixResult apply() override {
+        if (broken) return {false, "broken"};
+        applied = true;
+        return {true, ""};
+    }
+    FixResult revert() override { applied = false; return {true, ""}; }
+
+    std::string n;
+    bool broken;
+    bool applied = false;
+};
+
+const OpStatsSnapshot& op(const FixStatsSnapshot& s, FixOp o) {
+    return s.ops[static_cast<size_t>(o)];
+}
+
+} // namespace
+
+TEST_CASE("Latency histogram buckets are powers of two in microseconds") {
+    CHECK(LatencyHistogram::bucket_for(0ns) == 0);
+    CHECK(LatencyHistogram::bucket_for(999ns) == 0);
+    CHECK(LatencyHistogram::bucket_for(1us) == 1);
+    CHECK(LatencyHistogram::bucket_for(3us) == 2);
+    CHECK(LatencyHistogram::bucket_for(4us) == 3);
+    CHECK(LatencyHistogram::bucket_for(1ms) == 10);
+    CHECK(LatencyHistogram::bucket_for(1h) == HistogramSnapshot::kBuckets - 1);
+
+    LatencyHistogram h;
+    for (int i = 0; i < 98; ++i) h.record(100us);
+    h.record(5ms);
+    h.record(20ms);
+    auto s = h.snapshot();
+    CHECK(s.count == 100);
+    CHECK(s.max_ns == 20'000'000);
+    CHECK(s.percentile_us(0.5) == 128);
+    CHECK(s.percentile_us(0.99) == 8192);
+    CHECK(s.percentile_us(1.0) == 32768);
+    CHECK(s.mean_us() == doctest::Approx(348.0));
+    CHECK(HistogramSnapshot{}.percentile_us(0.5) == 0);
+}
+
+TEST_CASE("Latency histogram records concurrently without losing samples") {
+    LatencyHistogram h;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&h, t] {
+            for (int i = 0; i < 10000; ++i) h.record(std::chrono::microseconds(t * 1000 + i % 7));
+        });
+    }
+    for (auto& t : threads) t.join();
+    auto s = h.snapshot();
+    CHECK(s.count == 40000);
+    uint64_t sum = 0;
+    for (auto b : s.buckets) sum += b;
+    CHECK(sum == 40000);
+    CHECK(s.max_ns == 3006'000);
+}
+
+TEST_CASE("FixEngine records per-fix outcomes and latencies") {
+    FixEngine engine;
+    engine.register_fix(std::make_unique<ToggleFix>("Good"));
+    engine.register_fix(std::make_unique<ToggleFix>("Bad", true), 0x1f2e);
+
+    engine.apply_all();
+    engine.apply_all();   // Good is applied now: diagnosed again, apply skipped
+    engine.revert_all();
+
+    auto stats = engine.stats();
+    REQUIRE(stats.size() == 2);
+    const auto& bad = stats[0];
+    const auto& good = stats[1];
+    CHECK(bad.name == "Bad");
+    CHECK(bad.owner == 0x1f2e);
+    CHECK(good.name == "Good");
+
+    // revert_all reuses the status cached by the second pass
+    CHECK(op(good, FixOp::Diagnose).latency.count == 2);
+    CHECK(op(good, FixOp::Diagnose).success == 2);
+    CHECK(op(good, FixOp::Apply).success == 1);
+    CHECK(op(good, FixOp::Apply).not_needed == 1);
+    CHECK(op(good, FixOp::Apply).latency.count == 1);
+    CHECK(op(good, FixOp::Revert).success == 1);
+
+    CHECK(op(bad, FixOp::Diagnose).failure == 3);
+    CHECK(op(bad, FixOp::Apply).failure == 2);
+    CHECK(op(bad, FixOp::Revert).not_needed == 1);
+    CHECK(op(bad, FixOp::Revert).latency.count == 0);
+}
+
+TEST_CASE("FixEngine stats outlive removal and resume on re-registration") {
+    FixEngine engine;
+    engine.register_fix(std::make_unique<ToggleFix>("Display"), 7);
+    engine.diagnose_all();
+    engine.remove_fixes(7);
+
+    auto stats = engine.stats();
+    REQUIRE(stats.size() == 1);
+    CHECK(!stats[0].registered);
+    CHECK(op(stats[0], FixOp::Diagnose).latency.count == 1);
+
+    auto lines = format_stats(stats);
+    REQUIRE(lines.size() == 1);
+    CHECK(lines[0].rfind("Display [owner 7] diagnose: n=1 ok=1 fail=0 skip=0 mean=", 0) == 0);
+    CHECK(lines[0].find(" (removed)") != std::string::npos);
+
+    engine.register_fix(std::make_unique<ToggleFix>("Display"), 7);
+    engine.diagnose_all();
+    stats = engine.stats();
+    REQUIRE(stats.size() == 1);
+    CHECK(stats[0].registered);
+    CHECK(op(stats[0], FixOp::Diagnose).latency.count == 2);
+}
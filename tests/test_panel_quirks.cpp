@@ -0,0 +1,141 @@
+#include "doctest.h"
+#include "core/display/panel_quirks.h"
+#include "core/display/edid_reader.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace hdrfixer::display;
+
+TEST_CASE("Panel quirks compile and lookup") {
+    auto compiled = compile_quirks(
+        "# comment line\n"
+        "DEL 0x4321 max_luminance=1000 full_frame_luminance=250  # trailing comment\n"
+        "\n"
+        "SAM 17000 min_luminance=0.0005 red=0.680,0.320 green=0.265,0.690 blue=0.150,0.060\n");
+    REQUIRE(compiled.has_value());
+    CHECK(compiled->size() == kQuirksHeaderSize + 2 * kQuirksRecordSize);
+
+    auto db = QuirksDatabase::from_bytes(*compiled);
+    REQUIRE(db.has_value());
+    CHECK(db->size() == 2);
+
+    auto dell = db->lookup(encode_manufacturer_id("DEL"), 0x4321);
+    REQUIRE(dell.has_value());
+    CHECK(dell->flags == (kQuirkMaxLuminance | kQuirkFullFrameLuminance));
+    CHECK(dell->max_luminance == doctest::Approx(1000.0f));
+    CHECK(dell->max_full_frame_luminance == doctest::Approx(250.0f));
+
+    auto sam = db->lookup(encode_manufacturer_id("SAM"), 17000);
+    REQUIRE(sam.has_value());
+    CHECK((sam->flags & kQuirkPrimaries) == kQuirkPrimaries);
+    CHECK((sam->flags & kQuirkMaxLuminance) == 0);
+    CHECK(sam->min_luminance == doctest::Approx(0.0005f));
+    CHECK(sam->red_primary[0] == doctest::Approx(0.680f));
+    CHECK(sam->blue_primary[1] == doctest::Approx(0.060f));
+
+    CHECK(!db->lookup(encode_manufacturer_id("DEL"), 0x4322).has_value());
+    CHECK(!db->lookup(encode_manufacturer_id("ACR"), 0x4321).has_value());
+}
+
+TEST_CASE("Panel quirks flag each primary separately") {
+    auto compiled = compile_quirks("DEL 0x4321 max_luminance=1000 red=0.680,0.320\n");
+    REQUIRE(compiled.has_value());
+    auto db = QuirksDatabase::from_bytes(*compiled);
+    REQUIRE(db.has_value());
+
+    auto dell = db->lookup(encode_manufacturer_id("DEL"), 0x4321);
+    REQUIRE(dell.has_value());
+    CHECK(dell->flags == (kQuirkMaxLuminance | kQuirkRedPrimary));
+    CHECK((dell->flags & kQuirkGreenPrimary) == 0);
+    CHECK((dell->flags & kQuirkBluePrimary) == 0);
+    CHECK(dell->red_primary[0] == doctest::Approx(0.680f));
+    CHECK(dell->red_primary[1] == doctest::Approx(0.320f));
+}
+
+TEST_CASE("Panel quirks compile errors report line numbers") {
+    auto bad_key = compile_quirks("DEL 0x10 max_luminance=1000\nDEL 0x11 bogus=1\n");
+    REQUIRE(!bad_key.has_value());
+    CHECK(bad_key.error().find("line 2") != std::string::npos);
+
+    CHECK(!compile_quirks("dell 0x10 max_luminance=1\n").has_value());
+    CHECK(!compile_quirks("DEL zz max_luminance=1\n").has_value());
+    CHECK(!compile_quirks("DEL 0x10 max_luminance=abc\n").has_value());
+    CHECK(!compile_quirks("DEL 0x10 red=0.5\n").has_value());
+    CHECK(!compile_quirks("DEL 0x10\n").has_value());
+
+    auto dup = compile_quirks("DEL 0x10 max_luminance=1\nDEL 16 min_luminance=0.1\n");
+    REQUIRE(!dup.has_value());
+    CHECK(dup.error().find("duplicate") != std::string::npos);
+}
+
+TEST_CASE("Panel quirks empty source yields empty database") {
+    auto compiled = compile_quirks("# nothing here\n");
+    REQUIRE(compiled.has_value());
+    auto db = QuirksDatabase::from_bytes(*compiled);
+    REQUIRE(db.has_value());
+    CHECK(db->empty());
+    CHECK(!db->lookup(0x10AC, 1).has_value());
+}
+
+TEST_CASE("Panel quirks rejects malformed binaries") {
+    auto compiled = compile_quirks("DEL 0x10 max_luminance=1\n");
+    REQUIRE(compiled.has_value());
+
+    auto bad_magic = *compiled;
+    bad_magic[0] ^= 0xFF;
+    CHECK(!QuirksDatabase::from_bytes(bad_magic).has_value());
+
+    auto truncated = *compiled;
+    truncated.resize(truncated.size() - 1);
+    CHECK(!QuirksDatabase::from_bytes(truncated).has_value());
+
+    CHECK(!QuirksDatabase::from_bytes(std::span<const uint8_t>()).has_value());
+}
+
+TEST_CASE("Panel quirks large database lookups") {
+    std::string source;
+    for (int mfg = 0; mfg < 20; ++mfg) {
+        std::string code = {'A', static_cast<char>('A' + mfg), 'Z'};
+        for (int product = 0; product < 1000; ++product) {
+            source += code + " " + std::to_string(product * 3) +
+                      " max_luminance=" + std::to_string(400 + product) + "\n";
+        }
+    }
+    auto compiled = compile_quirks(source);
+    REQUIRE(compiled.has_value());
+    auto db = QuirksDatabase::from_bytes(*compiled);
+    REQUIRE(db.has_value());
+    CHECK(db->size() == 20000);
+
+    auto hit = db->lookup(encode_manufacturer_id("AKZ"), 1500);
+    REQUIRE(hit.has_value());
+    CHECK(hit->max_luminance == doctest::Approx(900.0f));
+    CHECK(!db->lookup(encode_manufacturer_id("AKZ"), 1501).has_value());
+    CHECK(db->lookup(encode_manufacturer_id("AAZ"), 0).has_value());
+    CHECK(db->lookup(encode_manufacturer_id("ATZ"), 2997).has_value());
+}
+
+TEST_CASE("Panel quirks memory-mapped file") {
+    auto compiled = compile_quirks("DEL 0x4321 max_luminance=1000\n");
+    REQUIRE(compiled.has_value());
+
+    auto path = std::filesystem::temp_directory_path() / "hdrfixer_test_quirks.bin";
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(compiled->data()),
+                  static_cast<std::streamsize>(compiled->size()));
+    }
+
+    {
+        auto db = QuirksDatabase::open(path);
+        REQUIRE(db.has_value());
+        auto copy = *db; // copies share the mapping
+        auto hit = copy.lookup(encode_manufacturer_id("DEL"), 0x4321);
+        REQUIRE(hit.has_value());
+        CHECK(hit->max_luminance == doctest::Approx(1000.0f));
+    }
+
+    std::filesystem::remove(path);
+    CHECK(!QuirksDatabase::open(path).has_value());
+}
@@ -0,0 +1,147 @@
+#include "doctest.h"
+#include "core/fixes/reactor.h"
+#include <future>
+#include <thread>
+
+using namespace hdrfixer::fixes;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct VirtualReactor {
+    explicit VirtualReactor(ReactorConfig config = {}) {
+        auto owned = std::make_unique<PortableReactorBackend>(true);
+        backend = owned.get();
+        reactor = std::make_unique<Reactor>(std::move(owned), config);
+    }
+
+    std::chrono::milliseconds at() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(reactor->now().time_since_epoch());
+    }
+
+    PortableReactorBackend* backend;
+    std::unique_ptr<Reactor> reactor;
+};
+
+} // namespace
+
+TEST_CASE("Reactor dispatches by priority in bounded batches") {
+    VirtualReactor v({2, 100ms});
+    std::vector<int> order;
+    v.reactor->post([&] { order.push_back(3); }, ReactorPriority::Low);
+    v.reactor->post([&] { order.push_back(2); }, ReactorPriority::Normal);
+    v.reactor->post([&] { order.push_back(1); }, ReactorPriority::High);
+    v.reactor->post([&] { order.push_back(4); }, ReactorPriority::Low);
+    v.reactor->post([&] { order.push_back(5); }, ReactorPriority::Low);
+
+    CHECK(v.reactor->run_once() == 2);
+    CHECK(v.reactor->run_once() == 2);
+    CHECK(v.reactor->run_once() == 1);
+    CHECK(v.reactor->run_once() == 0);
+    CHECK(order == std::vector<int>{1, 2, 3, 4, 5});
+
+    auto stats = v.reactor->stats();
+    CHECK(stats.priorities[0].dispatched == 1);
+    CHECK(stats.priorities[2].dispatched == 3);
+    CHECK(stats.turns == 4);
+}
+
+TEST_CASE("Reactor promotes work that waited past max_delay") {
+    Reactor reactor(std::make_unique<PortableReactorBackend>(), {1, 20ms});
+    std::vector<char> order;
+    reactor.post([&] { order.push_back('L'); }, ReactorPriority::Low);
+    std::this_thread::sleep_for(50ms);
+    reactor.post([&] { order.push_back('H'); }, ReactorPriority::High);
+
+    reactor.run_once();
+    reactor.run_once();
+    CHECK(order == std::vector<char>{'L', 'H'});   // promoted, and queued first
+    CHECK(reactor.stats().priorities[2].promoted == 1);
+    CHECK(reactor.stats().priorities[2].max_latency >= 20ms);
+}
+
+TEST_CASE("Reactor runs one-shot and periodic timers on time") {
+    VirtualReactor v;
+    std::vector<std::chrono::milliseconds> ticks, once;
+    auto periodic = v.reactor->add_timer(100ms, [&] { ticks.push_back(v.at()); },
+                                         ReactorPriority::Normal, 100ms);
+    v.reactor->add_timer(250ms, [&] { once.push_back(v.at()); });
+    auto never = v.reactor->add_timer(300ms, [&] { once.push_back(v.at()); });
+    v.reactor->remove(never);
+
+    const auto until = v.reactor->now() + 450ms;
+    while (v.reactor->now() < until) v.reactor->run_once(until);
+    CHECK(ticks == std::vector<std::chrono::milliseconds>{100ms, 200ms, 300ms, 400ms});
+    CHECK(once == std::vector<std::chrono::milliseconds>{250ms});
+
+    v.reactor->remove(periodic);
+    size_t ran = 0;
+    while (v.reactor->now() < until + 1s) ran += v.reactor->run_once(until + 1s);
+    CHECK(ran == 0);
+    CHECK(v.at() == 1450ms);
+    CHECK(ticks.size() == 4);
+}
+
+TEST_CASE("Reactor coalesces repeated handle and user signals") {
+    VirtualReactor v;
+    int event = 0;
+    int handle_runs = 0, signal_runs = 0;
+    auto handle = v.reactor->add_handle(&event, [&] { ++handle_runs; });
+    REQUIRE(handle);
+    auto sig = v.reactor->add_signal([&] { ++signal_runs; });
+
+    v.backend->signal(&event);
+    v.backend->signal(&event);
+    for (int i = 0; i < 3; ++i) v.reactor->signal(sig);
+    CHECK(v.reactor->run_once() == 2);
+    CHECK(handle_runs == 1);
+    CHECK(signal_runs == 1);
+
+    // Removal drops a dispatch that is queued but has not run
+    v.reactor->signal(sig);
+    v.reactor->remove(sig);
+    v.reactor->remove(*handle);
+    v.backend->signal(&event);
+    CHECK(v.reactor->run_once() == 0);
+    CHECK(signal_runs == 1);
+    CHECK(handle_runs == 1);
+}
+
+TEST_CASE("Reactor rejects handles it cannot wait on") {
+    VirtualReactor v;
+    auto null = v.reactor->add_handle(nullptr, [] {});
+    REQUIRE(!null);
+    CHECK(null.error() == "Reactor: null handle");
+
+    std::vector<char> events(v.backend->max_handles() + 1);
+    for (size_t i = 0; i + 1 < events.size(); ++i) {
+        REQUIRE(v.reactor->add_handle(&events[i], [] {}));
+    }
+    auto full = v.reactor->add_handle(&events.back(), [] {});
+    REQUIRE(!full);
+    CHECK(full.error() == "Reactor: at most 1024 handles can be watched");
+}
+
+TEST_CASE("Reactor thread runs posted, called and timed work") {
+    Reactor reactor(std::make_unique<PortableReactorBackend>());
+    reactor.start();
+    CHECK(reactor.running());
+    CHECK(!reactor.on_reactor_thread());
+
+    bool on_thread = false;
+    reactor.call([&] { on_thread = reactor.on_reactor_thread(); });
+    CHECK(on_thread);
+
+    std::promise<void> timed, posted;
+    reactor.add_timer(10ms, [&] { timed.set_value(); });
+    std::thread other([&] { reactor.post([&] { posted.set_value(); }, ReactorPriority::Low); });
+    other.join();
+    CHECK(timed.get_future().wait_for(5s) == std::future_status::ready);
+    CHECK(posted.get_future().wait_for(5s) == std::future_status::ready);
+
+    reactor.stop();
+    CHECK(!reactor.running());
+    bool inline_run = false;
+    reactor.call([&] { inline_run = !reactor.on_reactor_thread(); });
+    CHECK(inline_run);
+}
@@ -0,0 +1,120 @@
+#include "doctest.h"
+#include "core/fixes/registry_snapshot.h"
+
+using namespace hdrfixer::fixes;
+
+namespace {
+
+// In-memory subtree; every write bumps the key's stamp like the real
+// registry, whether or not the data changed
+class FakeTree : public IRegistryTree {
+public:
+    struct Key {
+        uint64_t last_write = 1;
+        std::map<std::wstring, RegistryValue> values;
+    };
+
+    void set(const std::wstring& key, const std::wstring& name, uint32_t type, std::vector<uint8_t> data) {
+        auto& k = keys[key];
+        k.values[name] = {name, type, std::move(data)};
+        k.last_write = ++clock;
+    }
+    void add_key(const std::wstring& key) { keys[key].last_write = ++clock; }
+
+    std::optional<KeyInfo> query(const std::wstring& path) override {
+        auto it = keys.find(path);
+        if (it == keys.end()) return std::nullopt;
+        KeyInfo info{it->second.last_write, {}};
+        std::wstring prefix = path.empty() ? L"" : path + L"\\";
+        for (const auto& [other, key] : keys) {
+            if (other.size() > prefix.size() && other.starts_with(prefix) &&
+                other.find(L'\\', prefix.size()) == std::wstring::npos) {
+                info.subkeys.push_back(other.substr(prefix.size()));
+            }
+        }
+        return info;
+    }
+    std::vector<RegistryValue> values(const std::wstring& path) override {
+        ++reads;
+        std::vector<RegistryValue> out;
+        for (const auto& [name, v] : keys.at(path).values) out.push_back(v);
+        return out;
+    }
+
+    std::map<std::wstring, Key> keys{{L"", {}}};
+    uint64_t clock = 1;
+    int reads = 0;
+};
+
+constexpr uint32_t kDword = 4;
+constexpr uint32_t kBinary = 3;
+
+} // namespace
+
+TEST_CASE("RegistrySnapshot filters rewrites with identical data") {
+    FakeTree tree;
+    tree.set(L"", L"HwSchMode", kDword, {2, 0, 0, 0});
+    tree.set(L"Configuration\\MON1", L"Scaling", kDword, {1, 0, 0, 0});
+    tree.add_key(L"Configuration");
+    tree.set(L"MonitorDataStore\\MON1", L"AdvancedColorEnabled", kDword, {1, 0, 0, 0});
+    tree.add_key(L"MonitorDataStore");
+
+    RegistrySnapshot snap;
+    REQUIRE(snap.capture(tree));
+    CHECK(snap.key_count() == 5);
+
+    // A control panel rewriting the same data is not a change...
+    tree.set(L"Configuration\\MON1", L"Scaling", kDword, {1, 0, 0, 0});
+    tree.reads = 0;
+    CHECK(snap.refresh(tree).empty());
+    CHECK(tree.reads == 1);   // only the key whose stamp moved is read
+    CHECK(snap.stats().noop_refreshes == 1);
+
+    // ...but the same bytes under a different type are
+    tree.set(L"Configuration\\MON1", L"Scaling", kBinary, {1, 0, 0, 0});
+    auto diff = snap.refresh(tree);
+    REQUIRE(diff.values.size() == 1);
+    CHECK(diff.values[0] == RegistryValueDiff{L"Configuration\\MON1", L"Scaling", ValueChange::Modified});
+    CHECK(snap.stats().refreshes == 2);
+    CHECK(snap.stats().noop_refreshes == 1);
+}
+
+TEST_CASE("RegistrySnapshot reports added and removed keys and values") {
+    FakeTree tree;
+    tree.set(L"A", L"x", kDword, {1});
+    tree.set(L"A", L"y", kDword, {2});
+    tree.add_key(L"B");
+
+    RegistrySnapshot snap;
+    REQUIRE(snap.capture(tree));
+
+    tree.keys[L"A"].values.erase(L"y");
+    tree.set(L"A", L"z", kDword, {3});
+    tree.keys.erase(L"B");
+    tree.set(L"C\\D", L"w", kDword, {4});
+    tree.add_key(L"C");
+
+    auto diff = snap.refresh(tree);
+    CHECK(diff.added_keys == std::vector<std::wstring>{L"C", L"C\\D"});
+    CHECK(diff.removed_keys == std::vector<std::wstring>{L"B"});
+    REQUIRE(diff.values.size() == 2);
+    CHECK(diff.values[0] == RegistryValueDiff{L"A", L"z", ValueChange::Added});
+    CHECK(diff.values[1] == RegistryValueDiff{L"A", L"y", ValueChange::Removed});
+    CHECK(diff.changed_keys() == std::vector<std::wstring>{L"A", L"B", L"C", L"C\\D"});
+
+    // The refresh became the new baseline
+    CHECK(snap.refresh(tree).empty());
+}
+
+TEST_CASE("RegistrySnapshot needs the root key") {
+    FakeTree tree;
+    tree.keys.clear();
+    RegistrySnapshot snap;
+    CHECK(!snap.capture(tree));
+    CHECK(!snap.captured());
+
+    tree.set(L"", L"v", kDword, {1});
+    auto diff = snap.refresh(tree);
+    CHECK(diff.added_keys == std::vector<std::wstring>{L""});
+    CHECK(snap.captured());
+}
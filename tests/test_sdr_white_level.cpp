@@ -14,3 +14,15 @@ TEST_CASE("SDR white level nits to raw") {
     CHECK(nits_to_raw(200.0f) == 2500);
     CHECK(nits_to_raw(400.0f) == 5000);
 }
+
+TEST_CASE("Monitor device path maps to EDID registry key") {
+    auto key = monitor_edid_registry_path(
+        L"\\\\?\\DISPLAY#DEL40F5#5&2f7c1a1&0&UID4353#{e6f07b5f-ee97-4a90-b076-33f57bf4eaa7}");
+    CHECK(key == L"SYSTEM\\CurrentControlSet\\Enum\\DISPLAY\\DEL40F5\\5&2f7c1a1&0&UID4353\\Device Parameters");
+    CHECK(monitor_edid_registry_path(L"").empty());
+}
+
+TEST_CASE("read_edid fails without registry data") {
+    auto edid = read_edid(L"\\\\?\\DISPLAY#DEL40F5#1&0&UID1#{e6f07b5f-ee97-4a90-b076-33f57bf4eaa7}");
+    CHECK(!edid.has_value());
+}
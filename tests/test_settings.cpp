@@ -43,6 +43,8 @@ TEST_CASE("AppSettings defaults") {
     CHECK(s.run_at_startup == false);
     CHECK(s.minimize_to_tray == true);
     CHECK(s.enable_fix_watchdog == true);
+    CHECK(s.watchdog_coalesce_ms == 250);
+    CHECK(s.watchdog_max_latency_ms == 2000);
     CHECK(s.preferred_sdr_brightness_nits == doctest::Approx(200.0f));
     CHECK(s.oled_pixel_shift_enabled == false);
     CHECK(s.oled_static_content_timeout_minutes == 5);
@@ -56,6 +58,7 @@ TEST_CASE("SettingsManager serialize round-trip") {
     mgr.get_mut().preferred_sdr_brightness_nits = 250.0f;
     mgr.get_mut().oled_pixel_shift_enabled = true;
     mgr.get_mut().oled_static_content_timeout_minutes = 10;
+    mgr.get_mut().watchdog_coalesce_ms = 500;
     mgr.get_mut().enabled_fixes["gamma_correction"] = true;
     mgr.get_mut().enabled_fixes["sdr_brightness"] = false;
 
@@ -69,6 +72,8 @@ TEST_CASE("SettingsManager serialize round-trip") {
     CHECK(mgr2.get().preferred_sdr_brightness_nits == doctest::Approx(250.0f));
     CHECK(mgr2.get().oled_pixel_shift_enabled == true);
     CHECK(mgr2.get().oled_static_content_timeout_minutes == 10);
+    CHECK(mgr2.get().watchdog_coalesce_ms == 500);
+    CHECK(mgr2.get().watchdog_max_latency_ms == 2000);
     CHECK(mgr2.get().enabled_fixes.at("gamma_correction") == true);
     CHECK(mgr2.get().enabled_fixes.at("sdr_brightness") == false);
 }
@@ -166,6 +171,24 @@ TEST_CASE("SettingsManager deserialization edge cases") {
         CHECK(mgr.get().oled_static_content_timeout_minutes == 5); // Default
     }
 
+    SUBCASE("Watchdog Timings Are Clamped") {
+        mgr.deserialize("watchdog_coalesce_ms=0\nwatchdog_max_latency_ms=-5");
+        CHECK(mgr.get().watchdog_coalesce_ms == kMinWatchdogCoalesceMs);
+        CHECK(mgr.get().watchdog_max_latency_ms == kMinWatchdogCoalesceMs);
+
+        mgr.deserialize("watchdog_coalesce_ms=800\nwatchdog_max_latency_ms=300");
+        CHECK(mgr.get().watchdog_coalesce_ms == 800);
+        CHECK(mgr.get().watchdog_max_latency_ms == 800); // Raised to the window
+
+        mgr.deserialize("watchdog_coalesce_ms=99999999\nwatchdog_max_latency_ms=99999999");
+        CHECK(mgr.get().watchdog_coalesce_ms == kMaxWatchdogCoalesceMs);
+        CHECK(mgr.get().watchdog_max_latency_ms == kMaxWatchdogLatencyMs);
+
+        mgr.deserialize("watchdog_coalesce_ms=300\nwatchdog_max_latency_ms=1500");
+        CHECK(mgr.get().watchdog_coalesce_ms == 300);
+        CHECK(mgr.get().watchdog_max_latency_ms == 1500);
+    }
+
     SUBCASE("Fix Configuration") {
         std::string input = "fix.my_cool_fix=true\nfix.another_fix=false";
         mgr.deserialize(input);
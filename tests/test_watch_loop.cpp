@@ -0,0 +1,160 @@
+#include "doctest.h"
+#include "core/fixes/event_source.h"
+#include "core/fixes/watch_loop.h"
+#include <algorithm>
+
+using namespace hdrfixer::fixes;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Fire {
+    WatchdogTrigger trigger;
+    size_t key;
+    std::chrono::milliseconds at;
+};
+
+// Drives a WatchLoop the way the watchdog does, on a virtual-clock
+// reactor: one reactor handle per key, signaled at each traced event
+struct Replay {
+    Replay(WatchLoop& loop, std::function<void(WatchdogTrigger)> on_fire = {})
+        : loop(loop), events(loop.key_count()) {
+        auto owned = std::make_unique<PortableReactorBackend>(true);
+        backend = owned.get();
+        reactor = std::make_unique<Reactor>(std::move(owned));
+        for (size_t k = 0; k < events.size(); ++k) {
+            REQUIRE(reactor->add_handle(&events[k], [this, k] { this->loop.notify(k); }));
+        }
+        loop.attach(*reactor, [this, on_fire](WatchdogTrigger trigger, size_t key) {
+            fires.push_back({trigger, key, at()});
+            if (on_fire) on_fire(trigger);
+        });
+    }
+    ~Replay() { loop.detach(); }
+
+    std::chrono::milliseconds at() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(reactor->now().time_since_epoch());
+    }
+
+    // Run until `until`, dispatching whatever is due at exactly that time
+    void advance(std::chrono::milliseconds until) {
+        auto t = Reactor::Clock::time_point{} + until;
+        while (reactor->now() < t) reactor->run_once(t);
+        while (reactor->run_once(t) > 0) {}
+    }
+
+    std::vector<Fire>& run(const std::vector<TraceEvent>& trace, std::chrono::milliseconds until) {
+        for (const auto& e : trace) {
+            advance(std::chrono::duration_cast<std::chrono::milliseconds>(e.at));
+            backend->signal(&events[e.key]);
+        }
+        advance(until);
+        return fires;
+    }
+
+    WatchLoop& loop;
+    std::vector<char> events;
+    PortableReactorBackend* backend;
+    std::unique_ptr<Reactor> reactor;
+    std::vector<Fire> fires;
+};
+
+std::vector<TraceEvent> storm(size_t key, std::chrono::milliseconds start, int count,
+                              std::chrono::milliseconds spacing) {
+    std::vector<TraceEvent> trace;
+    for (int i = 0; i < count; ++i) trace.push_back({start + i * spacing, key});
+    return trace;
+}
+
+} // namespace
+
+TEST_CASE("WatchLoop coalesces a replayed storm per key") {
+    auto trace = storm(0, 1s, 20, 10ms);
+    auto other = storm(1, 1050ms, 3, 100ms);
+    trace.insert(trace.end(), other.begin(), other.end());
+    std::stable_sort(trace.begin(), trace.end(),
+                     [](const TraceEvent& a, const TraceEvent& b) { return a.at < b.at; });
+
+    WatchLoop loop(2, {250ms, 2000ms, true, true}, {1h, 1h, 2});
+    Replay replay(loop);
+    auto& fires = replay.run(trace, 10s);
+
+    REQUIRE(fires.size() == 4);
+    CHECK(fires[0].key == 0);
+    CHECK(fires[0].at == 1000ms);    // leading edge
+    CHECK(fires[1].key == 1);
+    CHECK(fires[1].at == 1050ms);    // key 0's storm does not mask key 1
+    CHECK(fires[2].key == 0);
+    CHECK(fires[2].at == 1190ms + 250ms);
+    CHECK(fires[3].key == 1);
+    CHECK(fires[3].at == 1250ms + 250ms);
+    for (const auto& f : fires) CHECK(f.trigger == WatchdogTrigger::RegistryChange);
+
+    CHECK(loop.debounce_stats().events == 23);
+    CHECK(loop.debounce_stats().fired == 4);
+    CHECK(loop.debounce_stats(1).suppressed == 1);
+}
+
+TEST_CASE("WatchLoop backs off its fallback poll on a virtual clock") {
+    WatchLoop loop(1, {}, {1min, 4min, 2});
+    size_t checks = 0;
+    Replay replay(loop, [&](WatchdogTrigger trigger) {
+        CHECK(trigger == WatchdogTrigger::Timeout);
+        // Drift on the third check snaps the interval back
+        loop.report_check(++checks == 3);
+    });
+    std::vector<std::chrono::milliseconds> polls;
+    for (const auto& f : replay.run({}, 20min)) polls.push_back(f.at);
+    // 1, +2, +4 (drift), +1, +2, +4, +4
+    std::vector<std::chrono::milliseconds> expected{1min, 3min, 7min, 8min, 10min, 14min, 18min};
+    CHECK(polls == expected);
+}
+
+TEST_CASE("WatchLoop stays silent while paused and re-checks on resume") {
+    WatchLoop loop(1, {}, {1min, 1min, 2});
+    CHECK(loop.set_paused(true));
+    CHECK(!loop.set_paused(true));
+    Replay replay(loop);
+    auto& fires = replay.run({{30min, 0}}, 1h);
+    // Registry changes still arrive; no fallback polls
+    REQUIRE(fires.size() == 1);
+    CHECK(fires[0].trigger == WatchdogTrigger::RegistryChange);
+
+    // Resuming wakes the reactor for an immediate check
+    fires.clear();
+    CHECK(loop.set_paused(false));
+    replay.advance(1h + 90s);
+    REQUIRE(fires.size() == 2);
+    CHECK(fires[0].trigger == WatchdogTrigger::Timeout);
+    CHECK(fires[0].at == 1h);
+    CHECK(fires[1].at == 1h + 1min);
+}
+
+TEST_CASE("WatchLoop stops firing once detached") {
+    WatchLoop loop(1, {}, {1min, 1min, 2});
+    Replay replay(loop);
+    replay.advance(90s);
+    CHECK(replay.fires.size() == 1);
+    loop.detach();
+    loop.report_check(true);
+    replay.advance(1h);
+    CHECK(replay.fires.size() == 1);
+}
+
+TEST_CASE("Event traces round-trip through text") {
+    std::vector<TraceEvent> trace{{0us, 0}, {1500us, 3}, {1500us, 1}, {90s, 0}};
+    auto text = serialize_event_trace(trace);
+    CHECK(text.starts_with("hdrfixer-trace\t1\n"));
+    auto parsed = parse_event_trace(text);
+    REQUIRE(parsed.has_value());
+    CHECK(*parsed == trace);
+
+    CHECK(parse_event_trace("hdrfixer-trace\t1\r\n\r\nevent\t5\t2\r\n")->size() == 1);
+    CHECK(parse_event_trace("").error() == "Trace is empty");
+    CHECK(parse_event_trace("hdrfixer-trace\t2\n").error() == "Trace line 1: unsupported trace version 2");
+    CHECK(parse_event_trace("hdrfixer-trace\t1\nevent\t5\n").error() == "Trace line 2: event needs 2 fields");
+    CHECK(parse_event_trace("hdrfixer-trace\t1\nevent\t-5\t0\n").error() == "Trace line 2: malformed event");
+    CHECK(parse_event_trace("hdrfixer-trace\t1\nevent\t9\t0\nevent\t5\t0\n").error() ==
+          "Trace line 3: events out of order");
+    CHECK(parse_event_trace("hdrfixer-trace\t1\nfoo\n").error() == "Trace line 2: unknown record 'foo'");
+}